@@ -0,0 +1,25 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/bench/libobs-standin/callback.c" "CMakeFiles/obs-standin.dir/libobs-standin/callback.c.o" "gcc" "CMakeFiles/obs-standin.dir/libobs-standin/callback.c.o.d"
+  "/root/repo/bench/libobs-standin/obs-core.c" "CMakeFiles/obs-standin.dir/libobs-standin/obs-core.c.o" "gcc" "CMakeFiles/obs-standin.dir/libobs-standin/obs-core.c.o.d"
+  "/root/repo/bench/libobs-standin/obs-data.c" "CMakeFiles/obs-standin.dir/libobs-standin/obs-data.c.o" "gcc" "CMakeFiles/obs-standin.dir/libobs-standin/obs-data.c.o.d"
+  "/root/repo/bench/libobs-standin/obs-properties.c" "CMakeFiles/obs-standin.dir/libobs-standin/obs-properties.c.o" "gcc" "CMakeFiles/obs-standin.dir/libobs-standin/obs-properties.c.o.d"
+  "/root/repo/bench/libobs-standin/obs-scene.c" "CMakeFiles/obs-standin.dir/libobs-standin/obs-scene.c.o" "gcc" "CMakeFiles/obs-standin.dir/libobs-standin/obs-scene.c.o.d"
+  "/root/repo/bench/libobs-standin/obs-source.c" "CMakeFiles/obs-standin.dir/libobs-standin/obs-source.c.o" "gcc" "CMakeFiles/obs-standin.dir/libobs-standin/obs-source.c.o.d"
+  "/root/repo/bench/libobs-standin/util.c" "CMakeFiles/obs-standin.dir/libobs-standin/util.c.o" "gcc" "CMakeFiles/obs-standin.dir/libobs-standin/util.c.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,23 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/obs-standin.dir/libobs-standin/callback.c.o"
+  "CMakeFiles/obs-standin.dir/libobs-standin/callback.c.o.d"
+  "CMakeFiles/obs-standin.dir/libobs-standin/obs-core.c.o"
+  "CMakeFiles/obs-standin.dir/libobs-standin/obs-core.c.o.d"
+  "CMakeFiles/obs-standin.dir/libobs-standin/obs-data.c.o"
+  "CMakeFiles/obs-standin.dir/libobs-standin/obs-data.c.o.d"
+  "CMakeFiles/obs-standin.dir/libobs-standin/obs-properties.c.o"
+  "CMakeFiles/obs-standin.dir/libobs-standin/obs-properties.c.o.d"
+  "CMakeFiles/obs-standin.dir/libobs-standin/obs-scene.c.o"
+  "CMakeFiles/obs-standin.dir/libobs-standin/obs-scene.c.o.d"
+  "CMakeFiles/obs-standin.dir/libobs-standin/obs-source.c.o"
+  "CMakeFiles/obs-standin.dir/libobs-standin/obs-source.c.o.d"
+  "CMakeFiles/obs-standin.dir/libobs-standin/util.c.o"
+  "CMakeFiles/obs-standin.dir/libobs-standin/util.c.o.d"
+  "libobs-standin.a"
+  "libobs-standin.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/obs-standin.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
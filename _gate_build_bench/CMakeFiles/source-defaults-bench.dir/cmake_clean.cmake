@@ -0,0 +1,17 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/source-defaults-bench.dir/bench-stats.c.o"
+  "CMakeFiles/source-defaults-bench.dir/bench-stats.c.o.d"
+  "CMakeFiles/source-defaults-bench.dir/scene-collection.c.o"
+  "CMakeFiles/source-defaults-bench.dir/scene-collection.c.o.d"
+  "CMakeFiles/source-defaults-bench.dir/source-defaults-bench.c.o"
+  "CMakeFiles/source-defaults-bench.dir/source-defaults-bench.c.o.d"
+  "CMakeFiles/source-defaults-bench.dir/source-types.c.o"
+  "CMakeFiles/source-defaults-bench.dir/source-types.c.o.d"
+  "source-defaults-bench"
+  "source-defaults-bench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/source-defaults-bench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
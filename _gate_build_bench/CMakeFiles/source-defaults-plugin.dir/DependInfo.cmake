@@ -0,0 +1,38 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/apply-queue.c" "CMakeFiles/source-defaults-plugin.dir/root/repo/src/apply-queue.c.o" "gcc" "CMakeFiles/source-defaults-plugin.dir/root/repo/src/apply-queue.c.o.d"
+  "/root/repo/src/defaults-library.c" "CMakeFiles/source-defaults-plugin.dir/root/repo/src/defaults-library.c.o" "gcc" "CMakeFiles/source-defaults-plugin.dir/root/repo/src/defaults-library.c.o.d"
+  "/root/repo/src/defaults-snapshot.c" "CMakeFiles/source-defaults-plugin.dir/root/repo/src/defaults-snapshot.c.o" "gcc" "CMakeFiles/source-defaults-plugin.dir/root/repo/src/defaults-snapshot.c.o.d"
+  "/root/repo/src/deferred-filters.c" "CMakeFiles/source-defaults-plugin.dir/root/repo/src/deferred-filters.c.o" "gcc" "CMakeFiles/source-defaults-plugin.dir/root/repo/src/deferred-filters.c.o.d"
+  "/root/repo/src/encountered-sources.c" "CMakeFiles/source-defaults-plugin.dir/root/repo/src/encountered-sources.c.o" "gcc" "CMakeFiles/source-defaults-plugin.dir/root/repo/src/encountered-sources.c.o.d"
+  "/root/repo/src/event-trace.c" "CMakeFiles/source-defaults-plugin.dir/root/repo/src/event-trace.c.o" "gcc" "CMakeFiles/source-defaults-plugin.dir/root/repo/src/event-trace.c.o.d"
+  "/root/repo/src/existing-sources.c" "CMakeFiles/source-defaults-plugin.dir/root/repo/src/existing-sources.c.o" "gcc" "CMakeFiles/source-defaults-plugin.dir/root/repo/src/existing-sources.c.o.d"
+  "/root/repo/src/filter-stats.c" "CMakeFiles/source-defaults-plugin.dir/root/repo/src/filter-stats.c.o" "gcc" "CMakeFiles/source-defaults-plugin.dir/root/repo/src/filter-stats.c.o.d"
+  "/root/repo/src/frozen-defaults.c" "CMakeFiles/source-defaults-plugin.dir/root/repo/src/frozen-defaults.c.o" "gcc" "CMakeFiles/source-defaults-plugin.dir/root/repo/src/frozen-defaults.c.o.d"
+  "/root/repo/src/hash-table.c" "CMakeFiles/source-defaults-plugin.dir/root/repo/src/hash-table.c.o" "gcc" "CMakeFiles/source-defaults-plugin.dir/root/repo/src/hash-table.c.o.d"
+  "/root/repo/src/latency-stats.c" "CMakeFiles/source-defaults-plugin.dir/root/repo/src/latency-stats.c.o" "gcc" "CMakeFiles/source-defaults-plugin.dir/root/repo/src/latency-stats.c.o.d"
+  "/root/repo/src/plugin-main.c" "CMakeFiles/source-defaults-plugin.dir/root/repo/src/plugin-main.c.o" "gcc" "CMakeFiles/source-defaults-plugin.dir/root/repo/src/plugin-main.c.o.d"
+  "/root/repo/src/plugin-settings.c" "CMakeFiles/source-defaults-plugin.dir/root/repo/src/plugin-settings.c.o" "gcc" "CMakeFiles/source-defaults-plugin.dir/root/repo/src/plugin-settings.c.o.d"
+  "/root/repo/src/profile-rules.c" "CMakeFiles/source-defaults-plugin.dir/root/repo/src/profile-rules.c.o" "gcc" "CMakeFiles/source-defaults-plugin.dir/root/repo/src/profile-rules.c.o.d"
+  "/root/repo/src/rcu-ptr.c" "CMakeFiles/source-defaults-plugin.dir/root/repo/src/rcu-ptr.c.o" "gcc" "CMakeFiles/source-defaults-plugin.dir/root/repo/src/rcu-ptr.c.o.d"
+  "/root/repo/src/scene-catalog.c" "CMakeFiles/source-defaults-plugin.dir/root/repo/src/scene-catalog.c.o" "gcc" "CMakeFiles/source-defaults-plugin.dir/root/repo/src/scene-catalog.c.o.d"
+  "/root/repo/src/scene-index.c" "CMakeFiles/source-defaults-plugin.dir/root/repo/src/scene-index.c.o" "gcc" "CMakeFiles/source-defaults-plugin.dir/root/repo/src/scene-index.c.o.d"
+  "/root/repo/src/source-defaults-filter.c" "CMakeFiles/source-defaults-plugin.dir/root/repo/src/source-defaults-filter.c.o" "gcc" "CMakeFiles/source-defaults-plugin.dir/root/repo/src/source-defaults-filter.c.o.d"
+  "/root/repo/src/transition-pool.c" "CMakeFiles/source-defaults-plugin.dir/root/repo/src/transition-pool.c.o" "gcc" "CMakeFiles/source-defaults-plugin.dir/root/repo/src/transition-pool.c.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_gate_build_bench/CMakeFiles/obs-standin.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
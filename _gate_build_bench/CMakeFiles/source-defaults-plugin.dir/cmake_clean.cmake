@@ -0,0 +1,47 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/source-defaults-plugin.dir/root/repo/src/apply-queue.c.o"
+  "CMakeFiles/source-defaults-plugin.dir/root/repo/src/apply-queue.c.o.d"
+  "CMakeFiles/source-defaults-plugin.dir/root/repo/src/defaults-library.c.o"
+  "CMakeFiles/source-defaults-plugin.dir/root/repo/src/defaults-library.c.o.d"
+  "CMakeFiles/source-defaults-plugin.dir/root/repo/src/defaults-snapshot.c.o"
+  "CMakeFiles/source-defaults-plugin.dir/root/repo/src/defaults-snapshot.c.o.d"
+  "CMakeFiles/source-defaults-plugin.dir/root/repo/src/deferred-filters.c.o"
+  "CMakeFiles/source-defaults-plugin.dir/root/repo/src/deferred-filters.c.o.d"
+  "CMakeFiles/source-defaults-plugin.dir/root/repo/src/encountered-sources.c.o"
+  "CMakeFiles/source-defaults-plugin.dir/root/repo/src/encountered-sources.c.o.d"
+  "CMakeFiles/source-defaults-plugin.dir/root/repo/src/event-trace.c.o"
+  "CMakeFiles/source-defaults-plugin.dir/root/repo/src/event-trace.c.o.d"
+  "CMakeFiles/source-defaults-plugin.dir/root/repo/src/existing-sources.c.o"
+  "CMakeFiles/source-defaults-plugin.dir/root/repo/src/existing-sources.c.o.d"
+  "CMakeFiles/source-defaults-plugin.dir/root/repo/src/filter-stats.c.o"
+  "CMakeFiles/source-defaults-plugin.dir/root/repo/src/filter-stats.c.o.d"
+  "CMakeFiles/source-defaults-plugin.dir/root/repo/src/frozen-defaults.c.o"
+  "CMakeFiles/source-defaults-plugin.dir/root/repo/src/frozen-defaults.c.o.d"
+  "CMakeFiles/source-defaults-plugin.dir/root/repo/src/hash-table.c.o"
+  "CMakeFiles/source-defaults-plugin.dir/root/repo/src/hash-table.c.o.d"
+  "CMakeFiles/source-defaults-plugin.dir/root/repo/src/latency-stats.c.o"
+  "CMakeFiles/source-defaults-plugin.dir/root/repo/src/latency-stats.c.o.d"
+  "CMakeFiles/source-defaults-plugin.dir/root/repo/src/plugin-main.c.o"
+  "CMakeFiles/source-defaults-plugin.dir/root/repo/src/plugin-main.c.o.d"
+  "CMakeFiles/source-defaults-plugin.dir/root/repo/src/plugin-settings.c.o"
+  "CMakeFiles/source-defaults-plugin.dir/root/repo/src/plugin-settings.c.o.d"
+  "CMakeFiles/source-defaults-plugin.dir/root/repo/src/profile-rules.c.o"
+  "CMakeFiles/source-defaults-plugin.dir/root/repo/src/profile-rules.c.o.d"
+  "CMakeFiles/source-defaults-plugin.dir/root/repo/src/rcu-ptr.c.o"
+  "CMakeFiles/source-defaults-plugin.dir/root/repo/src/rcu-ptr.c.o.d"
+  "CMakeFiles/source-defaults-plugin.dir/root/repo/src/scene-catalog.c.o"
+  "CMakeFiles/source-defaults-plugin.dir/root/repo/src/scene-catalog.c.o.d"
+  "CMakeFiles/source-defaults-plugin.dir/root/repo/src/scene-index.c.o"
+  "CMakeFiles/source-defaults-plugin.dir/root/repo/src/scene-index.c.o.d"
+  "CMakeFiles/source-defaults-plugin.dir/root/repo/src/source-defaults-filter.c.o"
+  "CMakeFiles/source-defaults-plugin.dir/root/repo/src/source-defaults-filter.c.o.d"
+  "CMakeFiles/source-defaults-plugin.dir/root/repo/src/transition-pool.c.o"
+  "CMakeFiles/source-defaults-plugin.dir/root/repo/src/transition-pool.c.o.d"
+  "libsource-defaults-plugin.a"
+  "libsource-defaults-plugin.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/source-defaults-plugin.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
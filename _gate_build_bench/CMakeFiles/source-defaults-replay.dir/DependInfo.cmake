@@ -0,0 +1,24 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/bench/bench-stats.c" "CMakeFiles/source-defaults-replay.dir/bench-stats.c.o" "gcc" "CMakeFiles/source-defaults-replay.dir/bench-stats.c.o.d"
+  "/root/repo/bench/scene-collection.c" "CMakeFiles/source-defaults-replay.dir/scene-collection.c.o" "gcc" "CMakeFiles/source-defaults-replay.dir/scene-collection.c.o.d"
+  "/root/repo/bench/source-defaults-replay.c" "CMakeFiles/source-defaults-replay.dir/source-defaults-replay.c.o" "gcc" "CMakeFiles/source-defaults-replay.dir/source-defaults-replay.c.o.d"
+  "/root/repo/bench/source-types.c" "CMakeFiles/source-defaults-replay.dir/source-types.c.o" "gcc" "CMakeFiles/source-defaults-replay.dir/source-types.c.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_gate_build_bench/CMakeFiles/source-defaults-plugin.dir/DependInfo.cmake"
+  "/root/repo/_gate_build_bench/CMakeFiles/obs-standin.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
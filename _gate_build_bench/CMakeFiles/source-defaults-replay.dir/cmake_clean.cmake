@@ -0,0 +1,17 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/source-defaults-replay.dir/bench-stats.c.o"
+  "CMakeFiles/source-defaults-replay.dir/bench-stats.c.o.d"
+  "CMakeFiles/source-defaults-replay.dir/scene-collection.c.o"
+  "CMakeFiles/source-defaults-replay.dir/scene-collection.c.o.d"
+  "CMakeFiles/source-defaults-replay.dir/source-defaults-replay.c.o"
+  "CMakeFiles/source-defaults-replay.dir/source-defaults-replay.c.o.d"
+  "CMakeFiles/source-defaults-replay.dir/source-types.c.o"
+  "CMakeFiles/source-defaults-replay.dir/source-types.c.o.d"
+  "source-defaults-replay"
+  "source-defaults-replay.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/source-defaults-replay.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,106 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <stdio.h>
+#include <standin.h>
+#include <util/darray.h>
+
+#include "bench-stats.h"
+
+struct bench_timing {
+	char *name;
+	struct latency_stats stats;
+};
+
+static DARRAY(struct bench_timing *) timings;
+
+static struct latency_stats *get_stats(const char *name)
+{
+	for (size_t i = 0; i < timings.num; i++) {
+		if (strcmp(timings.array[i]->name, name) == 0)
+			return &timings.array[i]->stats;
+	}
+
+	struct bench_timing *timing = bzalloc(sizeof(*timing));
+	timing->name = bstrdup(name);
+	timing->stats.name = timing->name;
+	da_push_back(timings, &timing);
+	return &timing->stats;
+}
+
+static void timer_cb(const char *what, uint64_t ns, void *param)
+{
+	UNUSED_PARAMETER(param);
+	latency_stats_record(get_stats(what), ns);
+}
+
+void bench_stats_init(void)
+{
+	da_init(timings);
+	standin_set_timer(timer_cb, NULL);
+}
+
+void bench_stats_free(void)
+{
+	standin_set_timer(NULL, NULL);
+	for (size_t i = 0; i < timings.num; i++) {
+		bfree(timings.array[i]->name);
+		bfree(timings.array[i]);
+	}
+	da_free(timings);
+}
+
+void bench_stats_record(const char *name, uint64_t ns)
+{
+	latency_stats_record(get_stats(name), ns);
+}
+
+void bench_stats_reset(void)
+{
+	for (size_t i = 0; i < timings.num; i++)
+		latency_stats_reset(&timings.array[i]->stats);
+}
+
+void bench_stats_pause(bool paused)
+{
+	standin_set_timer(paused ? NULL : timer_cb, NULL);
+}
+
+static inline double ns_to_ms(uint64_t ns)
+{
+	return (double)ns / 1000000.0;
+}
+
+void bench_stats_print(void)
+{
+	printf("%-20s %8s %10s %10s %10s %10s\n", "callback", "count",
+	       "p50 ms", "p90 ms", "p99 ms", "max ms");
+
+	for (size_t i = 0; i < timings.num; i++) {
+		const struct latency_stats *stats = &timings.array[i]->stats;
+		if (!stats->count)
+			continue;
+
+		printf("%-20s %8ld %10.3f %10.3f %10.3f %10.3f\n", stats->name,
+		       stats->count,
+		       ns_to_ms(latency_stats_percentile(stats, 50.0)),
+		       ns_to_ms(latency_stats_percentile(stats, 90.0)),
+		       ns_to_ms(latency_stats_percentile(stats, 99.0)),
+		       (double)stats->max_us / 1000.0);
+	}
+}
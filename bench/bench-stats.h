@@ -0,0 +1,39 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <obs.h>
+#include "latency-stats.h"
+
+/**
+ * Latencies of everything the stand-in times, by name: the signal that ran
+ * the callback ("source_create", "item_add", ...), "tick", "ui_task" and so
+ * on. The benchmarks add their own rows with bench_stats_record().
+ */
+
+extern void bench_stats_init(void);
+extern void bench_stats_free(void);
+
+extern void bench_stats_record(const char *name, uint64_t ns);
+/* Drops what was recorded so far, e.g. after warming up */
+extern void bench_stats_reset(void);
+/* The stand-in's timings are dropped while paused, e.g. while setting up */
+extern void bench_stats_pause(bool paused);
+/* One row per name, in the order they were first recorded */
+extern void bench_stats_print(void);
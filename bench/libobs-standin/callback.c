@@ -0,0 +1,363 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <callback/calldata.h>
+#include <callback/signal.h>
+#include <callback/proc.h>
+#include <util/base.h>
+#include <util/bmem.h>
+#include <util/darray.h>
+#include <util/threading.h>
+
+#include "standin-internal.h"
+
+/* ------------------------------------------------------------------------- */
+/* calldata */
+
+static void free_param(struct calldata_param *param)
+{
+	if (param->type == CALLDATA_STRING)
+		bfree(param->str);
+}
+
+void calldata_clear(calldata_t *data)
+{
+	for (size_t i = 0; i < data->num; i++) {
+		free_param(&data->params[i]);
+		bfree(data->params[i].name);
+	}
+	data->num = 0;
+}
+
+void calldata_free(calldata_t *data)
+{
+	calldata_clear(data);
+	bfree(data->params);
+	calldata_init(data);
+}
+
+static struct calldata_param *find_param(const calldata_t *data,
+					 const char *name)
+{
+	for (size_t i = 0; i < data->num; i++) {
+		if (strcmp(data->params[i].name, name) == 0)
+			return &data->params[i];
+	}
+	return NULL;
+}
+
+static struct calldata_param *set_param(calldata_t *data, const char *name,
+					enum calldata_type type)
+{
+	struct calldata_param *param = find_param(data, name);
+	if (param) {
+		free_param(param);
+	} else {
+		if (data->num == data->capacity) {
+			data->capacity = data->capacity ? data->capacity * 2
+							: 4;
+			data->params = brealloc(data->params,
+						sizeof(*data->params) *
+							data->capacity);
+		}
+		param = &data->params[data->num++];
+		param->name = bstrdup(name);
+	}
+	param->type = type;
+	return param;
+}
+
+void calldata_set_ptr(calldata_t *data, const char *name, void *ptr)
+{
+	set_param(data, name, CALLDATA_PTR)->ptr = ptr;
+}
+
+void calldata_set_int(calldata_t *data, const char *name, long long val)
+{
+	set_param(data, name, CALLDATA_INT)->i = val;
+}
+
+void calldata_set_float(calldata_t *data, const char *name, double val)
+{
+	set_param(data, name, CALLDATA_FLOAT)->f = val;
+}
+
+void calldata_set_bool(calldata_t *data, const char *name, bool val)
+{
+	set_param(data, name, CALLDATA_BOOL)->b = val;
+}
+
+void calldata_set_string(calldata_t *data, const char *name, const char *str)
+{
+	set_param(data, name, CALLDATA_STRING)->str = bstrdup(str);
+}
+
+/* Like libobs, a parameter of another type reads as missing */
+static struct calldata_param *get_param(const calldata_t *data,
+					const char *name,
+					enum calldata_type type)
+{
+	struct calldata_param *param = data ? find_param(data, name) : NULL;
+	return param && param->type == type ? param : NULL;
+}
+
+void *calldata_ptr(const calldata_t *data, const char *name)
+{
+	struct calldata_param *param = get_param(data, name, CALLDATA_PTR);
+	return param ? param->ptr : NULL;
+}
+
+long long calldata_int(const calldata_t *data, const char *name)
+{
+	struct calldata_param *param = get_param(data, name, CALLDATA_INT);
+	return param ? param->i : 0;
+}
+
+double calldata_float(const calldata_t *data, const char *name)
+{
+	struct calldata_param *param = get_param(data, name, CALLDATA_FLOAT);
+	return param ? param->f : 0.0;
+}
+
+bool calldata_bool(const calldata_t *data, const char *name)
+{
+	struct calldata_param *param = get_param(data, name, CALLDATA_BOOL);
+	return param ? param->b : false;
+}
+
+const char *calldata_string(const calldata_t *data, const char *name)
+{
+	struct calldata_param *param = get_param(data, name, CALLDATA_STRING);
+	return param ? param->str : NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/* signals */
+
+struct signal_callback {
+	signal_callback_t callback;
+	void *data;
+	bool remove;
+};
+
+struct signal_info {
+	char *name;
+	DARRAY(struct signal_callback) callbacks;
+	long signalling;
+};
+
+struct signal_handler {
+	pthread_mutex_t mutex;
+	DARRAY(struct signal_info *) signals;
+};
+
+signal_handler_t *signal_handler_create(void)
+{
+	signal_handler_t *handler = bzalloc(sizeof(*handler));
+	pthread_mutex_init_recursive(&handler->mutex);
+	return handler;
+}
+
+void signal_handler_destroy(signal_handler_t *handler)
+{
+	if (!handler)
+		return;
+
+	for (size_t i = 0; i < handler->signals.num; i++) {
+		struct signal_info *sig = handler->signals.array[i];
+		da_free(sig->callbacks);
+		bfree(sig->name);
+		bfree(sig);
+	}
+	da_free(handler->signals);
+	pthread_mutex_destroy(&handler->mutex);
+	bfree(handler);
+}
+
+static struct signal_info *get_signal(signal_handler_t *handler,
+				      const char *name, bool create)
+{
+	for (size_t i = 0; i < handler->signals.num; i++) {
+		struct signal_info *sig = handler->signals.array[i];
+		if (strcmp(sig->name, name) == 0)
+			return sig;
+	}
+	if (!create)
+		return NULL;
+
+	struct signal_info *sig = bzalloc(sizeof(*sig));
+	sig->name = bstrdup(name);
+	da_push_back(handler->signals, &sig);
+	return sig;
+}
+
+bool signal_handler_add(signal_handler_t *handler, const char *signal_decl)
+{
+	// "void name(ptr source)", only the name is kept
+	const char *name = strchr(signal_decl, ' ');
+	name = name ? name + 1 : signal_decl;
+	const char *end = strchr(name, '(');
+	char *copy = bstrdup_n(name, end ? (size_t)(end - name) : strlen(name));
+
+	pthread_mutex_lock(&handler->mutex);
+	get_signal(handler, copy, true);
+	pthread_mutex_unlock(&handler->mutex);
+	bfree(copy);
+	return true;
+}
+
+static size_t find_callback(struct signal_info *sig, signal_callback_t callback,
+			    void *data)
+{
+	for (size_t i = 0; i < sig->callbacks.num; i++) {
+		struct signal_callback *cb = &sig->callbacks.array[i];
+		if (cb->callback == callback && cb->data == data &&
+		    !cb->remove)
+			return i;
+	}
+	return DARRAY_INVALID;
+}
+
+/* Connecting the same callback and data twice keeps one connection */
+void signal_handler_connect(signal_handler_t *handler, const char *signal,
+			    signal_callback_t callback, void *data)
+{
+	if (!handler)
+		return;
+
+	pthread_mutex_lock(&handler->mutex);
+	struct signal_info *sig = get_signal(handler, signal, true);
+	if (find_callback(sig, callback, data) == DARRAY_INVALID) {
+		struct signal_callback cb = {callback, data, false};
+		da_push_back(sig->callbacks, &cb);
+	}
+	pthread_mutex_unlock(&handler->mutex);
+}
+
+void signal_handler_disconnect(signal_handler_t *handler, const char *signal,
+			       void (*callback)(void *, calldata_t *),
+			       void *data)
+{
+	if (!handler)
+		return;
+
+	pthread_mutex_lock(&handler->mutex);
+	struct signal_info *sig = get_signal(handler, signal, false);
+	size_t idx = sig ? find_callback(sig, callback, data) : DARRAY_INVALID;
+	if (idx != DARRAY_INVALID) {
+		// erased once the signal that is running returns
+		if (sig->signalling)
+			sig->callbacks.array[idx].remove = true;
+		else
+			da_erase(sig->callbacks, idx);
+	}
+	pthread_mutex_unlock(&handler->mutex);
+}
+
+void signal_handler_signal(signal_handler_t *handler, const char *signal,
+			   calldata_t *params)
+{
+	if (!handler)
+		return;
+
+	pthread_mutex_lock(&handler->mutex);
+	struct signal_info *sig = get_signal(handler, signal, false);
+	if (!sig) {
+		pthread_mutex_unlock(&handler->mutex);
+		return;
+	}
+
+	sig->signalling++;
+	// callbacks connected while signalling only run the next time
+	size_t num = sig->callbacks.num;
+	uint64_t start = num ? standin_timer_begin() : 0;
+	for (size_t i = 0; i < num; i++) {
+		struct signal_callback cb = sig->callbacks.array[i];
+		if (!cb.remove)
+			cb.callback(cb.data, params);
+	}
+	if (num)
+		standin_timer_end(sig->name, start);
+	if (--sig->signalling == 0) {
+		for (size_t i = sig->callbacks.num; i > 0; i--) {
+			if (sig->callbacks.array[i - 1].remove)
+				da_erase(sig->callbacks, i - 1);
+		}
+	}
+	pthread_mutex_unlock(&handler->mutex);
+}
+
+/* ------------------------------------------------------------------------- */
+/* procedures */
+
+struct proc_info {
+	char *name;
+	proc_handler_proc_t proc;
+	void *data;
+};
+
+struct proc_handler {
+	DARRAY(struct proc_info) procs;
+};
+
+proc_handler_t *proc_handler_create(void)
+{
+	return bzalloc(sizeof(struct proc_handler));
+}
+
+void proc_handler_destroy(proc_handler_t *handler)
+{
+	if (!handler)
+		return;
+
+	for (size_t i = 0; i < handler->procs.num; i++)
+		bfree(handler->procs.array[i].name);
+	da_free(handler->procs);
+	bfree(handler);
+}
+
+void proc_handler_add(proc_handler_t *handler, const char *decl_string,
+		      proc_handler_proc_t proc, void *data)
+{
+	// "void name(in string a, out bool b)"
+	const char *name = strchr(decl_string, ' ');
+	name = name ? name + 1 : decl_string;
+	const char *end = strchr(name, '(');
+	if (!end) {
+		blog(LOG_ERROR, "Invalid procedure declaration: %s",
+		     decl_string);
+		return;
+	}
+
+	struct proc_info info = {bstrdup_n(name, (size_t)(end - name)), proc,
+				 data};
+	da_push_back(handler->procs, &info);
+}
+
+bool proc_handler_call(proc_handler_t *handler, const char *name,
+		       calldata_t *params)
+{
+	for (size_t i = 0; i < handler->procs.num; i++) {
+		struct proc_info *info = &handler->procs.array[i];
+		if (strcmp(info->name, name) == 0) {
+			info->proc(info->data, params);
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,80 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include "../util/c99defs.h"
+
+/**
+ * Named parameters of signals and procedures. Unlike libobs, the values are
+ * kept in a small array instead of a packed stack, which is all the plugin
+ * can tell apart through the accessors.
+ */
+
+enum calldata_type {
+	CALLDATA_PTR,
+	CALLDATA_INT,
+	CALLDATA_FLOAT,
+	CALLDATA_BOOL,
+	CALLDATA_STRING,
+};
+
+struct calldata_param {
+	char *name;
+	enum calldata_type type;
+	union {
+		void *ptr;
+		long long i;
+		double f;
+		bool b;
+		char *str;
+	};
+};
+
+struct calldata {
+	struct calldata_param *params;
+	size_t num;
+	size_t capacity;
+};
+
+typedef struct calldata calldata_t;
+
+static inline void calldata_init(calldata_t *data)
+{
+	data->params = NULL;
+	data->num = 0;
+	data->capacity = 0;
+}
+
+extern void calldata_free(calldata_t *data);
+extern void calldata_clear(calldata_t *data);
+
+extern void calldata_set_ptr(calldata_t *data, const char *name, void *ptr);
+extern void calldata_set_int(calldata_t *data, const char *name,
+			     long long val);
+extern void calldata_set_float(calldata_t *data, const char *name,
+			       double val);
+extern void calldata_set_bool(calldata_t *data, const char *name, bool val);
+extern void calldata_set_string(calldata_t *data, const char *name,
+				const char *str);
+
+extern void *calldata_ptr(const calldata_t *data, const char *name);
+extern long long calldata_int(const calldata_t *data, const char *name);
+extern double calldata_float(const calldata_t *data, const char *name);
+extern bool calldata_bool(const calldata_t *data, const char *name);
+extern const char *calldata_string(const calldata_t *data, const char *name);
@@ -0,0 +1,39 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include "calldata.h"
+
+/* Signals don't have to be declared, connecting to one creates it */
+typedef struct signal_handler signal_handler_t;
+typedef void (*signal_callback_t)(void *data, calldata_t *cd);
+
+extern signal_handler_t *signal_handler_create(void);
+extern void signal_handler_destroy(signal_handler_t *handler);
+
+extern bool signal_handler_add(signal_handler_t *handler,
+			       const char *signal_decl);
+extern void signal_handler_connect(signal_handler_t *handler,
+				   const char *signal,
+				   signal_callback_t callback, void *data);
+extern void signal_handler_disconnect(signal_handler_t *handler,
+				      const char *signal,
+				      signal_callback_t callback, void *data);
+extern void signal_handler_signal(signal_handler_t *handler,
+				  const char *signal, calldata_t *params);
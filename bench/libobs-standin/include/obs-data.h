@@ -0,0 +1,113 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include "util/c99defs.h"
+
+/**
+ * Settings objects with user and default values, like libobs' obs-data.
+ * Vectors are kept as objects with x and y, as libobs saves them.
+ */
+
+struct vec2 {
+	float x, y;
+};
+
+typedef struct obs_data obs_data_t;
+typedef struct obs_data_item obs_data_item_t;
+typedef struct obs_data_array obs_data_array_t;
+
+enum obs_data_type {
+	OBS_DATA_NULL,
+	OBS_DATA_STRING,
+	OBS_DATA_NUMBER,
+	OBS_DATA_BOOLEAN,
+	OBS_DATA_OBJECT,
+	OBS_DATA_ARRAY,
+};
+
+extern obs_data_t *obs_data_create(void);
+extern obs_data_t *obs_data_create_from_json(const char *json_string);
+extern obs_data_t *obs_data_create_from_json_file(const char *json_file);
+extern obs_data_t *obs_data_create_from_json_file_safe(const char *json_file,
+						       const char *backup_ext);
+extern void obs_data_addref(obs_data_t *data);
+extern void obs_data_release(obs_data_t *data);
+
+/* Only user values are written, like libobs does */
+extern const char *obs_data_get_json(obs_data_t *data);
+extern bool obs_data_save_json(obs_data_t *data, const char *file);
+extern bool obs_data_save_json_safe(obs_data_t *data, const char *file,
+				    const char *temp_ext,
+				    const char *backup_ext);
+
+extern void obs_data_apply(obs_data_t *target, obs_data_t *apply_data);
+extern void obs_data_erase(obs_data_t *data, const char *name);
+extern void obs_data_clear(obs_data_t *data);
+
+extern void obs_data_set_string(obs_data_t *data, const char *name,
+				const char *val);
+extern void obs_data_set_int(obs_data_t *data, const char *name,
+			     long long val);
+extern void obs_data_set_double(obs_data_t *data, const char *name,
+				double val);
+extern void obs_data_set_bool(obs_data_t *data, const char *name, bool val);
+extern void obs_data_set_obj(obs_data_t *data, const char *name,
+			     obs_data_t *obj);
+extern void obs_data_set_array(obs_data_t *data, const char *name,
+			       obs_data_array_t *array);
+extern void obs_data_set_vec2(obs_data_t *data, const char *name,
+			      const struct vec2 *val);
+
+extern void obs_data_set_default_string(obs_data_t *data, const char *name,
+					const char *val);
+extern void obs_data_set_default_int(obs_data_t *data, const char *name,
+				     long long val);
+extern void obs_data_set_default_double(obs_data_t *data, const char *name,
+					double val);
+extern void obs_data_set_default_bool(obs_data_t *data, const char *name,
+				      bool val);
+
+extern const char *obs_data_get_string(obs_data_t *data, const char *name);
+extern long long obs_data_get_int(obs_data_t *data, const char *name);
+extern double obs_data_get_double(obs_data_t *data, const char *name);
+extern bool obs_data_get_bool(obs_data_t *data, const char *name);
+extern obs_data_t *obs_data_get_obj(obs_data_t *data, const char *name);
+extern obs_data_array_t *obs_data_get_array(obs_data_t *data,
+					    const char *name);
+extern void obs_data_get_vec2(obs_data_t *data, const char *name,
+			      struct vec2 *val);
+
+extern bool obs_data_has_user_value(obs_data_t *data, const char *name);
+
+extern obs_data_array_t *obs_data_array_create(void);
+extern void obs_data_array_addref(obs_data_array_t *array);
+extern void obs_data_array_release(obs_data_array_t *array);
+extern size_t obs_data_array_count(obs_data_array_t *array);
+extern obs_data_t *obs_data_array_item(obs_data_array_t *array, size_t idx);
+extern size_t obs_data_array_push_back(obs_data_array_t *array,
+				       obs_data_t *obj);
+
+/* Iterates over all items, with or without a user value */
+extern obs_data_item_t *obs_data_first(obs_data_t *data);
+extern bool obs_data_item_next(obs_data_item_t **item);
+extern void obs_data_item_release(obs_data_item_t **item);
+extern bool obs_data_item_has_user_value(obs_data_item_t *item);
+extern const char *obs_data_item_get_name(obs_data_item_t *item);
+extern enum obs_data_type obs_data_item_gettype(obs_data_item_t *item);
@@ -0,0 +1,101 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include "obs.h"
+#include "util/config-file.h"
+#include "util/darray.h"
+
+enum obs_frontend_event {
+	OBS_FRONTEND_EVENT_STREAMING_STARTING,
+	OBS_FRONTEND_EVENT_STREAMING_STARTED,
+	OBS_FRONTEND_EVENT_STREAMING_STOPPING,
+	OBS_FRONTEND_EVENT_STREAMING_STOPPED,
+	OBS_FRONTEND_EVENT_RECORDING_STARTING,
+	OBS_FRONTEND_EVENT_RECORDING_STARTED,
+	OBS_FRONTEND_EVENT_RECORDING_STOPPING,
+	OBS_FRONTEND_EVENT_RECORDING_STOPPED,
+	OBS_FRONTEND_EVENT_SCENE_CHANGED,
+	OBS_FRONTEND_EVENT_SCENE_LIST_CHANGED,
+	OBS_FRONTEND_EVENT_TRANSITION_CHANGED,
+	OBS_FRONTEND_EVENT_TRANSITION_STOPPED,
+	OBS_FRONTEND_EVENT_TRANSITION_LIST_CHANGED,
+	OBS_FRONTEND_EVENT_SCENE_COLLECTION_CHANGED,
+	OBS_FRONTEND_EVENT_SCENE_COLLECTION_LIST_CHANGED,
+	OBS_FRONTEND_EVENT_PROFILE_CHANGED,
+	OBS_FRONTEND_EVENT_PROFILE_LIST_CHANGED,
+	OBS_FRONTEND_EVENT_EXIT,
+	OBS_FRONTEND_EVENT_REPLAY_BUFFER_STARTING,
+	OBS_FRONTEND_EVENT_REPLAY_BUFFER_STARTED,
+	OBS_FRONTEND_EVENT_REPLAY_BUFFER_STOPPING,
+	OBS_FRONTEND_EVENT_REPLAY_BUFFER_STOPPED,
+	OBS_FRONTEND_EVENT_STUDIO_MODE_ENABLED,
+	OBS_FRONTEND_EVENT_STUDIO_MODE_DISABLED,
+	OBS_FRONTEND_EVENT_PREVIEW_SCENE_CHANGED,
+	OBS_FRONTEND_EVENT_SCENE_COLLECTION_CLEANUP,
+	OBS_FRONTEND_EVENT_FINISHED_LOADING,
+	OBS_FRONTEND_EVENT_RECORDING_PAUSED,
+	OBS_FRONTEND_EVENT_RECORDING_UNPAUSED,
+	OBS_FRONTEND_EVENT_TRANSITION_DURATION_CHANGED,
+	OBS_FRONTEND_EVENT_REPLAY_BUFFER_SAVED,
+	OBS_FRONTEND_EVENT_VIRTUALCAM_STARTED,
+	OBS_FRONTEND_EVENT_VIRTUALCAM_STOPPED,
+	OBS_FRONTEND_EVENT_TBAR_VALUE_CHANGED,
+	OBS_FRONTEND_EVENT_SCENE_COLLECTION_CHANGING,
+	OBS_FRONTEND_EVENT_PROFILE_CHANGING,
+	OBS_FRONTEND_EVENT_SCRIPTING_SHUTDOWN,
+	OBS_FRONTEND_EVENT_PROFILE_RENAMED,
+	OBS_FRONTEND_EVENT_SCENE_COLLECTION_RENAMED,
+	OBS_FRONTEND_EVENT_THEME_CHANGED,
+	OBS_FRONTEND_EVENT_SCREENSHOT_TAKEN,
+};
+
+typedef void (*obs_frontend_event_cb)(enum obs_frontend_event event,
+				      void *private_data);
+typedef void (*obs_frontend_save_cb)(obs_data_t *save_data, bool saving,
+				     void *private_data);
+
+struct obs_frontend_source_list {
+	DARRAY(obs_source_t *) sources;
+};
+
+static inline void
+obs_frontend_source_list_free(struct obs_frontend_source_list *source_list)
+{
+	size_t num = source_list->sources.num;
+	for (size_t i = 0; i < num; i++)
+		obs_source_release(source_list->sources.array[i]);
+	da_free(source_list->sources);
+}
+
+extern void obs_frontend_add_event_callback(obs_frontend_event_cb callback,
+					    void *private_data);
+extern void obs_frontend_remove_event_callback(obs_frontend_event_cb callback,
+					       void *private_data);
+extern void obs_frontend_add_save_callback(obs_frontend_save_cb callback,
+					   void *private_data);
+extern void obs_frontend_remove_save_callback(obs_frontend_save_cb callback,
+					      void *private_data);
+
+/* In the order they were created, like the scene list of a new collection */
+extern void obs_frontend_get_scenes(struct obs_frontend_source_list *sources);
+extern obs_source_t *obs_frontend_get_current_scene(void);
+extern obs_source_t *obs_frontend_get_current_preview_scene(void);
+extern bool obs_frontend_preview_program_mode_active(void);
+extern config_t *obs_frontend_get_global_config(void);
@@ -0,0 +1,33 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include "obs.h"
+
+/* The plugin is linked into the benchmark instead of being loaded */
+#define OBS_DECLARE_MODULE()
+#define OBS_MODULE_USE_DEFAULT_LOCALE(module_name, default_locale)
+
+extern bool obs_module_load(void);
+extern void obs_module_unload(void);
+
+/* Returns the lookup string itself, there is no locale */
+extern const char *obs_module_text(const char *lookup);
+/* Under the stand-in's config directory, see standin_set_config_dir() */
+extern char *obs_module_config_path(const char *file);
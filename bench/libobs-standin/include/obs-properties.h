@@ -0,0 +1,94 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include "obs-data.h"
+
+/* Properties are only built, there is no UI to show them */
+
+typedef struct obs_properties obs_properties_t;
+typedef struct obs_property obs_property_t;
+
+enum obs_text_type {
+	OBS_TEXT_DEFAULT,
+	OBS_TEXT_PASSWORD,
+	OBS_TEXT_MULTILINE,
+	OBS_TEXT_INFO,
+};
+
+enum obs_combo_type {
+	OBS_COMBO_TYPE_INVALID,
+	OBS_COMBO_TYPE_EDITABLE,
+	OBS_COMBO_TYPE_LIST,
+	OBS_COMBO_TYPE_RADIO,
+};
+
+enum obs_combo_format {
+	OBS_COMBO_FORMAT_INVALID,
+	OBS_COMBO_FORMAT_INT,
+	OBS_COMBO_FORMAT_FLOAT,
+	OBS_COMBO_FORMAT_STRING,
+};
+
+enum obs_group_type {
+	OBS_COMBO_INVALID,
+	OBS_GROUP_NORMAL,
+	OBS_GROUP_CHECKABLE,
+};
+
+typedef bool (*obs_property_clicked_t)(obs_properties_t *props,
+				       obs_property_t *property, void *data);
+
+extern obs_properties_t *obs_properties_create(void);
+extern void obs_properties_destroy(obs_properties_t *props);
+extern obs_property_t *obs_properties_get(obs_properties_t *props,
+					  const char *property);
+extern size_t obs_properties_count(obs_properties_t *props);
+
+extern obs_property_t *obs_properties_add_bool(obs_properties_t *props,
+					       const char *name,
+					       const char *description);
+extern obs_property_t *obs_properties_add_text(obs_properties_t *props,
+					       const char *name,
+					       const char *description,
+					       enum obs_text_type type);
+extern obs_property_t *
+obs_properties_add_list(obs_properties_t *props, const char *name,
+			const char *description, enum obs_combo_type type,
+			enum obs_combo_format format);
+extern obs_property_t *obs_properties_add_group(obs_properties_t *props,
+						const char *name,
+						const char *description,
+						enum obs_group_type type,
+						obs_properties_t *group);
+extern obs_property_t *
+obs_properties_add_button2(obs_properties_t *props, const char *name,
+			   const char *text, obs_property_clicked_t callback,
+			   void *priv);
+
+/* Calls the callback of a button, like clicking it */
+extern bool obs_property_button_clicked(obs_property_t *p, void *obj);
+
+extern void obs_property_set_long_description(obs_property_t *p,
+					      const char *long_description);
+extern size_t obs_property_list_add_string(obs_property_t *p,
+					   const char *name, const char *val);
+extern size_t obs_property_list_add_int(obs_property_t *p, const char *name,
+					long long val);
+extern size_t obs_property_list_item_count(obs_property_t *p);
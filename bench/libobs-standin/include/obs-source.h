@@ -0,0 +1,69 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include "obs-properties.h"
+
+typedef struct obs_source obs_source_t;
+
+enum obs_source_type {
+	OBS_SOURCE_TYPE_INPUT,
+	OBS_SOURCE_TYPE_FILTER,
+	OBS_SOURCE_TYPE_TRANSITION,
+	OBS_SOURCE_TYPE_SCENE,
+};
+
+#define OBS_SOURCE_VIDEO (1 << 0)
+#define OBS_SOURCE_AUDIO (1 << 1)
+#define OBS_SOURCE_ASYNC (1 << 2)
+#define OBS_SOURCE_ASYNC_VIDEO (OBS_SOURCE_ASYNC | OBS_SOURCE_VIDEO)
+#define OBS_SOURCE_CUSTOM_DRAW (1 << 3)
+#define OBS_SOURCE_INTERACTION (1 << 5)
+#define OBS_SOURCE_COMPOSITE (1 << 6)
+#define OBS_SOURCE_DO_NOT_DUPLICATE (1 << 7)
+#define OBS_SOURCE_DEPRECATED (1 << 8)
+#define OBS_SOURCE_CAP_DISABLED (1 << 10)
+
+/* The callbacks of libobs' obs_source_info that the stand-in calls */
+struct obs_source_info {
+	const char *id;
+	enum obs_source_type type;
+	uint32_t output_flags;
+
+	const char *(*get_name)(void *type_data);
+	void *(*create)(obs_data_t *settings, obs_source_t *source);
+	void (*destroy)(void *data);
+	uint32_t (*get_width)(void *data);
+	uint32_t (*get_height)(void *data);
+	void (*get_defaults)(obs_data_t *settings);
+	obs_properties_t *(*get_properties)(void *data);
+	void (*update)(void *data, obs_data_t *settings);
+	void (*activate)(void *data);
+	void (*deactivate)(void *data);
+	void (*show)(void *data);
+	void (*hide)(void *data);
+	void (*video_tick)(void *data, float seconds);
+	void (*save)(void *data, obs_data_t *settings);
+	void (*load)(void *data, obs_data_t *settings);
+	void (*filter_add)(void *data, obs_source_t *source);
+	void (*filter_remove)(void *data, obs_source_t *source);
+	uint32_t version;
+};
+
+extern void obs_register_source(struct obs_source_info *info);
@@ -0,0 +1,244 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+/**
+ * A single-threaded stand-in for the parts of libobs that the plugin uses,
+ * so it can be built and run without OBS. See bench/README.md.
+ */
+
+#include "util/c99defs.h"
+#include "util/bmem.h"
+#include "util/base.h"
+#include "callback/signal.h"
+#include "callback/proc.h"
+#include "obs-data.h"
+#include "obs-properties.h"
+#include "obs-source.h"
+
+typedef struct obs_weak_source obs_weak_source_t;
+typedef struct obs_scene obs_scene_t;
+typedef struct obs_scene_item obs_sceneitem_t;
+
+enum obs_monitoring_type {
+	OBS_MONITORING_TYPE_NONE,
+	OBS_MONITORING_TYPE_MONITOR_ONLY,
+	OBS_MONITORING_TYPE_MONITOR_AND_OUTPUT,
+};
+
+enum obs_bounds_type {
+	OBS_BOUNDS_NONE,
+	OBS_BOUNDS_STRETCH,
+	OBS_BOUNDS_SCALE_INNER,
+	OBS_BOUNDS_SCALE_OUTER,
+	OBS_BOUNDS_SCALE_TO_WIDTH,
+	OBS_BOUNDS_SCALE_TO_HEIGHT,
+	OBS_BOUNDS_MAX_ONLY,
+};
+
+enum obs_order_movement {
+	OBS_ORDER_MOVE_UP,
+	OBS_ORDER_MOVE_DOWN,
+	OBS_ORDER_MOVE_TOP,
+	OBS_ORDER_MOVE_BOTTOM,
+};
+
+enum obs_task_type {
+	OBS_TASK_UI,
+	OBS_TASK_GRAPHICS,
+	OBS_TASK_AUDIO,
+	OBS_TASK_DESTROY,
+};
+
+typedef void (*obs_task_t)(void *param);
+
+struct obs_transform_info {
+	struct vec2 pos;
+	float rot;
+	struct vec2 scale;
+	uint32_t alignment;
+	enum obs_bounds_type bounds_type;
+	uint32_t bounds_alignment;
+	struct vec2 bounds;
+};
+
+struct obs_sceneitem_crop {
+	int left;
+	int top;
+	int right;
+	int bottom;
+};
+
+/* ------------------------------------------------------------------------- */
+/* core */
+
+extern signal_handler_t *obs_get_signal_handler(void);
+extern proc_handler_t *obs_get_proc_handler(void);
+
+extern void *obs_obj_get_data(void *obj);
+extern bool obs_obj_is_private(void *obj);
+
+extern void obs_enum_sources(bool (*enum_proc)(void *, obs_source_t *),
+			     void *param);
+extern void obs_enum_scenes(bool (*enum_proc)(void *, obs_source_t *),
+			    void *param);
+extern obs_source_t *obs_get_source_by_name(const char *name);
+
+/* Tasks run when the stand-in pumps their queue, or right away with wait */
+extern void obs_queue_task(enum obs_task_type type, obs_task_t task,
+			   void *param, bool wait);
+extern void obs_add_tick_callback(void (*tick)(void *param, float seconds),
+				  void *param);
+extern void obs_remove_tick_callback(void (*tick)(void *param,
+						   float seconds),
+				     void *param);
+
+/* ------------------------------------------------------------------------- */
+/* sources */
+
+extern obs_source_t *obs_source_create(const char *id, const char *name,
+				       obs_data_t *settings,
+				       obs_data_t *hotkey_data);
+extern obs_source_t *obs_source_create_private(const char *id,
+					       const char *name,
+					       obs_data_t *settings);
+extern obs_source_t *obs_source_duplicate(obs_source_t *source,
+					  const char *desired_name,
+					  bool create_private);
+extern obs_source_t *obs_source_get_ref(obs_source_t *source);
+extern void obs_source_release(obs_source_t *source);
+extern void obs_source_remove(obs_source_t *source);
+extern bool obs_source_removed(const obs_source_t *source);
+
+extern obs_weak_source_t *obs_source_get_weak_source(obs_source_t *source);
+extern obs_source_t *obs_weak_source_get_source(obs_weak_source_t *weak);
+extern void obs_weak_source_addref(obs_weak_source_t *weak);
+extern void obs_weak_source_release(obs_weak_source_t *weak);
+extern bool obs_weak_source_references_source(obs_weak_source_t *weak,
+					      obs_source_t *source);
+
+extern const char *obs_source_get_name(const obs_source_t *source);
+extern void obs_source_set_name(obs_source_t *source, const char *name);
+extern enum obs_source_type obs_source_get_type(const obs_source_t *source);
+extern const char *obs_source_get_id(const obs_source_t *source);
+extern const char *obs_source_get_unversioned_id(const obs_source_t *source);
+extern uint32_t obs_source_get_output_flags(const obs_source_t *source);
+extern uint32_t obs_source_get_width(obs_source_t *source);
+extern uint32_t obs_source_get_height(obs_source_t *source);
+
+extern obs_data_t *obs_source_get_settings(const obs_source_t *source);
+extern void obs_source_update(obs_source_t *source, obs_data_t *settings);
+extern void obs_source_save(obs_source_t *source);
+extern obs_properties_t *obs_source_properties(const obs_source_t *source);
+
+extern signal_handler_t *
+obs_source_get_signal_handler(const obs_source_t *source);
+extern proc_handler_t *obs_source_get_proc_handler(const obs_source_t *source);
+
+extern bool obs_source_is_hidden(obs_source_t *source);
+extern bool obs_source_enabled(const obs_source_t *source);
+extern void obs_source_set_enabled(obs_source_t *source, bool enabled);
+extern bool obs_source_active(const obs_source_t *source);
+extern bool obs_source_showing(const obs_source_t *source);
+
+typedef void (*obs_source_enum_proc_t)(obs_source_t *parent,
+				       obs_source_t *child, void *param);
+
+extern obs_source_t *obs_filter_get_parent(const obs_source_t *filter);
+extern void obs_source_filter_add(obs_source_t *source, obs_source_t *filter);
+extern void obs_source_filter_remove(obs_source_t *source,
+				     obs_source_t *filter);
+extern void obs_source_filter_set_order(obs_source_t *source,
+					obs_source_t *filter,
+					enum obs_order_movement movement);
+extern void obs_source_enum_filters(obs_source_t *source,
+				    obs_source_enum_proc_t callback,
+				    void *param);
+extern obs_source_t *obs_source_get_filter_by_name(obs_source_t *source,
+						   const char *name);
+extern size_t obs_source_filter_count(const obs_source_t *source);
+
+extern enum obs_monitoring_type
+obs_source_get_monitoring_type(const obs_source_t *source);
+extern void obs_source_set_monitoring_type(obs_source_t *source,
+					   enum obs_monitoring_type type);
+extern float obs_source_get_volume(const obs_source_t *source);
+extern void obs_source_set_volume(obs_source_t *source, float volume);
+extern bool obs_source_muted(const obs_source_t *source);
+extern void obs_source_set_muted(obs_source_t *source, bool muted);
+extern float obs_source_get_balance_value(const obs_source_t *source);
+extern void obs_source_set_balance_value(obs_source_t *source,
+					 float balance);
+extern int64_t obs_source_get_sync_offset(const obs_source_t *source);
+extern void obs_source_set_sync_offset(obs_source_t *source, int64_t offset);
+extern uint32_t obs_source_get_audio_mixers(const obs_source_t *source);
+extern void obs_source_set_audio_mixers(obs_source_t *source,
+					uint32_t mixers);
+extern bool obs_source_audio_active(const obs_source_t *source);
+extern void obs_source_set_audio_active(obs_source_t *source, bool show);
+
+/* Hotkeys aren't simulated, sources save an empty object */
+extern obs_data_t *obs_hotkeys_save_source(obs_source_t *source);
+
+/* ------------------------------------------------------------------------- */
+/* scenes */
+
+extern obs_scene_t *obs_scene_create(const char *name);
+extern obs_scene_t *obs_scene_from_source(const obs_source_t *source);
+extern obs_source_t *obs_scene_get_source(const obs_scene_t *scene);
+extern obs_scene_t *obs_scene_get_ref(obs_scene_t *scene);
+extern void obs_scene_release(obs_scene_t *scene);
+extern obs_sceneitem_t *obs_scene_add(obs_scene_t *scene,
+				      obs_source_t *source);
+extern void obs_scene_enum_items(obs_scene_t *scene,
+				 bool (*callback)(obs_scene_t *,
+						  obs_sceneitem_t *, void *),
+				 void *param);
+extern obs_sceneitem_t *obs_scene_find_source(obs_scene_t *scene,
+					      const char *name);
+
+extern void obs_sceneitem_addref(obs_sceneitem_t *item);
+extern void obs_sceneitem_release(obs_sceneitem_t *item);
+extern void obs_sceneitem_remove(obs_sceneitem_t *item);
+extern obs_scene_t *obs_sceneitem_get_scene(const obs_sceneitem_t *item);
+extern obs_source_t *obs_sceneitem_get_source(const obs_sceneitem_t *item);
+extern int64_t obs_sceneitem_get_id(const obs_sceneitem_t *item);
+
+extern void obs_sceneitem_get_info(const obs_sceneitem_t *item,
+				   struct obs_transform_info *info);
+extern void obs_sceneitem_set_info(obs_sceneitem_t *item,
+				   const struct obs_transform_info *info);
+extern void obs_sceneitem_get_crop(const obs_sceneitem_t *item,
+				   struct obs_sceneitem_crop *crop);
+extern void obs_sceneitem_set_crop(obs_sceneitem_t *item,
+				   const struct obs_sceneitem_crop *crop);
+extern void obs_sceneitem_defer_update_begin(obs_sceneitem_t *item);
+extern void obs_sceneitem_defer_update_end(obs_sceneitem_t *item);
+
+extern bool obs_sceneitem_visible(const obs_sceneitem_t *item);
+extern bool obs_sceneitem_set_visible(obs_sceneitem_t *item, bool visible);
+extern obs_source_t *obs_sceneitem_get_transition(obs_sceneitem_t *item,
+						  bool show);
+extern void obs_sceneitem_set_transition(obs_sceneitem_t *item, bool show,
+					 obs_source_t *transition);
+extern uint32_t obs_sceneitem_get_transition_duration(obs_sceneitem_t *item,
+						      bool show);
+extern void obs_sceneitem_set_transition_duration(obs_sceneitem_t *item,
+						  bool show,
+						  uint32_t duration_ms);
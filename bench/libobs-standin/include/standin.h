@@ -0,0 +1,76 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+/**
+ * Controls the libobs stand-in from a benchmark: there is no UI or graphics
+ * thread, so the caller decides when UI tasks run and when a frame ticks.
+ */
+
+#include "obs-frontend-api.h"
+
+/* Sets up the core and registers the types below */
+extern void standin_startup(void);
+/* Destroys what is left, returns the number of leaked allocations */
+extern long standin_shutdown(void);
+
+/* Messages below this level are dropped, LOG_WARNING by default */
+extern void standin_set_log_level(int level);
+/* Where obs_module_config_path() points to, "standin-config" by default */
+extern void standin_set_config_dir(const char *path);
+
+/* Runs the queued UI tasks, including those they queue, returns the count */
+extern size_t standin_run_ui_tasks(void);
+/* One frame: graphics tasks, tick callbacks, then video_tick of sources */
+extern void standin_tick(float seconds);
+
+extern void standin_frontend_event(enum obs_frontend_event event);
+/* Runs the save callbacks, like saving or loading a scene collection */
+extern void standin_frontend_save(obs_data_t *save_data, bool saving);
+extern void standin_set_current_scene(obs_source_t *scene);
+/* A preview scene turns studio mode on, NULL turns it off */
+extern void standin_set_preview_scene(obs_source_t *scene);
+/* Like the two above, but without any frontend event */
+extern void standin_select_scenes(obs_source_t *program,
+				  obs_source_t *preview);
+
+/* Adds an item without the item_add signal, like libobs loading a scene */
+extern obs_sceneitem_t *standin_scene_load_item(obs_scene_t *scene,
+						obs_source_t *source);
+
+/**
+ * Called with the time spent in every signal (all of its callbacks), tick
+ * callback, task and frontend event callback, but not in the callbacks of
+ * the sources themselves. Callbacks that run inside another one are part of
+ * its time and aren't reported on their own.
+ */
+typedef void (*standin_timer_cb)(const char *what, uint64_t ns, void *param);
+extern void standin_set_timer(standin_timer_cb callback, void *param);
+
+/**
+ * Input types without any behavior of their own. Their video has a size
+ * once they ticked for the first time, like a media source that decoded
+ * its first frame. Filters and transitions only keep their settings.
+ */
+extern void standin_register_input(const char *id, uint32_t output_flags);
+extern void standin_register_filter(const char *id, uint32_t output_flags);
+extern void standin_register_transition(const char *id);
+/* Whether a type with this id was registered, and what kind it is */
+extern bool standin_type_registered(const char *id,
+				    enum obs_source_type *type);
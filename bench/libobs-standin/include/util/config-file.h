@@ -0,0 +1,54 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include "c99defs.h"
+
+/* An in-memory ini file: values are kept as strings, like in libobs */
+typedef struct config_data config_t;
+
+extern config_t *config_create(void);
+extern void config_close(config_t *config);
+
+extern void config_set_string(config_t *config, const char *section,
+			      const char *name, const char *value);
+extern void config_set_int(config_t *config, const char *section,
+			   const char *name, int64_t value);
+extern void config_set_uint(config_t *config, const char *section,
+			    const char *name, uint64_t value);
+extern void config_set_bool(config_t *config, const char *section,
+			    const char *name, bool value);
+
+extern const char *config_get_string(config_t *config, const char *section,
+				     const char *name);
+extern int64_t config_get_int(config_t *config, const char *section,
+			      const char *name);
+extern uint64_t config_get_uint(config_t *config, const char *section,
+				const char *name);
+extern bool config_get_bool(config_t *config, const char *section,
+			    const char *name);
+
+extern void config_set_default_string(config_t *config, const char *section,
+				      const char *name, const char *value);
+extern void config_set_default_int(config_t *config, const char *section,
+				   const char *name, int64_t value);
+extern void config_set_default_uint(config_t *config, const char *section,
+				    const char *name, uint64_t value);
+extern void config_set_default_bool(config_t *config, const char *section,
+				    const char *name, bool value);
@@ -0,0 +1,307 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <assert.h>
+#include <stdlib.h>
+#include "bmem.h"
+
+/* Same layout and macros as libobs' util/darray.h */
+
+#define DARRAY_INVALID ((size_t)-1)
+
+struct darray {
+	void *array;
+	size_t num;
+	size_t capacity;
+};
+
+#define DARRAY(type)                     \
+	union {                          \
+		struct darray da;        \
+		struct {                 \
+			type *array;     \
+			size_t num;      \
+			size_t capacity; \
+		};                       \
+	}
+
+static inline void darray_init(struct darray *dst)
+{
+	dst->array = NULL;
+	dst->num = 0;
+	dst->capacity = 0;
+}
+
+static inline void darray_free(struct darray *dst)
+{
+	bfree(dst->array);
+	darray_init(dst);
+}
+
+static inline void *darray_item(const size_t element_size,
+				const struct darray *da, size_t idx)
+{
+	return (void *)(((uint8_t *)da->array) + element_size * idx);
+}
+
+static inline void *darray_end(const size_t element_size,
+			       const struct darray *da)
+{
+	if (!da->num)
+		return NULL;
+	return darray_item(element_size, da, da->num - 1);
+}
+
+static inline void darray_reserve(const size_t element_size,
+				  struct darray *dst, const size_t capacity)
+{
+	if (capacity == 0 || capacity <= dst->capacity)
+		return;
+
+	void *ptr = bmalloc(element_size * capacity);
+	if (dst->array) {
+		if (dst->num)
+			memcpy(ptr, dst->array, element_size * dst->num);
+		bfree(dst->array);
+	}
+	dst->array = ptr;
+	dst->capacity = capacity;
+}
+
+static inline void darray_ensure_capacity(const size_t element_size,
+					  struct darray *dst,
+					  const size_t new_size)
+{
+	if (new_size <= dst->capacity)
+		return;
+
+	size_t new_cap = (!dst->capacity) ? new_size : dst->capacity * 2;
+	if (new_size > new_cap)
+		new_cap = new_size;
+
+	// like libobs, the callers may have counted the new items already
+	void *ptr = bmalloc(element_size * new_cap);
+	if (dst->array) {
+		if (dst->capacity)
+			memcpy(ptr, dst->array, element_size * dst->capacity);
+		bfree(dst->array);
+	}
+	dst->array = ptr;
+	dst->capacity = new_cap;
+}
+
+static inline void darray_resize(const size_t element_size,
+				 struct darray *dst, const size_t size)
+{
+	if (size == dst->num)
+		return;
+	if (size == 0) {
+		dst->num = 0;
+		return;
+	}
+
+	bool b_clear = size > dst->num;
+	size_t old_num = dst->num;
+	darray_ensure_capacity(element_size, dst, size);
+	dst->num = size;
+	if (b_clear)
+		memset(darray_item(element_size, dst, old_num), 0,
+		       element_size * (dst->num - old_num));
+}
+
+static inline void darray_copy(const size_t element_size, struct darray *dst,
+			       const struct darray *da)
+{
+	if (da->num == 0) {
+		darray_free(dst);
+		return;
+	}
+	darray_resize(element_size, dst, da->num);
+	memcpy(dst->array, da->array, element_size * da->num);
+}
+
+static inline void darray_move(struct darray *dst, struct darray *src)
+{
+	darray_free(dst);
+	memcpy(dst, src, sizeof(struct darray));
+	src->array = NULL;
+	src->capacity = 0;
+	src->num = 0;
+}
+
+static inline size_t darray_find(const size_t element_size,
+				 const struct darray *da, const void *item,
+				 const size_t idx)
+{
+	for (size_t i = idx; i < da->num; i++) {
+		void *compare = darray_item(element_size, da, i);
+		if (memcmp(compare, item, element_size) == 0)
+			return i;
+	}
+	return DARRAY_INVALID;
+}
+
+static inline size_t darray_push_back(const size_t element_size,
+				      struct darray *dst, const void *item)
+{
+	darray_ensure_capacity(element_size, dst, ++dst->num);
+	memcpy(darray_end(element_size, dst), item, element_size);
+	return dst->num - 1;
+}
+
+static inline void *darray_push_back_new(const size_t element_size,
+					 struct darray *dst)
+{
+	darray_ensure_capacity(element_size, dst, ++dst->num);
+	void *last = darray_end(element_size, dst);
+	memset(last, 0, element_size);
+	return last;
+}
+
+static inline size_t darray_push_back_array(const size_t element_size,
+					    struct darray *dst,
+					    const void *array, const size_t num)
+{
+	if (!array || !num)
+		return dst->num;
+
+	size_t old_num = dst->num;
+	darray_resize(element_size, dst, dst->num + num);
+	memcpy(darray_item(element_size, dst, old_num), array,
+	       element_size * num);
+	return old_num;
+}
+
+static inline void darray_insert(const size_t element_size,
+				 struct darray *dst, const size_t idx,
+				 const void *item)
+{
+	assert(idx <= dst->num);
+	if (idx == dst->num) {
+		darray_push_back(element_size, dst, item);
+		return;
+	}
+
+	size_t move_count = dst->num - idx;
+	darray_ensure_capacity(element_size, dst, ++dst->num);
+	void *new_item = darray_item(element_size, dst, idx);
+	memmove(darray_item(element_size, dst, idx + 1), new_item,
+		move_count * element_size);
+	memcpy(new_item, item, element_size);
+}
+
+static inline void darray_erase(const size_t element_size, struct darray *dst,
+				const size_t idx)
+{
+	assert(idx < dst->num);
+	if (idx >= dst->num || !--dst->num)
+		return;
+
+	memmove(darray_item(element_size, dst, idx),
+		darray_item(element_size, dst, idx + 1),
+		element_size * (dst->num - idx));
+}
+
+static inline void darray_erase_item(const size_t element_size,
+				     struct darray *dst, const void *item)
+{
+	size_t idx = darray_find(element_size, dst, item, 0);
+	if (idx != DARRAY_INVALID)
+		darray_erase(element_size, dst, idx);
+}
+
+static inline void darray_erase_range(const size_t element_size,
+				      struct darray *dst, const size_t start,
+				      const size_t end)
+{
+	assert(start <= dst->num && end <= dst->num && end > start);
+	size_t count = end - start;
+	if (count == 1) {
+		darray_erase(element_size, dst, start);
+		return;
+	} else if (count == dst->num) {
+		dst->num = 0;
+		return;
+	}
+
+	size_t move_count = dst->num - end;
+	if (move_count)
+		memmove(darray_item(element_size, dst, start),
+			darray_item(element_size, dst, end),
+			move_count * element_size);
+	dst->num -= count;
+}
+
+static inline void darray_pop_back(const size_t element_size,
+				   struct darray *dst)
+{
+	assert(dst->num != 0);
+	if (dst->num)
+		darray_erase(element_size, dst, dst->num - 1);
+}
+
+static inline void darray_move_item(const size_t element_size,
+				    struct darray *dst, const size_t from,
+				    const size_t to)
+{
+	if (from == to)
+		return;
+
+	void *temp = malloc(element_size);
+	void *p_from = darray_item(element_size, dst, from);
+	void *p_to = darray_item(element_size, dst, to);
+
+	memcpy(temp, p_from, element_size);
+	if (to < from)
+		memmove(darray_item(element_size, dst, to + 1), p_to,
+			element_size * (from - to));
+	else
+		memmove(p_from, darray_item(element_size, dst, from + 1),
+			element_size * (to - from));
+	memcpy(p_to, temp, element_size);
+	free(temp);
+}
+
+#define da_init(v) darray_init(&(v).da)
+#define da_free(v) darray_free(&(v).da)
+#define da_end(v) darray_end(sizeof(*(v).array), &(v).da)
+#define da_reserve(v, capacity) \
+	darray_reserve(sizeof(*(v).array), &(v).da, capacity)
+#define da_resize(v, size) darray_resize(sizeof(*(v).array), &(v).da, size)
+#define da_copy(dst, src) \
+	darray_copy(sizeof(*(dst).array), &(dst).da, &(src).da)
+#define da_move(dst, src) darray_move(&(dst).da, &(src).da)
+#define da_find(v, item, idx) \
+	darray_find(sizeof(*(v).array), &(v).da, item, idx)
+#define da_push_back(v, item) \
+	darray_push_back(sizeof(*(v).array), &(v).da, item)
+#define da_push_back_new(v) darray_push_back_new(sizeof(*(v).array), &(v).da)
+#define da_push_back_array(dst, src_array, n) \
+	darray_push_back_array(sizeof(*(dst).array), &(dst).da, src_array, n)
+#define da_insert(v, idx, item) \
+	darray_insert(sizeof(*(v).array), &(v).da, idx, item)
+#define da_erase(dst, idx) darray_erase(sizeof(*(dst).array), &(dst).da, idx)
+#define da_erase_item(dst, item) \
+	darray_erase_item(sizeof(*(dst).array), &(dst).da, item)
+#define da_erase_range(dst, from, to) \
+	darray_erase_range(sizeof(*(dst).array), &(dst).da, from, to)
+#define da_move_item(v, from, to) \
+	darray_move_item(sizeof(*(v).array), &(v).da, from, to)
+#define da_pop_back(dst) darray_pop_back(sizeof(*(dst).array), &(dst).da)
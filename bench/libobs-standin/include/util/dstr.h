@@ -0,0 +1,68 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <string.h>
+#include "c99defs.h"
+#include "bmem.h"
+
+/* The parts of libobs' util/dstr.h that the plugin uses */
+
+struct dstr {
+	char *array;
+	size_t len; // number of characters, excluding null terminator
+	size_t capacity;
+};
+
+static inline void dstr_init(struct dstr *dst)
+{
+	dst->array = NULL;
+	dst->len = 0;
+	dst->capacity = 0;
+}
+
+static inline bool dstr_is_empty(const struct dstr *str)
+{
+	return !str->array || !str->len || !*str->array;
+}
+
+static inline char *dstr_find(const struct dstr *str, const char *find)
+{
+	return str->array ? strstr(str->array, find) : NULL;
+}
+
+extern void dstr_free(struct dstr *dst);
+extern void dstr_ensure_capacity(struct dstr *dst, const size_t new_size);
+extern void dstr_resize(struct dstr *dst, const size_t num);
+extern void dstr_copy(struct dstr *dst, const char *array);
+extern void dstr_ncopy(struct dstr *dst, const char *array, const size_t len);
+extern void dstr_cat(struct dstr *dst, const char *array);
+extern void dstr_ncat(struct dstr *dst, const char *array, const size_t len);
+extern void dstr_cat_ch(struct dstr *dst, char ch);
+extern void dstr_insert(struct dstr *dst, const size_t idx,
+			const char *array);
+extern void dstr_printf(struct dstr *dst, const char *format, ...)
+	PRINTFATTR(2, 3);
+extern void dstr_catf(struct dstr *dst, const char *format, ...)
+	PRINTFATTR(2, 3);
+extern void dstr_vprintf(struct dstr *dst, const char *format, va_list args);
+extern void dstr_vcatf(struct dstr *dst, const char *format, va_list args);
+
+extern int astrcmpi(const char *str1, const char *str2);
+extern int astrcmpi_n(const char *str1, const char *str2, size_t n);
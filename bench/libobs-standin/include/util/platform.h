@@ -0,0 +1,44 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <stdio.h>
+#include <sys/stat.h>
+#include "c99defs.h"
+
+#define MKDIR_EXISTS 1
+#define MKDIR_SUCCESS 0
+#define MKDIR_ERROR -1
+
+extern uint64_t os_gettime_ns(void);
+extern void os_sleep_ms(uint32_t duration);
+extern bool os_sleepto_ns(uint64_t time_target);
+
+extern FILE *os_fopen(const char *path, const char *mode);
+extern int os_stat(const char *file, struct stat *st);
+extern int os_mkdir(const char *path);
+extern int os_mkdirs(const char *path);
+extern bool os_file_exists(const char *path);
+extern int os_unlink(const char *path);
+extern int os_rename(const char *old_path, const char *new_path);
+
+/* Returns a bmalloc'd string, NULL if the file can't be read */
+extern char *os_quick_read_utf8_file(const char *path);
+extern bool os_quick_write_utf8_file(const char *path, const char *str,
+				     size_t len, bool marker);
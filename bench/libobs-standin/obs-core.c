@@ -0,0 +1,625 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <obs-module.h>
+#include <standin.h>
+#include <util/platform.h>
+#include "standin-internal.h"
+
+struct registered_type {
+	struct obs_source_info info;
+	char *id; // owned for the generic types
+};
+
+struct task {
+	obs_task_t task;
+	void *param;
+};
+
+struct tick_callback {
+	void (*tick)(void *param, float seconds);
+	void *param;
+	bool remove;
+};
+
+struct event_callback {
+	obs_frontend_event_cb callback;
+	void *private_data;
+};
+
+struct save_callback {
+	obs_frontend_save_cb callback;
+	void *private_data;
+};
+
+typedef DARRAY(struct task) task_queue_t;
+
+static struct {
+	signal_handler_t *signals;
+	proc_handler_t *procs;
+
+	pthread_mutex_t sources_mutex;
+	DARRAY(obs_source_t *) sources;
+	DARRAY(struct registered_type *) types;
+
+	task_queue_t ui_tasks;
+	task_queue_t graphics_tasks;
+	DARRAY(struct tick_callback) tick_callbacks;
+	long ticking;
+
+	DARRAY(struct event_callback) event_callbacks;
+	DARRAY(struct save_callback) save_callbacks;
+	obs_weak_source_t *current_scene;
+	obs_weak_source_t *preview_scene;
+	config_t *global_config;
+	struct dstr config_dir;
+
+	standin_timer_cb timer;
+	void *timer_param;
+	long timer_depth;
+} core;
+
+/* ------------------------------------------------------------------------- */
+/* timing */
+
+void standin_set_timer(standin_timer_cb callback, void *param)
+{
+	core.timer = callback;
+	core.timer_param = param;
+}
+
+uint64_t standin_timer_begin(void)
+{
+	return core.timer_depth++ == 0 ? os_gettime_ns() : 0;
+}
+
+void standin_timer_end(const char *what, uint64_t start)
+{
+	if (--core.timer_depth == 0 && core.timer)
+		core.timer(what, os_gettime_ns() - start, core.timer_param);
+}
+
+/* ------------------------------------------------------------------------- */
+/* sources */
+
+void standin_sources_lock(void)
+{
+	pthread_mutex_lock(&core.sources_mutex);
+}
+
+void standin_sources_unlock(void)
+{
+	pthread_mutex_unlock(&core.sources_mutex);
+}
+
+void standin_source_created(obs_source_t *source)
+{
+	standin_sources_lock();
+	da_push_back(core.sources, &source);
+	standin_sources_unlock();
+}
+
+void standin_source_destroyed(obs_source_t *source)
+{
+	standin_sources_lock();
+	da_erase_item(core.sources, &source);
+	standin_sources_unlock();
+}
+
+size_t standin_source_count(void)
+{
+	return core.sources.num;
+}
+
+obs_source_t *standin_source_at(size_t idx)
+{
+	return core.sources.array[idx];
+}
+
+/* References the sources first, the callback may create or release some */
+static void enum_sources(bool (*enum_proc)(void *, obs_source_t *),
+			 void *param, bool scenes)
+{
+	DARRAY(obs_source_t *) sources;
+	da_init(sources);
+
+	standin_sources_lock();
+	for (size_t i = 0; i < core.sources.num; i++) {
+		obs_source_t *source = core.sources.array[i];
+		enum obs_source_type type = obs_source_get_type(source);
+		bool wanted = scenes ? type == OBS_SOURCE_TYPE_SCENE
+				     : type == OBS_SOURCE_TYPE_INPUT;
+		if (!wanted || source->is_private || source->removed)
+			continue;
+
+		source = obs_source_get_ref(source);
+		if (source)
+			da_push_back(sources, &source);
+	}
+	standin_sources_unlock();
+
+	size_t i = 0;
+	for (; i < sources.num; i++) {
+		if (!enum_proc(param, sources.array[i]))
+			break;
+	}
+	for (i = 0; i < sources.num; i++)
+		obs_source_release(sources.array[i]);
+	da_free(sources);
+}
+
+void obs_enum_sources(bool (*enum_proc)(void *, obs_source_t *), void *param)
+{
+	enum_sources(enum_proc, param, false);
+}
+
+void obs_enum_scenes(bool (*enum_proc)(void *, obs_source_t *), void *param)
+{
+	enum_sources(enum_proc, param, true);
+}
+
+obs_source_t *obs_get_source_by_name(const char *name)
+{
+	obs_source_t *found = NULL;
+	if (!name)
+		return NULL;
+
+	standin_sources_lock();
+	for (size_t i = 0; i < core.sources.num && !found; i++) {
+		obs_source_t *source = core.sources.array[i];
+		if (!source->is_private && !source->removed &&
+		    strcmp(source->name, name) == 0)
+			found = obs_source_get_ref(source);
+	}
+	standin_sources_unlock();
+	return found;
+}
+
+signal_handler_t *obs_get_signal_handler(void)
+{
+	return core.signals;
+}
+
+proc_handler_t *obs_get_proc_handler(void)
+{
+	return core.procs;
+}
+
+/* ------------------------------------------------------------------------- */
+/* types */
+
+void obs_register_source(struct obs_source_info *info)
+{
+	if (!info || !info->id || standin_find_type(info->id)) {
+		blog(LOG_ERROR, "Tried to register a source type twice");
+		return;
+	}
+
+	struct registered_type *type = bzalloc(sizeof(*type));
+	type->info = *info;
+	da_push_back(core.types, &type);
+}
+
+const struct obs_source_info *standin_find_type(const char *id)
+{
+	for (size_t i = 0; id && i < core.types.num; i++) {
+		struct registered_type *type = core.types.array[i];
+		if (strcmp(type->info.id, id) == 0)
+			return &type->info;
+	}
+	return NULL;
+}
+
+struct generic_input {
+	uint64_t ticks;
+};
+
+static void *generic_input_create(obs_data_t *settings, obs_source_t *source)
+{
+	UNUSED_PARAMETER(settings);
+	UNUSED_PARAMETER(source);
+	return bzalloc(sizeof(struct generic_input));
+}
+
+static void generic_input_destroy(void *data)
+{
+	bfree(data);
+}
+
+static uint32_t generic_input_width(void *data)
+{
+	struct generic_input *input = data;
+	return input->ticks ? 1920 : 0;
+}
+
+static uint32_t generic_input_height(void *data)
+{
+	struct generic_input *input = data;
+	return input->ticks ? 1080 : 0;
+}
+
+static void generic_input_tick(void *data, float seconds)
+{
+	UNUSED_PARAMETER(seconds);
+	struct generic_input *input = data;
+	input->ticks++;
+}
+
+static uint32_t scene_size(void *data)
+{
+	UNUSED_PARAMETER(data);
+	return 1920;
+}
+
+static void register_type(const char *id, enum obs_source_type type,
+			  uint32_t output_flags)
+{
+	if (standin_find_type(id)) {
+		blog(LOG_ERROR, "Tried to register a source type twice");
+		return;
+	}
+
+	struct registered_type *registered = bzalloc(sizeof(*registered));
+	struct obs_source_info *info = &registered->info;
+	registered->id = bstrdup(id);
+	info->id = registered->id;
+	info->type = type;
+	info->output_flags = output_flags;
+
+	if (type == OBS_SOURCE_TYPE_INPUT) {
+		info->create = generic_input_create;
+		info->destroy = generic_input_destroy;
+		if (output_flags & OBS_SOURCE_VIDEO) {
+			info->get_width = generic_input_width;
+			info->get_height = generic_input_height;
+			info->video_tick = generic_input_tick;
+		}
+	} else if (type == OBS_SOURCE_TYPE_SCENE) {
+		info->get_width = scene_size;
+		info->get_height = scene_size;
+	}
+	da_push_back(core.types, &registered);
+}
+
+void standin_register_input(const char *id, uint32_t output_flags)
+{
+	register_type(id, OBS_SOURCE_TYPE_INPUT, output_flags);
+}
+
+void standin_register_filter(const char *id, uint32_t output_flags)
+{
+	register_type(id, OBS_SOURCE_TYPE_FILTER, output_flags);
+}
+
+void standin_register_transition(const char *id)
+{
+	register_type(id, OBS_SOURCE_TYPE_TRANSITION, OBS_SOURCE_VIDEO);
+}
+
+bool standin_type_registered(const char *id, enum obs_source_type *type)
+{
+	const struct obs_source_info *info = standin_find_type(id);
+	if (info && type)
+		*type = info->type;
+	return info != NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/* tasks and ticks */
+
+static void run_task(const struct task *task, const char *what)
+{
+	uint64_t start = standin_timer_begin();
+	task->task(task->param);
+	standin_timer_end(what, start);
+}
+
+void obs_queue_task(enum obs_task_type type, obs_task_t task, void *param,
+		    bool wait)
+{
+	struct task queued = {task, param};
+	if (wait)
+		run_task(&queued, "task");
+	else if (type == OBS_TASK_UI)
+		da_push_back(core.ui_tasks, &queued);
+	else
+		da_push_back(core.graphics_tasks, &queued);
+}
+
+size_t standin_run_ui_tasks(void)
+{
+	size_t count = 0;
+	while (core.ui_tasks.num) {
+		struct task task = core.ui_tasks.array[0];
+		da_erase(core.ui_tasks, 0);
+		run_task(&task, "ui_task");
+		count++;
+	}
+	return count;
+}
+
+void obs_add_tick_callback(void (*tick)(void *param, float seconds),
+			   void *param)
+{
+	struct tick_callback callback = {tick, param, false};
+	da_push_back(core.tick_callbacks, &callback);
+}
+
+void obs_remove_tick_callback(void (*tick)(void *param, float seconds),
+			      void *param)
+{
+	for (size_t i = 0; i < core.tick_callbacks.num; i++) {
+		struct tick_callback *callback = &core.tick_callbacks.array[i];
+		if (callback->tick != tick || callback->param != param)
+			continue;
+
+		// erased once the frame is done
+		if (core.ticking)
+			callback->remove = true;
+		else
+			da_erase(core.tick_callbacks, i);
+		return;
+	}
+}
+
+void standin_tick(float seconds)
+{
+	// tasks queued while running these wait for the next frame
+	task_queue_t tasks;
+	da_init(tasks);
+	da_move(tasks, core.graphics_tasks);
+	for (size_t i = 0; i < tasks.num; i++)
+		run_task(&tasks.array[i], "graphics_task");
+	da_free(tasks);
+
+	core.ticking++;
+	size_t num = core.tick_callbacks.num;
+	for (size_t i = 0; i < num; i++) {
+		struct tick_callback callback = core.tick_callbacks.array[i];
+		if (callback.remove)
+			continue;
+
+		uint64_t start = standin_timer_begin();
+		callback.tick(callback.param, seconds);
+		standin_timer_end("tick", start);
+	}
+	if (--core.ticking == 0) {
+		for (size_t i = core.tick_callbacks.num; i > 0; i--) {
+			if (core.tick_callbacks.array[i - 1].remove)
+				da_erase(core.tick_callbacks, i - 1);
+		}
+	}
+
+	DARRAY(obs_source_t *) sources;
+	da_init(sources);
+	standin_sources_lock();
+	for (size_t i = 0; i < core.sources.num; i++) {
+		obs_source_t *source = core.sources.array[i];
+		source = obs_source_get_ref(source);
+		if (source)
+			da_push_back(sources, &source);
+	}
+	standin_sources_unlock();
+
+	for (size_t i = 0; i < sources.num; i++) {
+		obs_source_t *source = sources.array[i];
+		if (source->info && source->info->video_tick)
+			source->info->video_tick(source->data, seconds);
+		source->ticks++;
+		obs_source_release(source);
+	}
+	da_free(sources);
+}
+
+/* ------------------------------------------------------------------------- */
+/* frontend */
+
+void obs_frontend_add_event_callback(obs_frontend_event_cb callback,
+				     void *private_data)
+{
+	struct event_callback cb = {callback, private_data};
+	da_push_back(core.event_callbacks, &cb);
+}
+
+void obs_frontend_remove_event_callback(obs_frontend_event_cb callback,
+					void *private_data)
+{
+	struct event_callback cb = {callback, private_data};
+	da_erase_item(core.event_callbacks, &cb);
+}
+
+void obs_frontend_add_save_callback(obs_frontend_save_cb callback,
+				    void *private_data)
+{
+	struct save_callback cb = {callback, private_data};
+	da_push_back(core.save_callbacks, &cb);
+}
+
+void obs_frontend_remove_save_callback(obs_frontend_save_cb callback,
+				       void *private_data)
+{
+	struct save_callback cb = {callback, private_data};
+	da_erase_item(core.save_callbacks, &cb);
+}
+
+void standin_frontend_event(enum obs_frontend_event event)
+{
+	for (size_t i = 0; i < core.event_callbacks.num; i++) {
+		struct event_callback cb = core.event_callbacks.array[i];
+		uint64_t start = standin_timer_begin();
+		cb.callback(event, cb.private_data);
+		standin_timer_end("frontend_event", start);
+	}
+}
+
+void standin_frontend_save(obs_data_t *save_data, bool saving)
+{
+	for (size_t i = 0; i < core.save_callbacks.num; i++) {
+		struct save_callback cb = core.save_callbacks.array[i];
+		uint64_t start = standin_timer_begin();
+		cb.callback(save_data, saving, cb.private_data);
+		standin_timer_end("frontend_save", start);
+	}
+}
+
+static bool add_scene(void *param, obs_source_t *scene)
+{
+	struct obs_frontend_source_list *sources = param;
+	obs_source_t *ref = obs_source_get_ref(scene);
+	da_push_back(sources->sources, &ref);
+	return true;
+}
+
+void obs_frontend_get_scenes(struct obs_frontend_source_list *sources)
+{
+	obs_enum_scenes(add_scene, sources);
+}
+
+obs_source_t *standin_current_scene(void)
+{
+	return core.current_scene ? core.current_scene->source : NULL;
+}
+
+obs_source_t *standin_preview_scene(void)
+{
+	return core.preview_scene ? core.preview_scene->source : NULL;
+}
+
+obs_source_t *obs_frontend_get_current_scene(void)
+{
+	return obs_weak_source_get_source(core.current_scene);
+}
+
+obs_source_t *obs_frontend_get_current_preview_scene(void)
+{
+	return obs_weak_source_get_source(core.preview_scene);
+}
+
+bool obs_frontend_preview_program_mode_active(void)
+{
+	return core.preview_scene != NULL;
+}
+
+config_t *obs_frontend_get_global_config(void)
+{
+	return core.global_config;
+}
+
+void standin_set_current_scene(obs_source_t *scene)
+{
+	obs_weak_source_release(core.current_scene);
+	core.current_scene = obs_source_get_weak_source(scene);
+	standin_frontend_event(OBS_FRONTEND_EVENT_SCENE_CHANGED);
+}
+
+void standin_set_preview_scene(obs_source_t *scene)
+{
+	bool was_active = core.preview_scene != NULL;
+	obs_weak_source_release(core.preview_scene);
+	core.preview_scene = obs_source_get_weak_source(scene);
+
+	if (!was_active && scene)
+		standin_frontend_event(OBS_FRONTEND_EVENT_STUDIO_MODE_ENABLED);
+	else if (was_active && !scene)
+		standin_frontend_event(OBS_FRONTEND_EVENT_STUDIO_MODE_DISABLED);
+	if (scene)
+		standin_frontend_event(
+			OBS_FRONTEND_EVENT_PREVIEW_SCENE_CHANGED);
+}
+
+void standin_select_scenes(obs_source_t *program, obs_source_t *preview)
+{
+	obs_weak_source_release(core.current_scene);
+	obs_weak_source_release(core.preview_scene);
+	core.current_scene = obs_source_get_weak_source(program);
+	core.preview_scene = obs_source_get_weak_source(preview);
+}
+
+/* ------------------------------------------------------------------------- */
+/* module */
+
+const char *obs_module_text(const char *lookup)
+{
+	return lookup;
+}
+
+char *obs_module_config_path(const char *file)
+{
+	struct dstr path = {0};
+	dstr_copy(&path, core.config_dir.array);
+	if (file && *file) {
+		dstr_cat(&path, "/");
+		dstr_cat(&path, file);
+	}
+	return path.array;
+}
+
+void standin_set_config_dir(const char *path)
+{
+	dstr_copy(&core.config_dir, path);
+}
+
+/* ------------------------------------------------------------------------- */
+/* startup and shutdown */
+
+void standin_startup(void)
+{
+	core.signals = signal_handler_create();
+	core.procs = proc_handler_create();
+	pthread_mutex_init_recursive(&core.sources_mutex);
+	core.global_config = config_create();
+	dstr_copy(&core.config_dir, "standin-config");
+
+	register_type("scene", OBS_SOURCE_TYPE_SCENE,
+		      OBS_SOURCE_VIDEO | OBS_SOURCE_CUSTOM_DRAW |
+			      OBS_SOURCE_COMPOSITE);
+}
+
+long standin_shutdown(void)
+{
+	obs_weak_source_release(core.current_scene);
+	obs_weak_source_release(core.preview_scene);
+	core.current_scene = NULL;
+	core.preview_scene = NULL;
+
+	standin_run_ui_tasks();
+	standin_tick(0.0f);
+	if (core.sources.num)
+		blog(LOG_WARNING, "%zu sources weren't released",
+		     core.sources.num);
+	da_free(core.sources);
+
+	for (size_t i = 0; i < core.types.num; i++) {
+		bfree(core.types.array[i]->id);
+		bfree(core.types.array[i]);
+	}
+	da_free(core.types);
+	da_free(core.ui_tasks);
+	da_free(core.graphics_tasks);
+	da_free(core.tick_callbacks);
+	da_free(core.event_callbacks);
+	da_free(core.save_callbacks);
+
+	config_close(core.global_config);
+	dstr_free(&core.config_dir);
+	signal_handler_destroy(core.signals);
+	proc_handler_destroy(core.procs);
+	pthread_mutex_destroy(&core.sources_mutex);
+	memset(&core, 0, sizeof(core));
+	return bnum_allocs();
+}
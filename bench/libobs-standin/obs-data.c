@@ -0,0 +1,862 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <obs-data.h>
+#include <util/base.h>
+#include <util/bmem.h>
+#include <util/darray.h>
+#include <util/dstr.h>
+#include <util/platform.h>
+#include <util/threading.h>
+
+struct data_value {
+	enum obs_data_type type;
+	union {
+		char *str;
+		struct {
+			double d;
+			long long i;
+			bool is_int;
+		} num;
+		bool b;
+		obs_data_t *obj;
+		obs_data_array_t *array;
+	};
+};
+
+struct obs_data_item {
+	obs_data_t *parent;
+	char *name;
+	bool has_user;
+	bool has_default;
+	struct data_value user;
+	struct data_value def;
+	struct obs_data_item *next;
+};
+
+struct obs_data {
+	volatile long refs;
+	struct obs_data_item *first;
+	char *json;
+};
+
+struct obs_data_array {
+	volatile long refs;
+	DARRAY(obs_data_t *) objects;
+};
+
+static void value_free(struct data_value *value)
+{
+	if (value->type == OBS_DATA_STRING)
+		bfree(value->str);
+	else if (value->type == OBS_DATA_OBJECT)
+		obs_data_release(value->obj);
+	else if (value->type == OBS_DATA_ARRAY)
+		obs_data_array_release(value->array);
+	memset(value, 0, sizeof(*value));
+}
+
+static void value_copy(struct data_value *dst, const struct data_value *src)
+{
+	*dst = *src;
+	if (src->type == OBS_DATA_STRING)
+		dst->str = bstrdup(src->str);
+	else if (src->type == OBS_DATA_OBJECT)
+		obs_data_addref(src->obj);
+	else if (src->type == OBS_DATA_ARRAY)
+		obs_data_array_addref(src->array);
+}
+
+static void item_free(struct obs_data_item *item)
+{
+	value_free(&item->user);
+	value_free(&item->def);
+	bfree(item->name);
+	bfree(item);
+}
+
+obs_data_t *obs_data_create(void)
+{
+	obs_data_t *data = bzalloc(sizeof(*data));
+	data->refs = 1;
+	return data;
+}
+
+void obs_data_addref(obs_data_t *data)
+{
+	if (data)
+		os_atomic_inc_long(&data->refs);
+}
+
+void obs_data_release(obs_data_t *data)
+{
+	if (!data || os_atomic_dec_long(&data->refs) > 0)
+		return;
+
+	struct obs_data_item *item = data->first;
+	while (item) {
+		struct obs_data_item *next = item->next;
+		item_free(item);
+		item = next;
+	}
+	bfree(data->json);
+	bfree(data);
+}
+
+static struct obs_data_item *find_item(obs_data_t *data, const char *name)
+{
+	if (!data || !name)
+		return NULL;
+
+	for (struct obs_data_item *item = data->first; item;
+	     item = item->next) {
+		if (strcmp(item->name, name) == 0)
+			return item;
+	}
+	return NULL;
+}
+
+/* Items keep the order they were added in, like libobs */
+static struct obs_data_item *get_item(obs_data_t *data, const char *name,
+				      enum obs_data_type type)
+{
+	struct obs_data_item *item = find_item(data, name);
+	if (item && item->user.type != type && item->def.type != type) {
+		// a value of another type replaces the item's values
+		value_free(&item->user);
+		value_free(&item->def);
+		item->has_user = false;
+		item->has_default = false;
+	}
+	if (item)
+		return item;
+
+	item = bzalloc(sizeof(*item));
+	item->parent = data;
+	item->name = bstrdup(name);
+	struct obs_data_item **last = &data->first;
+	while (*last)
+		last = &(*last)->next;
+	*last = item;
+	return item;
+}
+
+static void set_value(obs_data_t *data, const char *name,
+		      const struct data_value *value, bool is_default)
+{
+	if (!data || !name)
+		return;
+
+	struct obs_data_item *item = get_item(data, name, value->type);
+	struct data_value *dst = is_default ? &item->def : &item->user;
+	value_free(dst);
+	value_copy(dst, value);
+	if (is_default)
+		item->has_default = true;
+	else
+		item->has_user = true;
+}
+
+static const struct data_value *get_value(obs_data_t *data, const char *name,
+					  enum obs_data_type type)
+{
+	struct obs_data_item *item = find_item(data, name);
+	if (!item)
+		return NULL;
+	if (item->has_user && item->user.type == type)
+		return &item->user;
+	if (item->has_default && item->def.type == type)
+		return &item->def;
+	return NULL;
+}
+
+void obs_data_set_string(obs_data_t *data, const char *name, const char *val)
+{
+	struct data_value value = {.type = OBS_DATA_STRING};
+	value.str = (char *)(val ? val : "");
+	set_value(data, name, &value, false);
+}
+
+void obs_data_set_int(obs_data_t *data, const char *name, long long val)
+{
+	struct data_value value = {.type = OBS_DATA_NUMBER};
+	value.num.i = val;
+	value.num.d = (double)val;
+	value.num.is_int = true;
+	set_value(data, name, &value, false);
+}
+
+void obs_data_set_double(obs_data_t *data, const char *name, double val)
+{
+	struct data_value value = {.type = OBS_DATA_NUMBER};
+	value.num.i = (long long)val;
+	value.num.d = val;
+	set_value(data, name, &value, false);
+}
+
+void obs_data_set_bool(obs_data_t *data, const char *name, bool val)
+{
+	struct data_value value = {.type = OBS_DATA_BOOLEAN};
+	value.b = val;
+	set_value(data, name, &value, false);
+}
+
+void obs_data_set_obj(obs_data_t *data, const char *name, obs_data_t *obj)
+{
+	struct data_value value = {.type = OBS_DATA_OBJECT};
+	value.obj = obj;
+	set_value(data, name, &value, false);
+}
+
+void obs_data_set_array(obs_data_t *data, const char *name,
+			obs_data_array_t *array)
+{
+	struct data_value value = {.type = OBS_DATA_ARRAY};
+	value.array = array;
+	set_value(data, name, &value, false);
+}
+
+void obs_data_set_vec2(obs_data_t *data, const char *name,
+		       const struct vec2 *val)
+{
+	obs_data_t *obj = obs_data_create();
+	obs_data_set_double(obj, "x", val->x);
+	obs_data_set_double(obj, "y", val->y);
+	obs_data_set_obj(data, name, obj);
+	obs_data_release(obj);
+}
+
+void obs_data_set_default_string(obs_data_t *data, const char *name,
+				 const char *val)
+{
+	struct data_value value = {.type = OBS_DATA_STRING};
+	value.str = (char *)(val ? val : "");
+	set_value(data, name, &value, true);
+}
+
+void obs_data_set_default_int(obs_data_t *data, const char *name,
+			      long long val)
+{
+	struct data_value value = {.type = OBS_DATA_NUMBER};
+	value.num.i = val;
+	value.num.d = (double)val;
+	value.num.is_int = true;
+	set_value(data, name, &value, true);
+}
+
+void obs_data_set_default_double(obs_data_t *data, const char *name,
+				 double val)
+{
+	struct data_value value = {.type = OBS_DATA_NUMBER};
+	value.num.i = (long long)val;
+	value.num.d = val;
+	set_value(data, name, &value, true);
+}
+
+void obs_data_set_default_bool(obs_data_t *data, const char *name, bool val)
+{
+	struct data_value value = {.type = OBS_DATA_BOOLEAN};
+	value.b = val;
+	set_value(data, name, &value, true);
+}
+
+const char *obs_data_get_string(obs_data_t *data, const char *name)
+{
+	const struct data_value *value =
+		get_value(data, name, OBS_DATA_STRING);
+	return value ? value->str : "";
+}
+
+long long obs_data_get_int(obs_data_t *data, const char *name)
+{
+	const struct data_value *value =
+		get_value(data, name, OBS_DATA_NUMBER);
+	if (!value)
+		return 0;
+	return value->num.is_int ? value->num.i : (long long)value->num.d;
+}
+
+double obs_data_get_double(obs_data_t *data, const char *name)
+{
+	const struct data_value *value =
+		get_value(data, name, OBS_DATA_NUMBER);
+	if (!value)
+		return 0.0;
+	return value->num.is_int ? (double)value->num.i : value->num.d;
+}
+
+bool obs_data_get_bool(obs_data_t *data, const char *name)
+{
+	const struct data_value *value =
+		get_value(data, name, OBS_DATA_BOOLEAN);
+	return value ? value->b : false;
+}
+
+obs_data_t *obs_data_get_obj(obs_data_t *data, const char *name)
+{
+	const struct data_value *value =
+		get_value(data, name, OBS_DATA_OBJECT);
+	if (!value || !value->obj)
+		return NULL;
+
+	obs_data_addref(value->obj);
+	return value->obj;
+}
+
+obs_data_array_t *obs_data_get_array(obs_data_t *data, const char *name)
+{
+	const struct data_value *value =
+		get_value(data, name, OBS_DATA_ARRAY);
+	if (!value || !value->array)
+		return NULL;
+
+	obs_data_array_addref(value->array);
+	return value->array;
+}
+
+void obs_data_get_vec2(obs_data_t *data, const char *name, struct vec2 *val)
+{
+	obs_data_t *obj = obs_data_get_obj(data, name);
+	val->x = (float)obs_data_get_double(obj, "x");
+	val->y = (float)obs_data_get_double(obj, "y");
+	obs_data_release(obj);
+}
+
+bool obs_data_has_user_value(obs_data_t *data, const char *name)
+{
+	struct obs_data_item *item = find_item(data, name);
+	return item && item->has_user;
+}
+
+void obs_data_erase(obs_data_t *data, const char *name)
+{
+	if (!data || !name)
+		return;
+
+	struct obs_data_item **link = &data->first;
+	while (*link) {
+		struct obs_data_item *item = *link;
+		if (strcmp(item->name, name) == 0) {
+			*link = item->next;
+			item_free(item);
+			return;
+		}
+		link = &item->next;
+	}
+}
+
+void obs_data_clear(obs_data_t *data)
+{
+	if (!data)
+		return;
+
+	for (struct obs_data_item *item = data->first; item;
+	     item = item->next) {
+		value_free(&item->user);
+		item->has_user = false;
+	}
+}
+
+/* Copies the user values, objects and arrays are shared like in libobs */
+void obs_data_apply(obs_data_t *target, obs_data_t *apply_data)
+{
+	if (!target || !apply_data || target == apply_data)
+		return;
+
+	for (struct obs_data_item *item = apply_data->first; item;
+	     item = item->next) {
+		if (item->has_user)
+			set_value(target, item->name, &item->user, false);
+	}
+}
+
+/* ------------------------------------------------------------------------- */
+/* arrays */
+
+obs_data_array_t *obs_data_array_create(void)
+{
+	obs_data_array_t *array = bzalloc(sizeof(*array));
+	array->refs = 1;
+	return array;
+}
+
+void obs_data_array_addref(obs_data_array_t *array)
+{
+	if (array)
+		os_atomic_inc_long(&array->refs);
+}
+
+void obs_data_array_release(obs_data_array_t *array)
+{
+	if (!array || os_atomic_dec_long(&array->refs) > 0)
+		return;
+
+	for (size_t i = 0; i < array->objects.num; i++)
+		obs_data_release(array->objects.array[i]);
+	da_free(array->objects);
+	bfree(array);
+}
+
+size_t obs_data_array_count(obs_data_array_t *array)
+{
+	return array ? array->objects.num : 0;
+}
+
+obs_data_t *obs_data_array_item(obs_data_array_t *array, size_t idx)
+{
+	if (!array || idx >= array->objects.num)
+		return NULL;
+
+	obs_data_t *data = array->objects.array[idx];
+	obs_data_addref(data);
+	return data;
+}
+
+size_t obs_data_array_push_back(obs_data_array_t *array, obs_data_t *obj)
+{
+	if (!array || !obj)
+		return 0;
+
+	obs_data_addref(obj);
+	return da_push_back(array->objects, &obj);
+}
+
+/* ------------------------------------------------------------------------- */
+/* items */
+
+obs_data_item_t *obs_data_first(obs_data_t *data)
+{
+	if (!data || !data->first)
+		return NULL;
+
+	obs_data_addref(data);
+	return data->first;
+}
+
+bool obs_data_item_next(obs_data_item_t **item)
+{
+	if (!item || !*item)
+		return false;
+
+	struct obs_data_item *next = (*item)->next;
+	if (!next) {
+		obs_data_item_release(item);
+		return false;
+	}
+	*item = next;
+	return true;
+}
+
+void obs_data_item_release(obs_data_item_t **item)
+{
+	if (item && *item) {
+		obs_data_release((*item)->parent);
+		*item = NULL;
+	}
+}
+
+bool obs_data_item_has_user_value(obs_data_item_t *item)
+{
+	return item && item->has_user;
+}
+
+const char *obs_data_item_get_name(obs_data_item_t *item)
+{
+	return item ? item->name : NULL;
+}
+
+enum obs_data_type obs_data_item_gettype(obs_data_item_t *item)
+{
+	if (!item)
+		return OBS_DATA_NULL;
+	return item->has_user ? item->user.type : item->def.type;
+}
+
+/* ------------------------------------------------------------------------- */
+/* json */
+
+static void json_write_data(struct dstr *out, obs_data_t *data);
+
+static void json_write_string(struct dstr *out, const char *str)
+{
+	dstr_cat_ch(out, '"');
+	for (const unsigned char *ch = (const unsigned char *)str; *ch; ch++) {
+		switch (*ch) {
+		case '"':
+			dstr_cat(out, "\\\"");
+			break;
+		case '\\':
+			dstr_cat(out, "\\\\");
+			break;
+		case '\n':
+			dstr_cat(out, "\\n");
+			break;
+		case '\r':
+			dstr_cat(out, "\\r");
+			break;
+		case '\t':
+			dstr_cat(out, "\\t");
+			break;
+		default:
+			if (*ch < 0x20)
+				dstr_catf(out, "\\u%04x", *ch);
+			else
+				dstr_cat_ch(out, (char)*ch);
+		}
+	}
+	dstr_cat_ch(out, '"');
+}
+
+static void json_write_value(struct dstr *out, const struct data_value *value)
+{
+	switch (value->type) {
+	case OBS_DATA_STRING:
+		json_write_string(out, value->str);
+		break;
+	case OBS_DATA_NUMBER:
+		if (value->num.is_int)
+			dstr_catf(out, "%lld", value->num.i);
+		else if (isfinite(value->num.d))
+			dstr_catf(out, "%.17g", value->num.d);
+		else
+			dstr_cat(out, "0");
+		break;
+	case OBS_DATA_BOOLEAN:
+		dstr_cat(out, value->b ? "true" : "false");
+		break;
+	case OBS_DATA_OBJECT:
+		json_write_data(out, value->obj);
+		break;
+	case OBS_DATA_ARRAY:
+		dstr_cat_ch(out, '[');
+		for (size_t i = 0; i < value->array->objects.num; i++) {
+			if (i)
+				dstr_cat_ch(out, ',');
+			json_write_data(out, value->array->objects.array[i]);
+		}
+		dstr_cat_ch(out, ']');
+		break;
+	case OBS_DATA_NULL:
+		dstr_cat(out, "null");
+		break;
+	}
+}
+
+static void json_write_data(struct dstr *out, obs_data_t *data)
+{
+	bool first = true;
+	dstr_cat_ch(out, '{');
+	for (struct obs_data_item *item = data ? data->first : NULL; item;
+	     item = item->next) {
+		if (!item->has_user)
+			continue;
+		if (!first)
+			dstr_cat_ch(out, ',');
+		first = false;
+		json_write_string(out, item->name);
+		dstr_cat_ch(out, ':');
+		json_write_value(out, &item->user);
+	}
+	dstr_cat_ch(out, '}');
+}
+
+const char *obs_data_get_json(obs_data_t *data)
+{
+	if (!data)
+		return NULL;
+
+	struct dstr json = {0};
+	json_write_data(&json, data);
+	bfree(data->json);
+	data->json = json.array;
+	return data->json;
+}
+
+struct json_parser {
+	const char *pos;
+	bool error;
+};
+
+static void json_skip_space(struct json_parser *parser)
+{
+	while (*parser->pos == ' ' || *parser->pos == '\t' ||
+	       *parser->pos == '\n' || *parser->pos == '\r')
+		parser->pos++;
+}
+
+static bool json_expect(struct json_parser *parser, char ch)
+{
+	json_skip_space(parser);
+	if (*parser->pos != ch) {
+		parser->error = true;
+		return false;
+	}
+	parser->pos++;
+	return true;
+}
+
+static void utf8_encode(struct dstr *out, unsigned long cp)
+{
+	if (cp < 0x80) {
+		dstr_cat_ch(out, (char)cp);
+	} else if (cp < 0x800) {
+		dstr_cat_ch(out, (char)(0xC0 | (cp >> 6)));
+		dstr_cat_ch(out, (char)(0x80 | (cp & 0x3F)));
+	} else {
+		dstr_cat_ch(out, (char)(0xE0 | (cp >> 12)));
+		dstr_cat_ch(out, (char)(0x80 | ((cp >> 6) & 0x3F)));
+		dstr_cat_ch(out, (char)(0x80 | (cp & 0x3F)));
+	}
+}
+
+/* Returns a bmalloc'd string */
+static char *json_parse_string(struct json_parser *parser)
+{
+	if (!json_expect(parser, '"'))
+		return NULL;
+
+	struct dstr str = {0};
+	while (*parser->pos && *parser->pos != '"') {
+		char ch = *parser->pos++;
+		if (ch != '\\') {
+			dstr_cat_ch(&str, ch);
+			continue;
+		}
+
+		char esc = *parser->pos++;
+		switch (esc) {
+		case 'n':
+			dstr_cat_ch(&str, '\n');
+			break;
+		case 'r':
+			dstr_cat_ch(&str, '\r');
+			break;
+		case 't':
+			dstr_cat_ch(&str, '\t');
+			break;
+		case 'b':
+			dstr_cat_ch(&str, '\b');
+			break;
+		case 'f':
+			dstr_cat_ch(&str, '\f');
+			break;
+		case 'u': {
+			char hex[5] = {0};
+			for (int i = 0; i < 4 && *parser->pos; i++)
+				hex[i] = *parser->pos++;
+			utf8_encode(&str, strtoul(hex, NULL, 16));
+			break;
+		}
+		case 0:
+			parser->error = true;
+			dstr_free(&str);
+			return NULL;
+		default:
+			dstr_cat_ch(&str, esc);
+		}
+	}
+	if (*parser->pos != '"') {
+		parser->error = true;
+		dstr_free(&str);
+		return NULL;
+	}
+	parser->pos++;
+	return str.array ? str.array : bstrdup("");
+}
+
+static obs_data_t *json_parse_object(struct json_parser *parser);
+
+static bool json_parse_value(struct json_parser *parser,
+			     struct data_value *value)
+{
+	json_skip_space(parser);
+	char ch = *parser->pos;
+	memset(value, 0, sizeof(*value));
+
+	if (ch == '"') {
+		value->type = OBS_DATA_STRING;
+		value->str = json_parse_string(parser);
+	} else if (ch == '{') {
+		value->type = OBS_DATA_OBJECT;
+		value->obj = json_parse_object(parser);
+	} else if (ch == '[') {
+		parser->pos++;
+		value->type = OBS_DATA_ARRAY;
+		value->array = obs_data_array_create();
+		json_skip_space(parser);
+		if (*parser->pos == ']') {
+			parser->pos++;
+			return true;
+		}
+		do {
+			obs_data_t *obj = json_parse_object(parser);
+			if (!obj)
+				break;
+			da_push_back(value->array->objects, &obj);
+			json_skip_space(parser);
+		} while (*parser->pos == ',' && parser->pos++);
+		json_expect(parser, ']');
+	} else if (strncmp(parser->pos, "true", 4) == 0) {
+		parser->pos += 4;
+		value->type = OBS_DATA_BOOLEAN;
+		value->b = true;
+	} else if (strncmp(parser->pos, "false", 5) == 0) {
+		parser->pos += 5;
+		value->type = OBS_DATA_BOOLEAN;
+	} else if (strncmp(parser->pos, "null", 4) == 0) {
+		parser->pos += 4;
+		value->type = OBS_DATA_NULL;
+	} else if (ch == '-' || (ch >= '0' && ch <= '9')) {
+		char *end;
+		const char *start = parser->pos;
+		value->type = OBS_DATA_NUMBER;
+		value->num.d = strtod(start, &end);
+		parser->pos = end;
+
+		size_t len = (size_t)(end - start);
+		value->num.is_int = !memchr(start, '.', len) &&
+				    !memchr(start, 'e', len) &&
+				    !memchr(start, 'E', len);
+		value->num.i = value->num.is_int ? strtoll(start, NULL, 10)
+						 : (long long)value->num.d;
+	} else {
+		parser->error = true;
+	}
+	return !parser->error;
+}
+
+static obs_data_t *json_parse_object(struct json_parser *parser)
+{
+	if (!json_expect(parser, '{'))
+		return NULL;
+
+	obs_data_t *data = obs_data_create();
+	json_skip_space(parser);
+	if (*parser->pos == '}') {
+		parser->pos++;
+		return data;
+	}
+
+	do {
+		char *name = json_parse_string(parser);
+		struct data_value value;
+		if (!name || !json_expect(parser, ':') ||
+		    !json_parse_value(parser, &value)) {
+			bfree(name);
+			obs_data_release(data);
+			parser->error = true;
+			return NULL;
+		}
+		if (value.type != OBS_DATA_NULL)
+			set_value(data, name, &value, false);
+		value_free(&value);
+		bfree(name);
+		json_skip_space(parser);
+	} while (*parser->pos == ',' && parser->pos++);
+
+	if (!json_expect(parser, '}')) {
+		obs_data_release(data);
+		return NULL;
+	}
+	return data;
+}
+
+obs_data_t *obs_data_create_from_json(const char *json_string)
+{
+	if (!json_string)
+		return NULL;
+
+	struct json_parser parser = {json_string, false};
+	obs_data_t *data = json_parse_object(&parser);
+	if (!data)
+		blog(LOG_ERROR, "obs-data.c: [obs_data_create_from_json] "
+				"Failed reading json string");
+	return data;
+}
+
+obs_data_t *obs_data_create_from_json_file(const char *json_file)
+{
+	char *file_data = os_quick_read_utf8_file(json_file);
+	obs_data_t *data = NULL;
+	if (file_data && *file_data)
+		data = obs_data_create_from_json(file_data);
+	bfree(file_data);
+	return data;
+}
+
+obs_data_t *obs_data_create_from_json_file_safe(const char *json_file,
+						const char *backup_ext)
+{
+	obs_data_t *data = obs_data_create_from_json_file(json_file);
+	if (!data && backup_ext && *backup_ext) {
+		struct dstr backup_file = {0};
+		dstr_copy(&backup_file, json_file);
+		if (*backup_ext != '.')
+			dstr_cat(&backup_file, ".");
+		dstr_cat(&backup_file, backup_ext);
+
+		data = obs_data_create_from_json_file(backup_file.array);
+		if (data)
+			blog(LOG_WARNING, "Loaded %s from its backup",
+			     json_file);
+		dstr_free(&backup_file);
+	}
+	return data;
+}
+
+bool obs_data_save_json(obs_data_t *data, const char *file)
+{
+	const char *json = obs_data_get_json(data);
+	return json && os_quick_write_utf8_file(file, json, strlen(json),
+						false);
+}
+
+bool obs_data_save_json_safe(obs_data_t *data, const char *file,
+			     const char *temp_ext, const char *backup_ext)
+{
+	const char *json = obs_data_get_json(data);
+	if (!json || !temp_ext || !*temp_ext)
+		return false;
+
+	struct dstr temp_file = {0};
+	dstr_copy(&temp_file, file);
+	if (*temp_ext != '.')
+		dstr_cat(&temp_file, ".");
+	dstr_cat(&temp_file, temp_ext);
+
+	bool success = os_quick_write_utf8_file(temp_file.array, json,
+						strlen(json), false);
+	if (success && backup_ext && *backup_ext && os_file_exists(file)) {
+		struct dstr backup_file = {0};
+		dstr_copy(&backup_file, file);
+		if (*backup_ext != '.')
+			dstr_cat(&backup_file, ".");
+		dstr_cat(&backup_file, backup_ext);
+		os_unlink(backup_file.array);
+		os_rename(file, backup_file.array);
+		dstr_free(&backup_file);
+	}
+	if (success)
+		success = os_rename(temp_file.array, file) == 0;
+
+	dstr_free(&temp_file);
+	return success;
+}
@@ -0,0 +1,227 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <obs-properties.h>
+#include <util/bmem.h>
+#include <util/darray.h>
+
+struct list_item {
+	char *name;
+	char *str;
+	long long val;
+};
+
+struct obs_property {
+	char *name;
+	char *description;
+	char *long_description;
+	obs_properties_t *group;
+	obs_properties_t *parent;
+	obs_property_clicked_t callback;
+	void *priv;
+	DARRAY(struct list_item) items;
+	struct obs_property *next;
+};
+
+struct obs_properties {
+	struct obs_property *first;
+	struct obs_property **last;
+	obs_properties_t *parent;
+};
+
+obs_properties_t *obs_properties_create(void)
+{
+	obs_properties_t *props = bzalloc(sizeof(*props));
+	props->last = &props->first;
+	return props;
+}
+
+static void property_destroy(struct obs_property *p)
+{
+	for (size_t i = 0; i < p->items.num; i++) {
+		bfree(p->items.array[i].name);
+		bfree(p->items.array[i].str);
+	}
+	da_free(p->items);
+	obs_properties_destroy(p->group);
+	bfree(p->name);
+	bfree(p->description);
+	bfree(p->long_description);
+	bfree(p);
+}
+
+void obs_properties_destroy(obs_properties_t *props)
+{
+	if (!props)
+		return;
+
+	struct obs_property *p = props->first;
+	while (p) {
+		struct obs_property *next = p->next;
+		property_destroy(p);
+		p = next;
+	}
+	bfree(props);
+}
+
+/* Looks through groups as well, like libobs */
+obs_property_t *obs_properties_get(obs_properties_t *props,
+				   const char *property)
+{
+	if (!props || !property)
+		return NULL;
+
+	for (struct obs_property *p = props->first; p; p = p->next) {
+		if (strcmp(p->name, property) == 0)
+			return p;
+		obs_property_t *found = obs_properties_get(p->group, property);
+		if (found)
+			return found;
+	}
+	return NULL;
+}
+
+size_t obs_properties_count(obs_properties_t *props)
+{
+	size_t count = 0;
+	for (struct obs_property *p = props ? props->first : NULL; p;
+	     p = p->next)
+		count++;
+	return count;
+}
+
+static obs_property_t *property_create(obs_properties_t *props,
+				       const char *name,
+				       const char *description)
+{
+	if (!props || !name || obs_properties_get(props, name))
+		return NULL;
+
+	struct obs_property *p = bzalloc(sizeof(*p));
+	p->name = bstrdup(name);
+	p->description = bstrdup(description);
+	p->parent = props;
+	*props->last = p;
+	props->last = &p->next;
+	return p;
+}
+
+obs_property_t *obs_properties_add_bool(obs_properties_t *props,
+					const char *name,
+					const char *description)
+{
+	return property_create(props, name, description);
+}
+
+obs_property_t *obs_properties_add_text(obs_properties_t *props,
+					const char *name,
+					const char *description,
+					enum obs_text_type type)
+{
+	UNUSED_PARAMETER(type);
+	return property_create(props, name, description);
+}
+
+obs_property_t *obs_properties_add_list(obs_properties_t *props,
+					const char *name,
+					const char *description,
+					enum obs_combo_type type,
+					enum obs_combo_format format)
+{
+	UNUSED_PARAMETER(type);
+	UNUSED_PARAMETER(format);
+	return property_create(props, name, description);
+}
+
+obs_property_t *obs_properties_add_group(obs_properties_t *props,
+					 const char *name,
+					 const char *description,
+					 enum obs_group_type type,
+					 obs_properties_t *group)
+{
+	UNUSED_PARAMETER(type);
+	if (!group || group->parent)
+		return NULL;
+
+	obs_property_t *p = property_create(props, name, description);
+	if (p) {
+		p->group = group;
+		group->parent = props;
+	}
+	return p;
+}
+
+obs_property_t *obs_properties_add_button2(obs_properties_t *props,
+					   const char *name, const char *text,
+					   obs_property_clicked_t callback,
+					   void *priv)
+{
+	obs_property_t *p = property_create(props, name, text);
+	if (p) {
+		p->callback = callback;
+		p->priv = priv;
+	}
+	return p;
+}
+
+bool obs_property_button_clicked(obs_property_t *p, void *obj)
+{
+	UNUSED_PARAMETER(obj);
+	if (!p || !p->callback)
+		return false;
+
+	obs_properties_t *top = p->parent;
+	while (top->parent)
+		top = top->parent;
+	return p->callback(top, p, p->priv);
+}
+
+void obs_property_set_long_description(obs_property_t *p,
+				       const char *long_description)
+{
+	if (!p)
+		return;
+
+	bfree(p->long_description);
+	p->long_description = bstrdup(long_description);
+}
+
+size_t obs_property_list_add_string(obs_property_t *p, const char *name,
+				    const char *val)
+{
+	if (!p)
+		return 0;
+
+	struct list_item item = {bstrdup(name), bstrdup(val), 0};
+	return da_push_back(p->items, &item);
+}
+
+size_t obs_property_list_add_int(obs_property_t *p, const char *name,
+				 long long val)
+{
+	if (!p)
+		return 0;
+
+	struct list_item item = {bstrdup(name), NULL, val};
+	return da_push_back(p->items, &item);
+}
+
+size_t obs_property_list_item_count(obs_property_t *p)
+{
+	return p ? p->items.num : 0;
+}
@@ -0,0 +1,328 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <standin.h>
+#include "standin-internal.h"
+
+/* Scenes don't render, the depth only guards against nested loops */
+#define MAX_SCENE_DEPTH 16
+
+obs_scene_t *obs_scene_create(const char *name)
+{
+	obs_scene_t *scene = bzalloc(sizeof(*scene));
+	standin_scene_source_create(name, scene);
+	return scene;
+}
+
+obs_scene_t *obs_scene_from_source(const obs_source_t *source)
+{
+	return source ? source->scene : NULL;
+}
+
+obs_source_t *obs_scene_get_source(const obs_scene_t *scene)
+{
+	return scene ? scene->source : NULL;
+}
+
+obs_scene_t *obs_scene_get_ref(obs_scene_t *scene)
+{
+	return scene && obs_source_get_ref(scene->source) ? scene : NULL;
+}
+
+void obs_scene_release(obs_scene_t *scene)
+{
+	if (scene)
+		obs_source_release(scene->source);
+}
+
+static void item_signal(obs_sceneitem_t *item, const char *signal)
+{
+	calldata_t cd;
+	calldata_init(&cd);
+	calldata_set_ptr(&cd, "scene", item->parent);
+	calldata_set_ptr(&cd, "item", item);
+	if (strcmp(signal, "item_visible") == 0)
+		calldata_set_bool(&cd, "visible", item->visible);
+	standin_source_signal(item->parent->source, signal, &cd);
+	calldata_free(&cd);
+}
+
+obs_sceneitem_t *standin_scene_load_item(obs_scene_t *scene,
+					 obs_source_t *source)
+{
+	if (!scene || !source || source == scene->source)
+		return NULL;
+
+	obs_sceneitem_t *item = bzalloc(sizeof(*item));
+	item->refs = 1;
+	item->parent = scene;
+	item->source = obs_source_get_ref(source);
+	item->id = ++scene->last_id;
+	item->visible = true;
+	item->info.scale.x = 1.0f;
+	item->info.scale.y = 1.0f;
+	da_push_back(scene->items, &item);
+	return item;
+}
+
+obs_sceneitem_t *obs_scene_add(obs_scene_t *scene, obs_source_t *source)
+{
+	obs_sceneitem_t *item = standin_scene_load_item(scene, source);
+	if (item)
+		item_signal(item, "item_add");
+	return item;
+}
+
+/* Items are referenced while the callback runs, it may remove them */
+void obs_scene_enum_items(obs_scene_t *scene,
+			  bool (*callback)(obs_scene_t *, obs_sceneitem_t *,
+					   void *),
+			  void *param)
+{
+	if (!scene)
+		return;
+
+	DARRAY(obs_sceneitem_t *) items;
+	da_init(items);
+	da_copy(items, scene->items);
+	for (size_t i = 0; i < items.num; i++)
+		obs_sceneitem_addref(items.array[i]);
+
+	size_t i = 0;
+	for (; i < items.num; i++) {
+		if (!callback(scene, items.array[i], param))
+			break;
+	}
+
+	for (i = 0; i < items.num; i++)
+		obs_sceneitem_release(items.array[i]);
+	da_free(items);
+}
+
+obs_sceneitem_t *obs_scene_find_source(obs_scene_t *scene, const char *name)
+{
+	if (!scene || !name)
+		return NULL;
+
+	for (size_t i = 0; i < scene->items.num; i++) {
+		obs_sceneitem_t *item = scene->items.array[i];
+		if (strcmp(obs_source_get_name(item->source), name) == 0)
+			return item;
+	}
+	return NULL;
+}
+
+void obs_sceneitem_addref(obs_sceneitem_t *item)
+{
+	if (item)
+		os_atomic_inc_long(&item->refs);
+}
+
+void obs_sceneitem_release(obs_sceneitem_t *item)
+{
+	if (!item || os_atomic_dec_long(&item->refs) > 0)
+		return;
+
+	obs_source_release(item->show_transition);
+	obs_source_release(item->hide_transition);
+	obs_source_release(item->source);
+	bfree(item);
+}
+
+static void detach_item(obs_sceneitem_t *item)
+{
+	da_erase_item(item->parent->items, &item);
+	item->parent = NULL;
+	obs_sceneitem_release(item);
+}
+
+void obs_sceneitem_remove(obs_sceneitem_t *item)
+{
+	if (!item || !item->parent)
+		return;
+
+	obs_sceneitem_addref(item);
+	item_signal(item, "item_remove");
+	detach_item(item);
+	obs_sceneitem_release(item);
+}
+
+obs_scene_t *obs_sceneitem_get_scene(const obs_sceneitem_t *item)
+{
+	return item ? item->parent : NULL;
+}
+
+obs_source_t *obs_sceneitem_get_source(const obs_sceneitem_t *item)
+{
+	return item ? item->source : NULL;
+}
+
+int64_t obs_sceneitem_get_id(const obs_sceneitem_t *item)
+{
+	return item ? item->id : 0;
+}
+
+void obs_sceneitem_get_info(const obs_sceneitem_t *item,
+			    struct obs_transform_info *info)
+{
+	if (item && info)
+		*info = item->info;
+}
+
+void obs_sceneitem_set_info(obs_sceneitem_t *item,
+			    const struct obs_transform_info *info)
+{
+	if (!item || !info)
+		return;
+
+	item->info = *info;
+	if (item->parent)
+		item_signal(item, "item_transform");
+}
+
+void obs_sceneitem_get_crop(const obs_sceneitem_t *item,
+			    struct obs_sceneitem_crop *crop)
+{
+	if (item && crop)
+		*crop = item->crop;
+}
+
+void obs_sceneitem_set_crop(obs_sceneitem_t *item,
+			    const struct obs_sceneitem_crop *crop)
+{
+	if (!item || !crop)
+		return;
+
+	item->crop = *crop;
+	if (item->parent)
+		item_signal(item, "item_transform");
+}
+
+void obs_sceneitem_defer_update_begin(obs_sceneitem_t *item)
+{
+	UNUSED_PARAMETER(item);
+}
+
+void obs_sceneitem_defer_update_end(obs_sceneitem_t *item)
+{
+	UNUSED_PARAMETER(item);
+}
+
+bool obs_sceneitem_visible(const obs_sceneitem_t *item)
+{
+	return item ? item->visible : false;
+}
+
+bool obs_sceneitem_set_visible(obs_sceneitem_t *item, bool visible)
+{
+	if (!item || !item->parent)
+		return false;
+	if (item->visible == visible)
+		return true;
+
+	item->visible = visible;
+	item_signal(item, "item_visible");
+	return true;
+}
+
+obs_source_t *obs_sceneitem_get_transition(obs_sceneitem_t *item, bool show)
+{
+	if (!item)
+		return NULL;
+	return show ? item->show_transition : item->hide_transition;
+}
+
+void obs_sceneitem_set_transition(obs_sceneitem_t *item, bool show,
+				  obs_source_t *transition)
+{
+	if (!item)
+		return;
+
+	obs_source_t **target = show ? &item->show_transition
+				     : &item->hide_transition;
+	obs_source_release(*target);
+	*target = obs_source_get_ref(transition);
+}
+
+uint32_t obs_sceneitem_get_transition_duration(obs_sceneitem_t *item,
+					       bool show)
+{
+	if (!item)
+		return 0;
+	return show ? item->show_duration : item->hide_duration;
+}
+
+void obs_sceneitem_set_transition_duration(obs_sceneitem_t *item, bool show,
+					   uint32_t duration_ms)
+{
+	if (!item)
+		return;
+
+	if (show)
+		item->show_duration = duration_ms;
+	else
+		item->hide_duration = duration_ms;
+}
+
+/* ------------------------------------------------------------------------- */
+/* stand-in */
+
+void standin_scene_destroy(obs_scene_t *scene)
+{
+	while (scene->items.num)
+		detach_item(scene->items.array[scene->items.num - 1]);
+	da_free(scene->items);
+	bfree(scene);
+}
+
+void standin_scenes_remove_source(obs_source_t *source)
+{
+	standin_sources_lock();
+	for (size_t i = 0; i < standin_source_count(); i++) {
+		obs_scene_t *scene = standin_source_at(i)->scene;
+		if (!scene)
+			continue;
+
+		// removing one item may remove others from its callbacks
+		size_t j = scene->items.num;
+		while (j > 0) {
+			obs_sceneitem_t *item = scene->items.array[--j];
+			if (item->source == source) {
+				obs_sceneitem_remove(item);
+				j = scene->items.num;
+			}
+		}
+	}
+	standin_sources_unlock();
+}
+
+bool standin_scene_shows(obs_scene_t *scene, obs_source_t *source, int depth)
+{
+	if (!scene || depth > MAX_SCENE_DEPTH)
+		return false;
+
+	for (size_t i = 0; i < scene->items.num; i++) {
+		obs_sceneitem_t *item = scene->items.array[i];
+		if (!item->visible)
+			continue;
+		if (item->source == source ||
+		    standin_scene_shows(item->source->scene, source, depth + 1))
+			return true;
+	}
+	return false;
+}
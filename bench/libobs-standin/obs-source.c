@@ -0,0 +1,695 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include "standin-internal.h"
+
+/* ------------------------------------------------------------------------- */
+/* references */
+
+static obs_source_t *source_create_internal(const struct obs_source_info *info,
+					    const char *id, const char *name,
+					    obs_data_t *settings,
+					    bool is_private)
+{
+	obs_source_t *source = bzalloc(sizeof(*source));
+	source->control = bzalloc(sizeof(*source->control));
+	source->control->refs = 1;
+	source->control->weak_refs = 1;
+	source->control->source = source;
+
+	source->info = info;
+	source->name = bstrdup(name);
+	source->id = bstrdup(id);
+	source->is_private = is_private;
+	source->enabled = true;
+	source->volume = 1.0f;
+	source->balance = 0.5f;
+	source->mixers = 0x3F;
+	source->signals = signal_handler_create();
+	source->procs = proc_handler_create();
+
+	if (settings) {
+		obs_data_addref(settings);
+		source->settings = settings;
+	} else {
+		source->settings = obs_data_create();
+	}
+	if (info && info->get_defaults)
+		info->get_defaults(source->settings);
+
+	standin_source_created(source);
+	return source;
+}
+
+static obs_source_t *source_create(const char *id, const char *name,
+				   obs_data_t *settings, bool is_private)
+{
+	const struct obs_source_info *info = standin_find_type(id);
+	if (!info)
+		blog(LOG_WARNING, "Source ID '%s' not found", id);
+
+	obs_source_t *source =
+		source_create_internal(info, id, name, settings, is_private);
+	if (info && info->create)
+		source->data = info->create(source->settings, source);
+
+	if (!is_private)
+		standin_source_global_signal(source, "source_create", NULL);
+	return source;
+}
+
+obs_source_t *obs_source_create(const char *id, const char *name,
+				obs_data_t *settings, obs_data_t *hotkey_data)
+{
+	UNUSED_PARAMETER(hotkey_data);
+	return source_create(id, name, settings, false);
+}
+
+obs_source_t *obs_source_create_private(const char *id, const char *name,
+					obs_data_t *settings)
+{
+	return source_create(id, name, settings, true);
+}
+
+obs_source_t *standin_scene_source_create(const char *name, obs_scene_t *scene)
+{
+	const struct obs_source_info *info = standin_find_type("scene");
+	obs_source_t *source =
+		source_create_internal(info, "scene", name, NULL, false);
+	source->scene = scene;
+	scene->source = source;
+
+	standin_source_global_signal(source, "source_create", NULL);
+	return source;
+}
+
+obs_source_t *obs_source_get_ref(obs_source_t *source)
+{
+	if (!source)
+		return NULL;
+
+	long refs = os_atomic_load_long(&source->control->refs);
+	while (refs > 0) {
+		if (os_atomic_compare_swap_long(&source->control->refs, refs,
+						refs + 1))
+			return source;
+		refs = os_atomic_load_long(&source->control->refs);
+	}
+	return NULL;
+}
+
+static void source_destroy(obs_source_t *source)
+{
+	standin_source_global_signal(source, "source_destroy", "destroy");
+
+	while (source->filters.num)
+		obs_source_filter_remove(source, source->filters.array[0]);
+	da_free(source->filters);
+
+	if (source->info && source->info->destroy && source->data)
+		source->info->destroy(source->data);
+	if (source->scene)
+		standin_scene_destroy(source->scene);
+
+	standin_source_destroyed(source);
+
+	source->control->source = NULL;
+	obs_weak_source_release(source->control);
+	obs_data_release(source->settings);
+	signal_handler_destroy(source->signals);
+	proc_handler_destroy(source->procs);
+	bfree(source->name);
+	bfree(source->id);
+	bfree(source);
+}
+
+void obs_source_release(obs_source_t *source)
+{
+	if (source && os_atomic_dec_long(&source->control->refs) == 0)
+		source_destroy(source);
+}
+
+/* Removes its scene items as well, like the frontend does */
+void obs_source_remove(obs_source_t *source)
+{
+	if (!source || source->removed)
+		return;
+
+	source->removed = true;
+	obs_source_get_ref(source);
+	standin_source_global_signal(source, "source_remove", "remove");
+	standin_scenes_remove_source(source);
+	obs_source_release(source);
+}
+
+bool obs_source_removed(const obs_source_t *source)
+{
+	return source ? source->removed : true;
+}
+
+obs_weak_source_t *obs_source_get_weak_source(obs_source_t *source)
+{
+	if (!source)
+		return NULL;
+
+	obs_weak_source_addref(source->control);
+	return source->control;
+}
+
+obs_source_t *obs_weak_source_get_source(obs_weak_source_t *weak)
+{
+	return weak ? obs_source_get_ref(weak->source) : NULL;
+}
+
+void obs_weak_source_addref(obs_weak_source_t *weak)
+{
+	if (weak)
+		os_atomic_inc_long(&weak->weak_refs);
+}
+
+void obs_weak_source_release(obs_weak_source_t *weak)
+{
+	if (weak && os_atomic_dec_long(&weak->weak_refs) == 0)
+		bfree(weak);
+}
+
+bool obs_weak_source_references_source(obs_weak_source_t *weak,
+				       obs_source_t *source)
+{
+	return weak && source && source->control == weak;
+}
+
+/* ------------------------------------------------------------------------- */
+/* signals */
+
+void standin_source_signal(obs_source_t *source, const char *signal,
+			   calldata_t *cd)
+{
+	signal_handler_signal(source->signals, signal, cd);
+}
+
+void standin_source_global_signal(obs_source_t *source, const char *global,
+				  const char *local)
+{
+	calldata_t cd;
+	calldata_init(&cd);
+	calldata_set_ptr(&cd, "source", source);
+	if (global && !source->is_private)
+		signal_handler_signal(obs_get_signal_handler(), global, &cd);
+	if (local)
+		signal_handler_signal(source->signals, local, &cd);
+	calldata_free(&cd);
+}
+
+/* ------------------------------------------------------------------------- */
+/* info */
+
+const char *obs_source_get_name(const obs_source_t *source)
+{
+	return source ? source->name : NULL;
+}
+
+void obs_source_set_name(obs_source_t *source, const char *name)
+{
+	if (!source || !name || strcmp(source->name, name) == 0)
+		return;
+
+	char *prev_name = source->name;
+	source->name = bstrdup(name);
+
+	calldata_t cd;
+	calldata_init(&cd);
+	calldata_set_ptr(&cd, "source", source);
+	calldata_set_string(&cd, "new_name", source->name);
+	calldata_set_string(&cd, "prev_name", prev_name);
+	if (!source->is_private)
+		signal_handler_signal(obs_get_signal_handler(), "source_rename",
+				      &cd);
+	signal_handler_signal(source->signals, "rename", &cd);
+	calldata_free(&cd);
+	bfree(prev_name);
+}
+
+enum obs_source_type obs_source_get_type(const obs_source_t *source)
+{
+	return source && source->info ? source->info->type
+				      : OBS_SOURCE_TYPE_INPUT;
+}
+
+const char *obs_source_get_id(const obs_source_t *source)
+{
+	return source ? source->id : NULL;
+}
+
+const char *obs_source_get_unversioned_id(const obs_source_t *source)
+{
+	return source ? source->id : NULL;
+}
+
+uint32_t obs_source_get_output_flags(const obs_source_t *source)
+{
+	return source && source->info ? source->info->output_flags : 0;
+}
+
+uint32_t obs_source_get_width(obs_source_t *source)
+{
+	if (!source || !source->info || !source->info->get_width)
+		return 0;
+	return source->info->get_width(source->data);
+}
+
+uint32_t obs_source_get_height(obs_source_t *source)
+{
+	if (!source || !source->info || !source->info->get_height)
+		return 0;
+	return source->info->get_height(source->data);
+}
+
+void *obs_obj_get_data(void *obj)
+{
+	obs_source_t *source = obj;
+	return source ? source->data : NULL;
+}
+
+bool obs_obj_is_private(void *obj)
+{
+	obs_source_t *source = obj;
+	return source ? source->is_private : false;
+}
+
+/* ------------------------------------------------------------------------- */
+/* settings */
+
+obs_data_t *obs_source_get_settings(const obs_source_t *source)
+{
+	if (!source)
+		return NULL;
+
+	obs_data_addref(source->settings);
+	return source->settings;
+}
+
+void obs_source_update(obs_source_t *source, obs_data_t *settings)
+{
+	if (!source)
+		return;
+
+	if (settings)
+		obs_data_apply(source->settings, settings);
+	if (source->info && source->info->update)
+		source->info->update(source->data, source->settings);
+	standin_source_global_signal(source, "source_update", "update");
+}
+
+void obs_source_save(obs_source_t *source)
+{
+	if (!source)
+		return;
+
+	standin_source_global_signal(source, "source_save", "save");
+	if (source->info && source->info->save)
+		source->info->save(source->data, source->settings);
+}
+
+obs_properties_t *obs_source_properties(const obs_source_t *source)
+{
+	if (!source || !source->info || !source->info->get_properties)
+		return NULL;
+	return source->info->get_properties(source->data);
+}
+
+obs_data_t *obs_hotkeys_save_source(obs_source_t *source)
+{
+	UNUSED_PARAMETER(source);
+	return obs_data_create();
+}
+
+signal_handler_t *obs_source_get_signal_handler(const obs_source_t *source)
+{
+	return source ? source->signals : NULL;
+}
+
+proc_handler_t *obs_source_get_proc_handler(const obs_source_t *source)
+{
+	return source ? source->procs : NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/* state */
+
+bool obs_source_is_hidden(obs_source_t *source)
+{
+	UNUSED_PARAMETER(source);
+	return false;
+}
+
+bool obs_source_enabled(const obs_source_t *source)
+{
+	return source ? source->enabled : false;
+}
+
+void obs_source_set_enabled(obs_source_t *source, bool enabled)
+{
+	if (!source || source->enabled == enabled)
+		return;
+
+	source->enabled = enabled;
+
+	calldata_t cd;
+	calldata_init(&cd);
+	calldata_set_ptr(&cd, "source", source);
+	calldata_set_bool(&cd, "enabled", enabled);
+	signal_handler_signal(source->signals, "enable", &cd);
+	calldata_free(&cd);
+}
+
+static bool scene_shows(obs_source_t *scene, const obs_source_t *source)
+{
+	if (!scene)
+		return false;
+	if (scene == source)
+		return true;
+	return standin_scene_shows(scene->scene, (obs_source_t *)source, 0);
+}
+
+/* Filters follow their parent, scenes are shown when they are selected */
+bool obs_source_active(const obs_source_t *source)
+{
+	if (source && source->filter_parent)
+		source = source->filter_parent;
+	return source && scene_shows(standin_current_scene(), source);
+}
+
+bool obs_source_showing(const obs_source_t *source)
+{
+	if (source && source->filter_parent)
+		source = source->filter_parent;
+	return source && (scene_shows(standin_current_scene(), source) ||
+			  scene_shows(standin_preview_scene(), source));
+}
+
+/* ------------------------------------------------------------------------- */
+/* filters */
+
+obs_source_t *obs_filter_get_parent(const obs_source_t *filter)
+{
+	return filter ? filter->filter_parent : NULL;
+}
+
+static void filter_signal(obs_source_t *source, obs_source_t *filter,
+			  const char *global, const char *local)
+{
+	calldata_t cd;
+	calldata_init(&cd);
+	calldata_set_ptr(&cd, "source", source);
+	calldata_set_ptr(&cd, "filter", filter);
+	signal_handler_signal(obs_get_signal_handler(), global, &cd);
+	signal_handler_signal(source->signals, local, &cd);
+	calldata_free(&cd);
+}
+
+void obs_source_filter_add(obs_source_t *source, obs_source_t *filter)
+{
+	if (!source || !filter || filter->filter_parent)
+		return;
+	if (da_find(source->filters, &filter, 0) != DARRAY_INVALID)
+		return;
+
+	filter = obs_source_get_ref(filter);
+	if (!filter)
+		return;
+
+	filter->filter_parent = source;
+	da_insert(source->filters, 0, &filter);
+
+	filter_signal(source, filter, "source_filter_add", "filter_add");
+	if (filter->info && filter->info->filter_add)
+		filter->info->filter_add(filter->data, source);
+}
+
+void obs_source_filter_remove(obs_source_t *source, obs_source_t *filter)
+{
+	if (!source || !filter)
+		return;
+
+	size_t idx = da_find(source->filters, &filter, 0);
+	if (idx == DARRAY_INVALID)
+		return;
+
+	da_erase(source->filters, idx);
+
+	filter_signal(source, filter, "source_filter_remove",
+		      "filter_remove");
+	if (filter->info && filter->info->filter_remove)
+		filter->info->filter_remove(filter->data, source);
+
+	filter->filter_parent = NULL;
+	obs_source_release(filter);
+}
+
+void obs_source_filter_set_order(obs_source_t *source, obs_source_t *filter,
+				 enum obs_order_movement movement)
+{
+	if (!source || !filter)
+		return;
+
+	size_t idx = da_find(source->filters, &filter, 0);
+	size_t last = source->filters.num - 1;
+	if (idx == DARRAY_INVALID)
+		return;
+
+	size_t new_idx = idx;
+	if (movement == OBS_ORDER_MOVE_UP && idx < last)
+		new_idx = idx + 1;
+	else if (movement == OBS_ORDER_MOVE_DOWN && idx > 0)
+		new_idx = idx - 1;
+	else if (movement == OBS_ORDER_MOVE_TOP)
+		new_idx = last;
+	else if (movement == OBS_ORDER_MOVE_BOTTOM)
+		new_idx = 0;
+	if (new_idx == idx)
+		return;
+
+	da_move_item(source->filters, idx, new_idx);
+	standin_source_global_signal(source, NULL, "reorder_filters");
+}
+
+/* Top to bottom, the order of the filters dialog */
+void obs_source_enum_filters(obs_source_t *source,
+			     obs_source_enum_proc_t callback, void *param)
+{
+	if (!source)
+		return;
+
+	for (size_t i = source->filters.num; i > 0; i--) {
+		obs_source_t *filter = source->filters.array[i - 1];
+		callback(source, filter, param);
+	}
+}
+
+obs_source_t *obs_source_get_filter_by_name(obs_source_t *source,
+					    const char *name)
+{
+	if (!source || !name)
+		return NULL;
+
+	for (size_t i = 0; i < source->filters.num; i++) {
+		obs_source_t *filter = source->filters.array[i];
+		if (strcmp(filter->name, name) == 0)
+			return obs_source_get_ref(filter);
+	}
+	return NULL;
+}
+
+size_t obs_source_filter_count(const obs_source_t *source)
+{
+	return source ? source->filters.num : 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/* audio */
+
+enum obs_monitoring_type
+obs_source_get_monitoring_type(const obs_source_t *source)
+{
+	return source ? source->monitoring : OBS_MONITORING_TYPE_NONE;
+}
+
+void obs_source_set_monitoring_type(obs_source_t *source,
+				    enum obs_monitoring_type type)
+{
+	if (source)
+		source->monitoring = type;
+}
+
+float obs_source_get_volume(const obs_source_t *source)
+{
+	return source ? source->volume : 0.0f;
+}
+
+void obs_source_set_volume(obs_source_t *source, float volume)
+{
+	if (!source)
+		return;
+
+	calldata_t cd;
+	calldata_init(&cd);
+	calldata_set_ptr(&cd, "source", source);
+	calldata_set_float(&cd, "volume", volume);
+	signal_handler_signal(source->signals, "volume", &cd);
+	source->volume = (float)calldata_float(&cd, "volume");
+	calldata_free(&cd);
+}
+
+bool obs_source_muted(const obs_source_t *source)
+{
+	return source ? source->muted : false;
+}
+
+void obs_source_set_muted(obs_source_t *source, bool muted)
+{
+	if (!source)
+		return;
+
+	source->muted = muted;
+
+	calldata_t cd;
+	calldata_init(&cd);
+	calldata_set_ptr(&cd, "source", source);
+	calldata_set_bool(&cd, "muted", muted);
+	signal_handler_signal(source->signals, "mute", &cd);
+	calldata_free(&cd);
+}
+
+float obs_source_get_balance_value(const obs_source_t *source)
+{
+	return source ? source->balance : 0.5f;
+}
+
+void obs_source_set_balance_value(obs_source_t *source, float balance)
+{
+	if (!source)
+		return;
+
+	calldata_t cd;
+	calldata_init(&cd);
+	calldata_set_ptr(&cd, "source", source);
+	calldata_set_float(&cd, "balance", balance);
+	signal_handler_signal(source->signals, "audio_balance", &cd);
+	source->balance = (float)calldata_float(&cd, "balance");
+	calldata_free(&cd);
+}
+
+int64_t obs_source_get_sync_offset(const obs_source_t *source)
+{
+	return source ? source->sync_offset : 0;
+}
+
+void obs_source_set_sync_offset(obs_source_t *source, int64_t offset)
+{
+	if (!source)
+		return;
+
+	calldata_t cd;
+	calldata_init(&cd);
+	calldata_set_ptr(&cd, "source", source);
+	calldata_set_int(&cd, "offset", offset);
+	signal_handler_signal(source->signals, "audio_sync", &cd);
+	source->sync_offset = calldata_int(&cd, "offset");
+	calldata_free(&cd);
+}
+
+uint32_t obs_source_get_audio_mixers(const obs_source_t *source)
+{
+	return source ? source->mixers : 0;
+}
+
+void obs_source_set_audio_mixers(obs_source_t *source, uint32_t mixers)
+{
+	if (!source || source->mixers == mixers)
+		return;
+
+	calldata_t cd;
+	calldata_init(&cd);
+	calldata_set_ptr(&cd, "source", source);
+	calldata_set_int(&cd, "mixers", mixers);
+	signal_handler_signal(source->signals, "audio_mixers", &cd);
+	source->mixers = (uint32_t)calldata_int(&cd, "mixers");
+	calldata_free(&cd);
+}
+
+bool obs_source_audio_active(const obs_source_t *source)
+{
+	return source ? source->audio_active : false;
+}
+
+void obs_source_set_audio_active(obs_source_t *source, bool show)
+{
+	if (!source || source->audio_active == show)
+		return;
+
+	source->audio_active = show;
+	standin_source_global_signal(
+		source, NULL, show ? "audio_activate" : "audio_deactivate");
+}
+
+/* ------------------------------------------------------------------------- */
+/* duplicating */
+
+static void copy_filter(obs_source_t *parent, obs_source_t *filter,
+			void *param)
+{
+	UNUSED_PARAMETER(parent);
+	obs_source_t *dst = param;
+	obs_source_t *copy =
+		obs_source_duplicate(filter, filter->name, filter->is_private);
+	obs_source_set_enabled(copy, filter->enabled);
+	obs_source_filter_add(dst, copy);
+	obs_source_release(copy);
+}
+
+/* Scenes aren't duplicated, they are referenced like DO_NOT_DUPLICATE */
+obs_source_t *obs_source_duplicate(obs_source_t *source,
+				   const char *desired_name,
+				   bool create_private)
+{
+	if (!source)
+		return NULL;
+	if (source->scene || (obs_source_get_output_flags(source) &
+			      OBS_SOURCE_DO_NOT_DUPLICATE) != 0)
+		return obs_source_get_ref(source);
+
+	obs_data_t *settings = obs_data_create();
+	obs_data_apply(settings, source->settings);
+
+	obs_source_t *copy = source_create(source->id, desired_name, settings,
+					   create_private);
+	obs_data_release(settings);
+
+	copy->volume = source->volume;
+	copy->balance = source->balance;
+	copy->muted = source->muted;
+	copy->sync_offset = source->sync_offset;
+	copy->mixers = source->mixers;
+	copy->monitoring = source->monitoring;
+
+	// the filters dialog order is top to bottom, adding inserts at the top
+	for (size_t i = 0; i < source->filters.num; i++)
+		copy_filter(source, source->filters.array[i], copy);
+	return copy;
+}
@@ -0,0 +1,109 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <obs.h>
+#include <util/darray.h>
+#include <util/dstr.h>
+#include <util/threading.h>
+
+struct obs_weak_source {
+	volatile long refs; // strong references of the source
+	volatile long weak_refs;
+	obs_source_t *source;
+};
+
+struct obs_source {
+	struct obs_weak_source *control;
+	const struct obs_source_info *info;
+	void *data;
+	char *name;
+	char *id;
+	bool is_private;
+	bool removed;
+	bool enabled;
+	uint64_t ticks;
+
+	obs_data_t *settings;
+	signal_handler_t *signals;
+	proc_handler_t *procs;
+
+	obs_source_t *filter_parent;
+	DARRAY(obs_source_t *) filters; // bottom to top, like libobs
+
+	float volume;
+	float balance;
+	bool muted;
+	bool audio_active;
+	int64_t sync_offset;
+	uint32_t mixers;
+	enum obs_monitoring_type monitoring;
+
+	obs_scene_t *scene; // scene sources only
+};
+
+struct obs_scene_item {
+	volatile long refs;
+	obs_scene_t *parent; // NULL once removed
+	obs_source_t *source;
+	int64_t id;
+	bool visible;
+	struct obs_transform_info info;
+	struct obs_sceneitem_crop crop;
+	obs_source_t *show_transition;
+	obs_source_t *hide_transition;
+	uint32_t show_duration;
+	uint32_t hide_duration;
+};
+
+struct obs_scene {
+	obs_source_t *source;
+	DARRAY(obs_sceneitem_t *) items; // bottom to top
+	int64_t last_id;
+};
+
+/* core, all sources that exist, in the order they were created */
+extern void standin_sources_lock(void);
+extern void standin_sources_unlock(void);
+extern void standin_source_created(obs_source_t *source);
+extern void standin_source_destroyed(obs_source_t *source);
+extern size_t standin_source_count(void);
+extern obs_source_t *standin_source_at(size_t idx);
+extern const struct obs_source_info *standin_find_type(const char *id);
+
+/* times a callback unless it runs inside another timed one */
+extern uint64_t standin_timer_begin(void);
+extern void standin_timer_end(const char *what, uint64_t start);
+
+/* sources */
+extern obs_source_t *standin_scene_source_create(const char *name,
+						 obs_scene_t *scene);
+extern void standin_source_signal(obs_source_t *source, const char *signal,
+				  calldata_t *cd);
+extern void standin_source_global_signal(obs_source_t *source,
+					 const char *global,
+					 const char *local);
+
+/* scenes */
+extern void standin_scene_destroy(obs_scene_t *scene);
+extern void standin_scenes_remove_source(obs_source_t *source);
+extern bool standin_scene_shows(obs_scene_t *scene, obs_source_t *source,
+				int depth);
+extern obs_source_t *standin_current_scene(void);
+extern obs_source_t *standin_preview_scene(void);
@@ -0,0 +1,543 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <util/base.h>
+#include <util/bmem.h>
+#include <util/config-file.h>
+#include <util/dstr.h>
+#include <util/platform.h>
+#include <util/profiler.h>
+#include <util/threading.h>
+
+#include "standin-internal.h"
+
+/* ------------------------------------------------------------------------- */
+/* memory */
+
+static volatile long num_allocs = 0;
+
+void *bmalloc(size_t size)
+{
+	void *ptr = malloc(size ? size : 1);
+	if (!ptr) {
+		fprintf(stderr, "Out of memory while trying to allocate %zu"
+				" bytes\n",
+			size);
+		abort();
+	}
+	os_atomic_inc_long(&num_allocs);
+	return ptr;
+}
+
+void *brealloc(void *ptr, size_t size)
+{
+	if (!ptr)
+		return bmalloc(size);
+
+	ptr = realloc(ptr, size ? size : 1);
+	if (!ptr) {
+		fprintf(stderr, "Out of memory while trying to allocate %zu"
+				" bytes\n",
+			size);
+		abort();
+	}
+	return ptr;
+}
+
+void bfree(void *ptr)
+{
+	if (ptr) {
+		os_atomic_dec_long(&num_allocs);
+		free(ptr);
+	}
+}
+
+long bnum_allocs(void)
+{
+	return os_atomic_load_long(&num_allocs);
+}
+
+/* ------------------------------------------------------------------------- */
+/* log */
+
+static int log_level = LOG_WARNING;
+
+void standin_set_log_level(int level)
+{
+	log_level = level;
+}
+
+void blogva(int level, const char *format, va_list args)
+{
+	if (level > log_level)
+		return;
+
+	const char *prefix = level <= LOG_ERROR     ? "error: "
+			     : level <= LOG_WARNING ? "warning: "
+			     : level <= LOG_INFO    ? "info: "
+						    : "debug: ";
+	fputs(prefix, stderr);
+	vfprintf(stderr, format, args);
+	fputc('\n', stderr);
+}
+
+void blog(int level, const char *format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	blogva(level, format, args);
+	va_end(args);
+}
+
+void profile_start(const char *name)
+{
+	UNUSED_PARAMETER(name);
+}
+
+void profile_end(const char *name)
+{
+	UNUSED_PARAMETER(name);
+}
+
+/* ------------------------------------------------------------------------- */
+/* dstr */
+
+void dstr_free(struct dstr *dst)
+{
+	bfree(dst->array);
+	dstr_init(dst);
+}
+
+void dstr_ensure_capacity(struct dstr *dst, const size_t new_size)
+{
+	if (new_size <= dst->capacity)
+		return;
+
+	size_t new_cap = !dst->capacity ? new_size : dst->capacity * 2;
+	if (new_size > new_cap)
+		new_cap = new_size;
+	dst->array = brealloc(dst->array, new_cap);
+	dst->capacity = new_cap;
+}
+
+void dstr_resize(struct dstr *dst, const size_t num)
+{
+	if (!num) {
+		dstr_free(dst);
+		return;
+	}
+
+	dstr_ensure_capacity(dst, num + 1);
+	dst->array[num] = 0;
+	dst->len = num;
+}
+
+void dstr_ncopy(struct dstr *dst, const char *array, const size_t len)
+{
+	if (!array || !*array || !len) {
+		dstr_free(dst);
+		return;
+	}
+
+	dstr_ensure_capacity(dst, len + 1);
+	memcpy(dst->array, array, len);
+	dst->array[len] = 0;
+	dst->len = len;
+}
+
+void dstr_copy(struct dstr *dst, const char *array)
+{
+	dstr_ncopy(dst, array, array ? strlen(array) : 0);
+}
+
+void dstr_ncat(struct dstr *dst, const char *array, const size_t len)
+{
+	if (!array || !*array || !len)
+		return;
+
+	size_t new_len = dst->len + len;
+	dstr_ensure_capacity(dst, new_len + 1);
+	memcpy(dst->array + dst->len, array, len);
+	dst->len = new_len;
+	dst->array[new_len] = 0;
+}
+
+void dstr_cat(struct dstr *dst, const char *array)
+{
+	if (array)
+		dstr_ncat(dst, array, strlen(array));
+}
+
+void dstr_cat_ch(struct dstr *dst, char ch)
+{
+	dstr_ensure_capacity(dst, ++dst->len + 1);
+	dst->array[dst->len - 1] = ch;
+	dst->array[dst->len] = 0;
+}
+
+void dstr_insert(struct dstr *dst, const size_t idx, const char *array)
+{
+	if (!array || !*array)
+		return;
+	if (idx >= dst->len) {
+		dstr_cat(dst, array);
+		return;
+	}
+
+	size_t len = strlen(array);
+	dstr_ensure_capacity(dst, dst->len + len + 1);
+	memmove(dst->array + idx + len, dst->array + idx, dst->len - idx + 1);
+	memcpy(dst->array + idx, array, len);
+	dst->len += len;
+}
+
+void dstr_vcatf(struct dstr *dst, const char *format, va_list args)
+{
+	va_list copy;
+	va_copy(copy, args);
+	int len = vsnprintf(NULL, 0, format, copy);
+	va_end(copy);
+	if (len <= 0)
+		return;
+
+	dstr_ensure_capacity(dst, dst->len + (size_t)len + 1);
+	vsnprintf(dst->array + dst->len, (size_t)len + 1, format, args);
+	dst->len += (size_t)len;
+}
+
+void dstr_vprintf(struct dstr *dst, const char *format, va_list args)
+{
+	if (dst->array)
+		dst->array[0] = 0;
+	dst->len = 0;
+	dstr_vcatf(dst, format, args);
+}
+
+void dstr_catf(struct dstr *dst, const char *format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	dstr_vcatf(dst, format, args);
+	va_end(args);
+}
+
+void dstr_printf(struct dstr *dst, const char *format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	dstr_vprintf(dst, format, args);
+	va_end(args);
+}
+
+int astrcmpi_n(const char *str1, const char *str2, size_t n)
+{
+	if (!n)
+		return 0;
+	if (!str1)
+		str1 = "";
+	if (!str2)
+		str2 = "";
+
+	do {
+		int ch1 = toupper((unsigned char)*str1);
+		int ch2 = toupper((unsigned char)*str2);
+		if (ch1 < ch2)
+			return -1;
+		else if (ch1 > ch2)
+			return 1;
+	} while (*str1++ && *str2++ && --n);
+
+	return 0;
+}
+
+int astrcmpi(const char *str1, const char *str2)
+{
+	return astrcmpi_n(str1, str2, (size_t)-1);
+}
+
+/* ------------------------------------------------------------------------- */
+/* platform */
+
+uint64_t os_gettime_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+void os_sleep_ms(uint32_t duration)
+{
+	usleep(duration * 1000);
+}
+
+bool os_sleepto_ns(uint64_t time_target)
+{
+	uint64_t now = os_gettime_ns();
+	if (time_target < now)
+		return false;
+
+	struct timespec ts = {
+		.tv_sec = (time_t)((time_target - now) / 1000000000ULL),
+		.tv_nsec = (long)((time_target - now) % 1000000000ULL),
+	};
+	nanosleep(&ts, NULL);
+	return true;
+}
+
+FILE *os_fopen(const char *path, const char *mode)
+{
+	return path ? fopen(path, mode) : NULL;
+}
+
+int os_stat(const char *file, struct stat *st)
+{
+	return stat(file, st);
+}
+
+bool os_file_exists(const char *path)
+{
+	return access(path, F_OK) == 0;
+}
+
+int os_unlink(const char *path)
+{
+	return unlink(path);
+}
+
+int os_rename(const char *old_path, const char *new_path)
+{
+	return rename(old_path, new_path);
+}
+
+int os_mkdir(const char *path)
+{
+	if (mkdir(path, 0755) == 0)
+		return MKDIR_SUCCESS;
+	return errno == EEXIST ? MKDIR_EXISTS : MKDIR_ERROR;
+}
+
+int os_mkdirs(const char *dir)
+{
+	struct dstr path = {0};
+	dstr_copy(&path, dir);
+
+	int ret = MKDIR_EXISTS;
+	for (size_t i = 1; i <= path.len; i++) {
+		if (path.array[i] != '/' && path.array[i] != 0)
+			continue;
+
+		char ch = path.array[i];
+		path.array[i] = 0;
+		ret = os_mkdir(path.array);
+		path.array[i] = ch;
+		if (ret == MKDIR_ERROR)
+			break;
+	}
+	dstr_free(&path);
+	return ret;
+}
+
+char *os_quick_read_utf8_file(const char *path)
+{
+	FILE *file = os_fopen(path, "rb");
+	if (!file)
+		return NULL;
+
+	struct dstr str = {0};
+	char buf[4096];
+	size_t read;
+	while ((read = fread(buf, 1, sizeof(buf), file)) > 0)
+		dstr_ncat(&str, buf, read);
+	fclose(file);
+
+	// skip the byte order mark
+	if (str.len >= 3 && memcmp(str.array, "\xEF\xBB\xBF", 3) == 0) {
+		char *out = bstrdup(str.array + 3);
+		dstr_free(&str);
+		return out;
+	}
+	return str.array ? str.array : bstrdup("");
+}
+
+bool os_quick_write_utf8_file(const char *path, const char *str, size_t len,
+			      bool marker)
+{
+	FILE *file = os_fopen(path, "wb");
+	if (!file)
+		return false;
+
+	bool success = true;
+	if (marker && fwrite("\xEF\xBB\xBF", 1, 3, file) != 3)
+		success = false;
+	if (len && fwrite(str, 1, len, file) != len)
+		success = false;
+	if (fclose(file) != 0)
+		success = false;
+	return success;
+}
+
+/* ------------------------------------------------------------------------- */
+/* config */
+
+struct config_item {
+	char *section;
+	char *name;
+	char *value;
+	char *default_value;
+};
+
+struct config_data {
+	DARRAY(struct config_item) items;
+};
+
+config_t *config_create(void)
+{
+	return bzalloc(sizeof(struct config_data));
+}
+
+void config_close(config_t *config)
+{
+	if (!config)
+		return;
+
+	for (size_t i = 0; i < config->items.num; i++) {
+		struct config_item *item = &config->items.array[i];
+		bfree(item->section);
+		bfree(item->name);
+		bfree(item->value);
+		bfree(item->default_value);
+	}
+	da_free(config->items);
+	bfree(config);
+}
+
+static struct config_item *get_item(config_t *config, const char *section,
+				    const char *name, bool create)
+{
+	for (size_t i = 0; i < config->items.num; i++) {
+		struct config_item *item = &config->items.array[i];
+		if (strcmp(item->section, section) == 0 &&
+		    strcmp(item->name, name) == 0)
+			return item;
+	}
+	if (!create)
+		return NULL;
+
+	struct config_item *item = da_push_back_new(config->items);
+	item->section = bstrdup(section);
+	item->name = bstrdup(name);
+	return item;
+}
+
+void config_set_string(config_t *config, const char *section,
+		       const char *name, const char *value)
+{
+	struct config_item *item = get_item(config, section, name, true);
+	bfree(item->value);
+	item->value = bstrdup(value ? value : "");
+}
+
+void config_set_default_string(config_t *config, const char *section,
+			       const char *name, const char *value)
+{
+	struct config_item *item = get_item(config, section, name, true);
+	bfree(item->default_value);
+	item->default_value = bstrdup(value ? value : "");
+}
+
+const char *config_get_string(config_t *config, const char *section,
+			      const char *name)
+{
+	struct config_item *item = get_item(config, section, name, false);
+	if (!item)
+		return NULL;
+	return item->value ? item->value : item->default_value;
+}
+
+void config_set_int(config_t *config, const char *section, const char *name,
+		    int64_t value)
+{
+	char str[32];
+	snprintf(str, sizeof(str), "%lld", (long long)value);
+	config_set_string(config, section, name, str);
+}
+
+void config_set_uint(config_t *config, const char *section, const char *name,
+		     uint64_t value)
+{
+	char str[32];
+	snprintf(str, sizeof(str), "%llu", (unsigned long long)value);
+	config_set_string(config, section, name, str);
+}
+
+void config_set_bool(config_t *config, const char *section, const char *name,
+		     bool value)
+{
+	config_set_string(config, section, name, value ? "true" : "false");
+}
+
+void config_set_default_int(config_t *config, const char *section,
+			    const char *name, int64_t value)
+{
+	char str[32];
+	snprintf(str, sizeof(str), "%lld", (long long)value);
+	config_set_default_string(config, section, name, str);
+}
+
+void config_set_default_uint(config_t *config, const char *section,
+			     const char *name, uint64_t value)
+{
+	char str[32];
+	snprintf(str, sizeof(str), "%llu", (unsigned long long)value);
+	config_set_default_string(config, section, name, str);
+}
+
+void config_set_default_bool(config_t *config, const char *section,
+			     const char *name, bool value)
+{
+	config_set_default_string(config, section, name,
+				  value ? "true" : "false");
+}
+
+int64_t config_get_int(config_t *config, const char *section,
+		       const char *name)
+{
+	const char *value = config_get_string(config, section, name);
+	return value ? strtoll(value, NULL, 10) : 0;
+}
+
+uint64_t config_get_uint(config_t *config, const char *section,
+			 const char *name)
+{
+	const char *value = config_get_string(config, section, name);
+	return value ? strtoull(value, NULL, 10) : 0;
+}
+
+bool config_get_bool(config_t *config, const char *section, const char *name)
+{
+	const char *value = config_get_string(config, section, name);
+	if (!value)
+		return false;
+	return astrcmpi(value, "true") == 0 || strtoul(value, NULL, 10) != 0;
+}
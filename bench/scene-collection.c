@@ -0,0 +1,406 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <standin.h>
+
+#include "scene-collection.h"
+#include "source-types.h"
+
+/* loaded before the other sources, in the order of the frontend */
+static const char *audio_devices[] = {
+	"DesktopAudioDevice1", "DesktopAudioDevice2", "AuxAudioDevice1",
+	"AuxAudioDevice2",     "AuxAudioDevice3",     "AuxAudioDevice4",
+};
+
+struct pending_scene {
+	obs_scene_t *scene;
+	obs_data_t *settings;
+};
+
+typedef DARRAY(struct pending_scene) pending_scenes_t;
+
+static void load_audio(obs_source_t *source, obs_data_t *data)
+{
+	if (obs_data_has_user_value(data, "volume"))
+		obs_source_set_volume(
+			source, (float)obs_data_get_double(data, "volume"));
+	if (obs_data_has_user_value(data, "balance"))
+		obs_source_set_balance_value(
+			source, (float)obs_data_get_double(data, "balance"));
+	if (obs_data_has_user_value(data, "mixers"))
+		obs_source_set_audio_mixers(
+			source, (uint32_t)obs_data_get_int(data, "mixers"));
+
+	obs_source_set_muted(source, obs_data_get_bool(data, "muted"));
+	obs_source_set_sync_offset(source, obs_data_get_int(data, "sync"));
+	obs_source_set_monitoring_type(
+		source, (enum obs_monitoring_type)obs_data_get_int(
+				data, "monitoring_type"));
+}
+
+static obs_source_t *load_source(struct scene_collection *collection,
+				 pending_scenes_t *scenes, obs_data_t *data)
+{
+	const char *id = obs_data_get_string(data, "id");
+	const char *name = obs_data_get_string(data, "name");
+	obs_data_t *settings = obs_data_get_obj(data, "settings");
+	obs_source_t *source;
+
+	if (source_types_ensure(id) == OBS_SOURCE_TYPE_SCENE) {
+		// the items are added once all sources exist
+		struct pending_scene pending = {obs_scene_create(name),
+						settings};
+		da_push_back(*scenes, &pending);
+		source = obs_scene_get_source(pending.scene);
+	} else {
+		source = obs_source_create(id, name, settings, NULL);
+		obs_data_release(settings);
+		load_audio(source, data);
+	}
+
+	struct loaded_source loaded = {source, bstrdup(id)};
+	da_push_back(collection->sources, &loaded);
+
+	if (obs_data_has_user_value(data, "enabled"))
+		obs_source_set_enabled(source,
+				       obs_data_get_bool(data, "enabled"));
+
+	obs_data_array_t *filters = obs_data_get_array(data, "filters");
+	for (size_t i = 0; i < obs_data_array_count(filters); i++) {
+		obs_data_t *filter_data = obs_data_array_item(filters, i);
+		obs_source_t *filter =
+			load_source(collection, scenes, filter_data);
+		obs_source_filter_add(source, filter);
+		obs_data_release(filter_data);
+	}
+	obs_data_array_release(filters);
+	return source;
+}
+
+static void load_sources(struct scene_collection *collection,
+			 pending_scenes_t *scenes, obs_data_array_t *array)
+{
+	for (size_t i = 0; i < obs_data_array_count(array); i++) {
+		obs_data_t *data = obs_data_array_item(array, i);
+		load_source(collection, scenes, data);
+		obs_data_release(data);
+	}
+}
+
+static void load_item_transition(obs_sceneitem_t *item, bool show,
+				 obs_data_t *item_data)
+{
+	obs_data_t *data = obs_data_get_obj(
+		item_data, show ? "show_transition" : "hide_transition");
+	const char *id = obs_data_get_string(data, "id");
+	if (*id && source_types_ensure(id) == OBS_SOURCE_TYPE_TRANSITION) {
+		obs_data_t *settings = obs_data_get_obj(data, "transition");
+		obs_source_t *transition = obs_source_create_private(
+			id, obs_data_get_string(data, "name"), settings);
+		obs_sceneitem_set_transition(item, show, transition);
+		long long duration = obs_data_get_int(data, "duration");
+		obs_sceneitem_set_transition_duration(item, show,
+						      (uint32_t)duration);
+		obs_source_release(transition);
+		obs_data_release(settings);
+	}
+	obs_data_release(data);
+}
+
+static void load_item(obs_scene_t *scene, obs_data_t *data)
+{
+	const char *name = obs_data_get_string(data, "name");
+	obs_source_t *source = obs_get_source_by_name(name);
+	obs_sceneitem_t *item = standin_scene_load_item(scene, source);
+	obs_source_release(source);
+	if (!item) {
+		blog(LOG_WARNING, "Scene item '%s' has no source", name);
+		return;
+	}
+
+	struct obs_transform_info info;
+	obs_sceneitem_get_info(item, &info);
+	obs_data_get_vec2(data, "pos", &info.pos);
+	info.rot = (float)obs_data_get_double(data, "rot");
+	if (obs_data_has_user_value(data, "scale"))
+		obs_data_get_vec2(data, "scale", &info.scale);
+	info.alignment = (uint32_t)obs_data_get_int(data, "align");
+	info.bounds_type =
+		(enum obs_bounds_type)obs_data_get_int(data, "bounds_type");
+	info.bounds_alignment =
+		(uint32_t)obs_data_get_int(data, "bounds_align");
+	obs_data_get_vec2(data, "bounds", &info.bounds);
+	obs_sceneitem_set_info(item, &info);
+
+	struct obs_sceneitem_crop crop = {
+		.left = (int)obs_data_get_int(data, "crop_left"),
+		.top = (int)obs_data_get_int(data, "crop_top"),
+		.right = (int)obs_data_get_int(data, "crop_right"),
+		.bottom = (int)obs_data_get_int(data, "crop_bottom"),
+	};
+	obs_sceneitem_set_crop(item, &crop);
+
+	if (obs_data_has_user_value(data, "visible"))
+		obs_sceneitem_set_visible(item,
+					  obs_data_get_bool(data, "visible"));
+	load_item_transition(item, true, data);
+	load_item_transition(item, false, data);
+}
+
+static void load_items(pending_scenes_t *scenes)
+{
+	for (size_t i = 0; i < scenes->num; i++) {
+		struct pending_scene *pending = &scenes->array[i];
+		obs_data_array_t *items =
+			obs_data_get_array(pending->settings, "items");
+		for (size_t j = 0; j < obs_data_array_count(items); j++) {
+			obs_data_t *data = obs_data_array_item(items, j);
+			load_item(pending->scene, data);
+			obs_data_release(data);
+		}
+		obs_data_array_release(items);
+		obs_data_release(pending->settings);
+	}
+}
+
+static void select_program_scene(obs_data_t *data)
+{
+	const char *name = obs_data_get_string(data, "current_program_scene");
+	if (!*name)
+		name = obs_data_get_string(data, "current_scene");
+
+	obs_source_t *scene = obs_get_source_by_name(name);
+	standin_select_scenes(scene, NULL);
+	obs_source_release(scene);
+}
+
+bool scene_collection_load(struct scene_collection *collection,
+			   const char *path)
+{
+	obs_data_t *data = obs_data_create_from_json_file_safe(path, "bak");
+	if (!data)
+		return false;
+
+	pending_scenes_t scenes;
+	da_init(scenes);
+
+	for (size_t i = 0; i < OBS_COUNTOF(audio_devices); i++) {
+		obs_data_t *device = obs_data_get_obj(data, audio_devices[i]);
+		if (device)
+			load_source(collection, &scenes, device);
+		obs_data_release(device);
+	}
+
+	obs_data_array_t *sources = obs_data_get_array(data, "sources");
+	obs_data_array_t *groups = obs_data_get_array(data, "groups");
+	load_sources(collection, &scenes, sources);
+	load_sources(collection, &scenes, groups);
+	obs_data_array_release(sources);
+	obs_data_array_release(groups);
+
+	load_items(&scenes);
+	da_free(scenes);
+	select_program_scene(data);
+
+	obs_data_t *modules = obs_data_get_obj(data, "modules");
+	if (!modules)
+		modules = obs_data_create();
+	standin_frontend_save(modules, false);
+	obs_data_release(modules);
+
+	obs_data_release(data);
+	return true;
+}
+
+void scene_collection_free(struct scene_collection *collection)
+{
+	for (size_t i = 0; i < collection->sources.num; i++) {
+		obs_source_release(collection->sources.array[i].source);
+		bfree(collection->sources.array[i].id);
+	}
+	da_free(collection->sources);
+}
+
+/* ------------------------------------------------------------------------- */
+
+static obs_data_t *save_source(obs_source_t *source, obs_data_t *settings);
+
+static void save_filter(obs_source_t *parent, obs_source_t *filter,
+			void *param)
+{
+	UNUSED_PARAMETER(parent);
+	obs_data_t *settings = obs_source_get_settings(filter);
+	obs_data_t *data = save_source(filter, settings);
+	obs_data_array_push_back(param, data);
+	obs_data_release(data);
+	obs_data_release(settings);
+}
+
+static obs_data_t *save_source(obs_source_t *source, obs_data_t *settings)
+{
+	obs_data_t *data = obs_data_create();
+	obs_data_set_string(data, "id", obs_source_get_unversioned_id(source));
+	obs_data_set_string(data, "versioned_id", obs_source_get_id(source));
+	obs_data_set_string(data, "name", obs_source_get_name(source));
+	obs_data_set_obj(data, "settings", settings);
+	obs_data_set_bool(data, "enabled", obs_source_enabled(source));
+
+	obs_data_set_double(data, "volume", obs_source_get_volume(source));
+	obs_data_set_double(data, "balance",
+			    obs_source_get_balance_value(source));
+	obs_data_set_bool(data, "muted", obs_source_muted(source));
+	obs_data_set_int(data, "sync", obs_source_get_sync_offset(source));
+	obs_data_set_int(data, "mixers", obs_source_get_audio_mixers(source));
+	obs_data_set_int(data, "monitoring_type",
+			 obs_source_get_monitoring_type(source));
+
+	if (obs_source_get_type(source) != OBS_SOURCE_TYPE_FILTER) {
+		obs_data_array_t *filters = obs_data_array_create();
+		obs_source_enum_filters(source, save_filter, filters);
+		obs_data_set_array(data, "filters", filters);
+		obs_data_array_release(filters);
+	}
+	return data;
+}
+
+static void save_item_transition(obs_sceneitem_t *item, bool show,
+				 obs_data_t *item_data)
+{
+	obs_source_t *transition = obs_sceneitem_get_transition(item, show);
+	if (!transition)
+		return;
+
+	obs_data_t *data = obs_data_create();
+	obs_data_t *settings = obs_source_get_settings(transition);
+	obs_data_set_string(data, "id",
+			    obs_source_get_unversioned_id(transition));
+	obs_data_set_string(data, "versioned_id",
+			    obs_source_get_id(transition));
+	obs_data_set_string(data, "name", obs_source_get_name(transition));
+	obs_data_set_obj(data, "transition", settings);
+	obs_data_set_int(data, "duration",
+			 obs_sceneitem_get_transition_duration(item, show));
+	obs_data_set_obj(item_data,
+			 show ? "show_transition" : "hide_transition", data);
+	obs_data_release(settings);
+	obs_data_release(data);
+}
+
+static bool save_item(obs_scene_t *scene, obs_sceneitem_t *item, void *param)
+{
+	UNUSED_PARAMETER(scene);
+	struct obs_transform_info info;
+	struct obs_sceneitem_crop crop;
+	obs_sceneitem_get_info(item, &info);
+	obs_sceneitem_get_crop(item, &crop);
+
+	obs_source_t *source = obs_sceneitem_get_source(item);
+	obs_data_t *data = obs_data_create();
+	obs_data_set_string(data, "name", obs_source_get_name(source));
+	obs_data_set_int(data, "id", obs_sceneitem_get_id(item));
+	obs_data_set_bool(data, "visible", obs_sceneitem_visible(item));
+	obs_data_set_vec2(data, "pos", &info.pos);
+	obs_data_set_double(data, "rot", info.rot);
+	obs_data_set_vec2(data, "scale", &info.scale);
+	obs_data_set_int(data, "align", info.alignment);
+	obs_data_set_int(data, "bounds_type", info.bounds_type);
+	obs_data_set_int(data, "bounds_align", info.bounds_alignment);
+	obs_data_set_vec2(data, "bounds", &info.bounds);
+	obs_data_set_int(data, "crop_left", crop.left);
+	obs_data_set_int(data, "crop_top", crop.top);
+	obs_data_set_int(data, "crop_right", crop.right);
+	obs_data_set_int(data, "crop_bottom", crop.bottom);
+	save_item_transition(item, true, data);
+	save_item_transition(item, false, data);
+
+	obs_data_array_push_back(param, data);
+	obs_data_release(data);
+	return true;
+}
+
+struct save_context {
+	obs_data_array_t *sources;
+	obs_data_array_t *scene_order;
+};
+
+static bool save_input(void *param, obs_source_t *source)
+{
+	struct save_context *context = param;
+	obs_data_t *settings = obs_source_get_settings(source);
+	obs_data_t *data = save_source(source, settings);
+	obs_data_array_push_back(context->sources, data);
+	obs_data_release(data);
+	obs_data_release(settings);
+	return true;
+}
+
+/* A scene's items are in its settings, next to nothing else */
+static bool save_scene(void *param, obs_source_t *source)
+{
+	struct save_context *context = param;
+	obs_data_t *settings = obs_data_create();
+	obs_data_array_t *items = obs_data_array_create();
+	obs_scene_enum_items(obs_scene_from_source(source), save_item, items);
+	obs_data_set_array(settings, "items", items);
+
+	obs_data_t *data = save_source(source, settings);
+	obs_data_array_push_back(context->sources, data);
+	obs_data_release(data);
+
+	data = obs_data_create();
+	obs_data_set_string(data, "name", obs_source_get_name(source));
+	obs_data_array_push_back(context->scene_order, data);
+	obs_data_release(data);
+
+	obs_data_array_release(items);
+	obs_data_release(settings);
+	return true;
+}
+
+bool scene_collection_save(const char *path, const char *name)
+{
+	struct save_context context = {
+		.sources = obs_data_array_create(),
+		.scene_order = obs_data_array_create(),
+	};
+	obs_enum_scenes(save_scene, &context);
+	obs_enum_sources(save_input, &context);
+
+	obs_data_t *data = obs_data_create();
+	obs_data_set_string(data, "name", name);
+	obs_data_set_array(data, "sources", context.sources);
+	obs_data_set_array(data, "scene_order", context.scene_order);
+
+	obs_source_t *scene = obs_frontend_get_current_scene();
+	obs_data_set_string(data, "current_scene",
+			    scene ? obs_source_get_name(scene) : "");
+	obs_data_set_string(data, "current_program_scene",
+			    scene ? obs_source_get_name(scene) : "");
+	obs_source_release(scene);
+
+	obs_data_t *modules = obs_data_create();
+	standin_frontend_save(modules, true);
+	obs_data_set_obj(data, "modules", modules);
+	obs_data_release(modules);
+
+	bool saved = obs_data_save_json_safe(data, path, "tmp", "bak");
+	obs_data_release(data);
+	obs_data_array_release(context.sources);
+	obs_data_array_release(context.scene_order);
+	return saved;
+}
@@ -0,0 +1,53 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <obs.h>
+#include <util/darray.h>
+
+/**
+ * Reads and writes scene collections in the format of the OBS frontend, so
+ * a replay can start from the collection a trace was recorded with. Only
+ * what the plugin looks at is kept: sources with their settings, audio and
+ * filters, scenes with their items, the program scene and the module data
+ * of the save callbacks.
+ */
+
+struct loaded_source {
+	obs_source_t *source;
+	char *id; // unversioned, as in the file
+};
+
+struct scene_collection {
+	/* sources, scenes and filters, in the order they were created */
+	DARRAY(struct loaded_source) sources;
+};
+
+/**
+ * Creates the sources of a collection file like the frontend loads it,
+ * without the item_add signals, then runs the save callbacks with the
+ * module data. Returns false if the file can't be read.
+ */
+extern bool scene_collection_load(struct scene_collection *collection,
+				  const char *path);
+/* Releases the references of the loaded sources */
+extern void scene_collection_free(struct scene_collection *collection);
+
+/* Saves every scene and input that exists, and the module data */
+extern bool scene_collection_save(const char *path, const char *name);
@@ -0,0 +1,441 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <obs-module.h>
+#include <standin.h>
+#include <util/dstr.h>
+#include <util/platform.h>
+
+#include "bench-stats.h"
+#include "scene-collection.h"
+
+/**
+ * Creates bursts of sources in a collection with default sources, the way
+ * dropping a folder of files or pasting a block of sources does, and prints
+ * how long the plugin's callbacks took. See README.md.
+ */
+
+// a frame without any work left ends the burst
+#define FRAME_SECONDS (1.0f / 60.0f)
+#define MAX_FRAMES_PER_BURST 6000
+
+struct input_type {
+	const char *id;
+	uint32_t output_flags;
+	const char *filters[3];
+};
+
+/* clang-format off */
+
+static const struct input_type input_types[] = {
+	{"ffmpeg_source", OBS_SOURCE_ASYNC_VIDEO | OBS_SOURCE_AUDIO,
+	 {"color_filter", "clut_filter", "gain_filter"}},
+	{"image_source", OBS_SOURCE_VIDEO,
+	 {"crop_filter", "color_filter", "clut_filter"}},
+	{"color_source_v3", OBS_SOURCE_VIDEO,
+	 {"crop_filter", "color_filter", "scroll_filter"}},
+	{"wasapi_input_capture", OBS_SOURCE_AUDIO,
+	 {"gain_filter", "noise_suppress_filter", "compressor_filter"}},
+};
+
+static const struct {
+	const char *id;
+	uint32_t output_flags;
+} filter_types[] = {
+	{"color_filter", OBS_SOURCE_VIDEO},
+	{"crop_filter", OBS_SOURCE_VIDEO},
+	{"scroll_filter", OBS_SOURCE_VIDEO},
+	{"clut_filter", OBS_SOURCE_VIDEO},
+	{"gain_filter", OBS_SOURCE_AUDIO},
+	{"compressor_filter", OBS_SOURCE_AUDIO},
+	{"noise_suppress_filter", OBS_SOURCE_AUDIO},
+};
+
+/* clang-format on */
+
+struct bench_options {
+	size_t scenes;
+	size_t defaults;
+	size_t filters;
+	size_t creations;
+	size_t bursts;
+	size_t warmup;
+	uint32_t gap_ms;
+	unsigned int seed;
+	bool trace;
+	const char *collection_path;
+	bool verbose;
+};
+
+struct bench {
+	struct bench_options options;
+	DARRAY(obs_scene_t *) scenes;
+	obs_scene_t *defaults_scene;
+	size_t frames;
+	size_t created;
+};
+
+static void usage(const char *name)
+{
+	fprintf(stderr,
+		"Usage: %s [options]\n"
+		"  -s N   scenes that sources are created in (8)\n"
+		"  -d M   default sources with a Source Defaults filter (4)\n"
+		"  -f F   other filters on every default source, up to 3 (3)\n"
+		"  -k K   sources created per burst (50)\n"
+		"  -b B   measured bursts (20)\n"
+		"  -w W   bursts before measuring (2)\n"
+		"  -g MS  pause between bursts, longer than a burst window"
+		" (150)\n"
+		"  -r S   seed for picking the scenes and types (1)\n"
+		"  -t     trace the events, for source-defaults-replay\n"
+		"  -o F   save the collection to F, to replay the trace with\n"
+		"  -v     show the plugin's log\n",
+		name);
+}
+
+static bool parse_size(const char *arg, size_t *val, size_t min)
+{
+	char *end;
+	unsigned long long parsed = strtoull(arg, &end, 10);
+	if (*end || parsed < min)
+		return false;
+
+	*val = (size_t)parsed;
+	return true;
+}
+
+static bool parse_options(int argc, char **argv, struct bench_options *options)
+{
+	size_t gap_ms = 150;
+	size_t seed = 1;
+	int opt;
+
+	*options = (struct bench_options){
+		.scenes = 8,
+		.defaults = 4,
+		.filters = 3,
+		.creations = 50,
+		.bursts = 20,
+		.warmup = 2,
+	};
+
+	while ((opt = getopt(argc, argv, "s:d:f:k:b:w:g:r:to:v")) != -1) {
+		bool valid = true;
+		switch (opt) {
+		case 's':
+			valid = parse_size(optarg, &options->scenes, 1);
+			break;
+		case 'd':
+			valid = parse_size(optarg, &options->defaults, 0);
+			break;
+		case 'f':
+			valid = parse_size(optarg, &options->filters, 0) &&
+				options->filters <= 3;
+			break;
+		case 'k':
+			valid = parse_size(optarg, &options->creations, 1);
+			break;
+		case 'b':
+			valid = parse_size(optarg, &options->bursts, 1);
+			break;
+		case 'w':
+			valid = parse_size(optarg, &options->warmup, 0);
+			break;
+		case 'g':
+			valid = parse_size(optarg, &gap_ms, 0);
+			break;
+		case 'r':
+			valid = parse_size(optarg, &seed, 0);
+			break;
+		case 't':
+			options->trace = true;
+			break;
+		case 'o':
+			options->collection_path = optarg;
+			break;
+		case 'v':
+			options->verbose = true;
+			break;
+		default:
+			valid = false;
+		}
+		if (!valid)
+			return false;
+	}
+
+	options->gap_ms = (uint32_t)gap_ms;
+	options->seed = (unsigned int)seed;
+	return optind == argc;
+}
+
+static void register_types(void)
+{
+	for (size_t i = 0; i < OBS_COUNTOF(input_types); i++)
+		standin_register_input(input_types[i].id,
+				       input_types[i].output_flags);
+	for (size_t i = 0; i < OBS_COUNTOF(filter_types); i++)
+		standin_register_filter(filter_types[i].id,
+					filter_types[i].output_flags);
+	standin_register_transition("fade_transition");
+}
+
+static void add_item_transition(obs_sceneitem_t *item, bool show)
+{
+	obs_source_t *transition = obs_source_create_private(
+		"fade_transition", show ? "Show" : "Hide", NULL);
+	obs_sceneitem_set_transition(item, show, transition);
+	obs_sceneitem_set_transition_duration(item, show, 300);
+	obs_source_release(transition);
+}
+
+static void add_filter(obs_source_t *source, const char *id, const char *name,
+		       obs_data_t *settings)
+{
+	obs_source_t *filter = obs_source_create(id, name, settings, NULL);
+	obs_source_filter_add(source, filter);
+	obs_source_release(filter);
+}
+
+/**
+ * Defaults of the same type after the first one get a name rule, so that
+ * creations are spread over all of them: "* #1", "* #2" and so on.
+ */
+static void create_default_source(struct bench *bench, size_t idx)
+{
+	const struct input_type *type =
+		&input_types[idx % OBS_COUNTOF(input_types)];
+	size_t rule = idx / OBS_COUNTOF(input_types);
+	struct dstr name = {0};
+	dstr_printf(&name, "Default %s %zu", type->id, rule);
+
+	obs_source_t *source = obs_source_create(type->id, name.array, NULL,
+						 NULL);
+	obs_source_set_volume(source, 0.5f);
+
+	obs_sceneitem_t *item = obs_scene_add(bench->defaults_scene, source);
+	struct obs_transform_info info;
+	obs_sceneitem_get_info(item, &info);
+	info.pos.x = 100.0f;
+	info.pos.y = 50.0f;
+	info.scale.x = 0.5f;
+	info.scale.y = 0.5f;
+	obs_sceneitem_set_info(item, &info);
+	add_item_transition(item, true);
+	add_item_transition(item, false);
+
+	for (size_t i = 0; i < bench->options.filters; i++)
+		add_filter(source, type->filters[i], type->filters[i], NULL);
+
+	obs_data_t *settings = obs_data_create();
+	obs_data_set_string(settings, "parent_scene", "Defaults");
+	obs_data_set_bool(settings, "defer_expensive_filters", true);
+	if (rule) {
+		dstr_printf(&name, "* #%zu", rule);
+		obs_data_set_string(settings, "match_name", name.array);
+	}
+	bool audio = (type->output_flags & OBS_SOURCE_AUDIO) != 0;
+	add_filter(source,
+		   audio ? "source_defaults_audio" : "source_defaults_video",
+		   "Source Defaults", settings);
+	obs_data_release(settings);
+
+	obs_source_release(source);
+	dstr_free(&name);
+}
+
+/* Like loading a scene collection: the plugin resolves the filters later */
+static void create_collection(struct bench *bench)
+{
+	struct dstr name = {0};
+	for (size_t i = 0; i < bench->options.scenes; i++) {
+		dstr_printf(&name, "Scene %zu", i + 1);
+		obs_scene_t *scene = obs_scene_create(name.array);
+		da_push_back(bench->scenes, &scene);
+	}
+	dstr_free(&name);
+
+	bench->defaults_scene = obs_scene_create("Defaults");
+	for (size_t i = 0; i < bench->options.defaults; i++)
+		create_default_source(bench, i);
+
+	standin_set_current_scene(obs_scene_get_source(bench->scenes.array[0]));
+	standin_frontend_event(OBS_FRONTEND_EVENT_FINISHED_LOADING);
+}
+
+/* Runs frames until one of them has nothing left to do */
+static void settle(struct bench *bench)
+{
+	size_t idle = 0;
+	for (size_t i = 0; i < MAX_FRAMES_PER_BURST && idle < 2; i++) {
+		standin_tick(FRAME_SECONDS);
+		idle = standin_run_ui_tasks() ? 0 : idle + 1;
+		bench->frames++;
+	}
+}
+
+static void run_burst(struct bench *bench, size_t burst)
+{
+	const struct bench_options *options = &bench->options;
+	size_t num_rules = (options->defaults + OBS_COUNTOF(input_types) - 1) /
+			   OBS_COUNTOF(input_types);
+	struct dstr name = {0};
+
+	obs_scene_t *scene =
+		bench->scenes.array[(size_t)rand() % bench->scenes.num];
+	standin_set_current_scene(obs_scene_get_source(scene));
+	standin_run_ui_tasks();
+
+	uint64_t start = os_gettime_ns();
+	for (size_t i = 0; i < options->creations; i++) {
+		size_t type_idx = (size_t)rand() % OBS_COUNTOF(input_types);
+		const struct input_type *type = &input_types[type_idx];
+		dstr_printf(&name, "Source %zu-%zu", burst, i);
+		if (num_rules > 1)
+			dstr_catf(&name, " #%zu", (size_t)rand() % num_rules);
+
+		// the frontend creates the source, then adds it to the scene
+		obs_source_t *source =
+			obs_source_create(type->id, name.array, NULL, NULL);
+		obs_scene_add(scene, source);
+		obs_source_release(source);
+		bench->created++;
+	}
+	bench_stats_record("burst_created", os_gettime_ns() - start);
+
+	settle(bench);
+	bench_stats_record("burst_settled", os_gettime_ns() - start);
+	dstr_free(&name);
+}
+
+struct defaults_count {
+	size_t sources;
+	size_t with_filters;
+};
+
+static bool count_defaults(obs_scene_t *scene, obs_sceneitem_t *item,
+			   void *param)
+{
+	UNUSED_PARAMETER(scene);
+	struct defaults_count *count = param;
+	count->sources++;
+	if (obs_source_filter_count(obs_sceneitem_get_source(item)))
+		count->with_filters++;
+	return true;
+}
+
+/* Only the creations are counted, the defaults are in their own scene */
+static void print_defaults_count(struct bench *bench)
+{
+	struct defaults_count count = {0};
+	for (size_t i = 0; i < bench->scenes.num; i++)
+		obs_scene_enum_items(bench->scenes.array[i], count_defaults,
+				     &count);
+	printf("%zu of %zu sources got the filters of their default source\n",
+	       count.with_filters, count.sources);
+}
+
+static bool remove_item_source(obs_scene_t *scene, obs_sceneitem_t *item,
+			       void *param)
+{
+	UNUSED_PARAMETER(scene);
+	UNUSED_PARAMETER(param);
+	obs_source_remove(obs_sceneitem_get_source(item));
+	return true;
+}
+
+/* Like closing the scene collection */
+static void free_collection(struct bench *bench)
+{
+	standin_frontend_event(OBS_FRONTEND_EVENT_SCENE_COLLECTION_CHANGING);
+	standin_set_current_scene(NULL);
+
+	da_push_back(bench->scenes, &bench->defaults_scene);
+	for (size_t i = 0; i < bench->scenes.num; i++) {
+		obs_scene_t *scene = bench->scenes.array[i];
+		obs_scene_enum_items(scene, remove_item_source, NULL);
+		obs_source_remove(obs_scene_get_source(scene));
+		obs_scene_release(scene);
+	}
+	da_free(bench->scenes);
+	standin_run_ui_tasks();
+}
+
+int main(int argc, char **argv)
+{
+	struct bench bench = {0};
+	if (!parse_options(argc, argv, &bench.options)) {
+		usage(argv[0]);
+		return 2;
+	}
+
+	const struct bench_options *options = &bench.options;
+	srand(options->seed);
+
+	standin_startup();
+	standin_set_log_level(options->verbose ? LOG_INFO : LOG_WARNING);
+	standin_set_config_dir("source-defaults-bench-config");
+	register_types();
+	bench_stats_init();
+	if (options->trace)
+		config_set_bool(obs_frontend_get_global_config(),
+				"SourceDefaults", "TraceEvents", true);
+
+	obs_module_load();
+	create_collection(&bench);
+	settle(&bench);
+	if (options->collection_path &&
+	    !scene_collection_save(options->collection_path, "Bench"))
+		fprintf(stderr, "Failed to save the collection to '%s'\n",
+			options->collection_path);
+
+	printf("%zu scenes, %zu default sources with %zu filters, "
+	       "%zu bursts of %zu sources\n\n",
+	       options->scenes, options->defaults, options->filters,
+	       options->bursts, options->creations);
+
+	for (size_t i = 0; i < options->warmup + options->bursts; i++) {
+		if (i == options->warmup) {
+			bench_stats_reset();
+			bench.frames = 0;
+			bench.created = 0;
+		}
+		os_sleep_ms(options->gap_ms);
+		run_burst(&bench, i);
+	}
+
+	bench_stats_print();
+	printf("\n%zu sources created, %.1f frames per burst\n", bench.created,
+	       (double)bench.frames / (double)options->bursts);
+	if (options->filters)
+		print_defaults_count(&bench);
+
+	free_collection(&bench);
+	obs_module_unload();
+	bench_stats_free();
+
+	long leaks = standin_shutdown();
+	if (leaks) {
+		fprintf(stderr, "%ld allocations were not freed\n", leaks);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,545 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <obs-module.h>
+#include <standin.h>
+#include <util/dstr.h>
+#include <util/platform.h>
+
+#include "event-trace.h"
+#include "bench-stats.h"
+#include "scene-collection.h"
+#include "source-types.h"
+
+/**
+ * Feeds an event trace of the plugin (TraceEvents=true) back through its
+ * callbacks, at the pace it was recorded, and prints how long they took
+ * next to the times in the trace. See README.md.
+ */
+
+#define FRAME_SECONDS (1.0f / 60.0f)
+#define FRAME_NS 16666667ULL
+#define MAX_SETTLE_FRAMES 6000
+
+/* clang-format off */
+
+/* same order as enum trace_event */
+static const char *event_names[] = {
+	"source_create",
+	"source_destroy",
+	"source_rename",
+	"item_add",
+	"frontend",
+};
+
+/* clang-format on */
+
+struct trace_line {
+	uint64_t time_ns;
+	enum trace_event event;
+	size_t source;
+	char type[64];
+	size_t scene;
+	uint64_t handler_ns;
+};
+
+struct traced_source {
+	obs_source_t *source;
+	bool skipped; // filters, the plugin creates its own copies
+};
+
+struct recorded_time {
+	const char *name;
+	uint64_t ns;
+};
+
+struct replay_options {
+	const char *trace_path;
+	const char *collection_path;
+	uint64_t max_pause_ns;
+	bool no_pauses;
+	bool verbose;
+};
+
+struct replay {
+	struct replay_options options;
+	DARRAY(struct trace_line) lines;
+	DARRAY(struct traced_source) ids; // by trace id
+	DARRAY(struct recorded_time) recorded;
+	size_t first_line; // the ones before are the loaded collection
+	size_t mapped;
+	size_t placeholders;
+	size_t skipped;
+	size_t renames;
+	size_t frames;
+};
+
+static void usage(const char *name)
+{
+	fprintf(stderr,
+		"Usage: %s [options] TRACE\n"
+		"  -c FILE  scene collection (.json) the trace was recorded"
+		" with\n"
+		"  -m MS    longest pause kept between events, 0 keeps none"
+		" (500)\n"
+		"  -n       no pauses, frames still run every 16.7 ms of"
+		" trace\n"
+		"  -v       show the plugin's log\n",
+		name);
+}
+
+static bool parse_options(int argc, char **argv, struct replay_options *options)
+{
+	unsigned long long max_pause_ms = 500;
+	int opt;
+
+	*options = (struct replay_options){0};
+	while ((opt = getopt(argc, argv, "c:m:nv")) != -1) {
+		char *end = NULL;
+		switch (opt) {
+		case 'c':
+			options->collection_path = optarg;
+			break;
+		case 'm':
+			max_pause_ms = strtoull(optarg, &end, 10);
+			if (*end)
+				return false;
+			break;
+		case 'n':
+			options->no_pauses = true;
+			break;
+		case 'v':
+			options->verbose = true;
+			break;
+		default:
+			return false;
+		}
+	}
+	if (optind != argc - 1)
+		return false;
+
+	options->trace_path = argv[optind];
+	options->max_pause_ns = max_pause_ms * 1000000ULL;
+	return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/* reading the trace */
+
+static bool parse_event(const char *name, enum trace_event *event)
+{
+	for (size_t i = 0; i < OBS_COUNTOF(event_names); i++) {
+		if (strcmp(event_names[i], name) == 0) {
+			*event = (enum trace_event)i;
+			return true;
+		}
+	}
+	return false;
+}
+
+static inline uint64_t us_to_ns(const char *us)
+{
+	return (uint64_t)(strtod(us, NULL) * 1000.0);
+}
+
+/* time_us, event, source, type, scene and handler_us, tab separated */
+static bool parse_line(char *text, struct trace_line *line)
+{
+	char *fields[6] = {text};
+	size_t count = 1;
+	for (char *c = text; *c && count < OBS_COUNTOF(fields); c++) {
+		if (*c == '\t') {
+			*c = 0;
+			fields[count++] = c + 1;
+		}
+	}
+	if (count != OBS_COUNTOF(fields) ||
+	    !parse_event(fields[1], &line->event) ||
+	    strlen(fields[3]) >= sizeof(line->type))
+		return false;
+
+	line->time_ns = us_to_ns(fields[0]);
+	line->source = (size_t)strtoull(fields[2], NULL, 10);
+	strcpy(line->type, fields[3]);
+	line->scene = (size_t)strtoull(fields[4], NULL, 10);
+	line->handler_ns = us_to_ns(fields[5]);
+	return true;
+}
+
+static bool read_trace(struct replay *replay)
+{
+	const char *path = replay->options.trace_path;
+	FILE *file = os_fopen(path, "r");
+	if (!file) {
+		fprintf(stderr, "Failed to open trace '%s'\n", path);
+		return false;
+	}
+
+	char text[512];
+	for (size_t number = 1; fgets(text, sizeof(text), file); number++) {
+		struct trace_line line = {0};
+		if (number == 1 && strncmp(text, "time_us\t", 8) == 0)
+			continue;
+		if (parse_line(text, &line))
+			da_push_back(replay->lines, &line);
+		else
+			fprintf(stderr, "%s:%zu: not an event\n", path, number);
+	}
+
+	fclose(file);
+	return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/* sources by trace id */
+
+static struct traced_source *get_traced(struct replay *replay, size_t id)
+{
+	if (id >= replay->ids.num)
+		da_resize(replay->ids, id + 1);
+	return &replay->ids.array[id];
+}
+
+/* Filters and transitions aren't created, the trace has no parent for them */
+static obs_source_t *create_source(size_t id, const char *type)
+{
+	struct dstr name = {0};
+	dstr_printf(&name, "%s %zu", type, id);
+	obs_source_t *source = NULL;
+
+	switch (source_types_ensure(type)) {
+	case OBS_SOURCE_TYPE_SCENE:
+		source = obs_scene_get_source(obs_scene_create(name.array));
+		break;
+	case OBS_SOURCE_TYPE_INPUT:
+		source = obs_source_create(type, name.array, NULL, NULL);
+		break;
+	default:
+		break;
+	}
+
+	dstr_free(&name);
+	return source;
+}
+
+/**
+ * The source with a trace id, created on first use if the trace doesn't
+ * have its creation, e.g. if it was loaded from a collection that wasn't
+ * given. Those creations aren't timed, they aren't part of the trace.
+ */
+static obs_source_t *resolve(struct replay *replay, size_t id,
+			     const char *type)
+{
+	if (!id || !*type)
+		return NULL;
+
+	struct traced_source *traced = get_traced(replay, id);
+	if (traced->source || traced->skipped)
+		return traced->source;
+
+	bench_stats_pause(true);
+	traced->source = create_source(id, type);
+	traced->skipped = !traced->source;
+	bench_stats_pause(false);
+	replay->placeholders++;
+	return traced->source;
+}
+
+static obs_scene_t *resolve_scene(struct replay *replay, size_t id)
+{
+	return obs_scene_from_source(resolve(replay, id, "scene"));
+}
+
+static void destroy_traced(struct replay *replay, size_t id)
+{
+	if (id >= replay->ids.num)
+		return;
+
+	obs_source_t *source = replay->ids.array[id].source;
+	replay->ids.array[id] = (struct traced_source){0};
+	if (!source)
+		return;
+
+	obs_source_t *parent = obs_filter_get_parent(source);
+	if (parent)
+		obs_source_filter_remove(parent, source);
+	obs_source_remove(source);
+	obs_source_release(source);
+}
+
+/**
+ * The sources created while the collection loaded are matched to the
+ * loaded ones of the same type, in order. Everything up to the first
+ * FINISHED_LOADING or SCENE_COLLECTION_CHANGED is the loading.
+ */
+static void map_collection(struct replay *replay,
+			   const struct scene_collection *collection)
+{
+	size_t end = 0;
+	for (; end < replay->lines.num; end++) {
+		const struct trace_line *line = &replay->lines.array[end];
+		int event = atoi(line->type);
+		if (line->event == TRACE_FRONTEND &&
+		    (event == OBS_FRONTEND_EVENT_FINISHED_LOADING ||
+		     event == OBS_FRONTEND_EVENT_SCENE_COLLECTION_CHANGED))
+			break;
+	}
+	if (end == replay->lines.num) {
+		fprintf(stderr, "The trace doesn't load a collection, "
+				"replaying all of it\n");
+		return;
+	}
+
+	bool *used = bzalloc(collection->sources.num * sizeof(bool));
+	for (size_t i = 0; i < end; i++) {
+		const struct trace_line *line = &replay->lines.array[i];
+		if (line->event != TRACE_SOURCE_CREATE)
+			continue;
+
+		for (size_t j = 0; j < collection->sources.num; j++) {
+			const struct loaded_source *loaded =
+				&collection->sources.array[j];
+			if (used[j] || strcmp(loaded->id, line->type) != 0)
+				continue;
+
+			used[j] = true;
+			get_traced(replay, line->source)->source =
+				obs_source_get_ref(loaded->source);
+			replay->mapped++;
+			break;
+		}
+	}
+	bfree(used);
+	replay->first_line = end;
+}
+
+static bool load_collection(struct replay *replay, const char *path)
+{
+	struct scene_collection collection = {0};
+	bench_stats_pause(true);
+	bool loaded = scene_collection_load(&collection, path);
+	if (loaded)
+		map_collection(replay, &collection);
+	else
+		fprintf(stderr, "Failed to load collection '%s'\n", path);
+	scene_collection_free(&collection);
+	bench_stats_pause(false);
+	return loaded;
+}
+
+/* ------------------------------------------------------------------------- */
+/* replaying */
+
+static void rename_traced(struct replay *replay,
+			  const struct trace_line *line)
+{
+	obs_source_t *source = resolve(replay, line->source, line->type);
+	if (!source)
+		return;
+
+	// the trace doesn't have the name, only that it changed
+	struct dstr name = {0};
+	dstr_printf(&name, "%s %zu.%zu", line->type, line->source,
+		    ++replay->renames);
+	obs_source_set_name(source, name.array);
+	dstr_free(&name);
+}
+
+/* Old traces don't have the scenes of frontend events, they keep theirs */
+static void frontend_event(struct replay *replay,
+			   const struct trace_line *line)
+{
+	obs_scene_t *program = resolve_scene(replay, line->source);
+	obs_scene_t *preview = resolve_scene(replay, line->scene);
+	if (program || preview)
+		standin_select_scenes(obs_scene_get_source(program),
+				      obs_scene_get_source(preview));
+
+	standin_frontend_event((enum obs_frontend_event)atoi(line->type));
+}
+
+/* Returns the name of the callback the plugin timed for this event */
+static const char *replay_line(struct replay *replay,
+			       const struct trace_line *line)
+{
+	struct traced_source *traced;
+
+	switch (line->event) {
+	case TRACE_SOURCE_CREATE:
+		traced = get_traced(replay, line->source);
+		if (traced->source || traced->skipped)
+			return NULL;
+
+		traced->source = create_source(line->source, line->type);
+		traced->skipped = !traced->source;
+		if (traced->skipped) {
+			replay->skipped++;
+			return NULL;
+		}
+		return "source_create";
+	case TRACE_SOURCE_DESTROY:
+		destroy_traced(replay, line->source);
+		return NULL;
+	case TRACE_SOURCE_RENAME:
+		rename_traced(replay, line);
+		return NULL;
+	case TRACE_ITEM_ADD:
+		obs_scene_add(resolve_scene(replay, line->scene),
+			      resolve(replay, line->source, line->type));
+		return "item_add";
+	case TRACE_FRONTEND:
+		frontend_event(replay, line);
+		return "frontend_event";
+	}
+	return NULL;
+}
+
+static void run_frame(struct replay *replay)
+{
+	standin_tick(FRAME_SECONDS);
+	standin_run_ui_tasks();
+	replay->frames++;
+}
+
+/**
+ * Every event runs at its time in the trace, minus what was cut from the
+ * pauses before it, with a frame every 16.7 ms in between. The times are
+ * when the handlers started, nested handlers can be out of order.
+ */
+static uint64_t replay_trace(struct replay *replay)
+{
+	const struct replay_options *options = &replay->options;
+	uint64_t start = os_gettime_ns();
+	uint64_t last = 0;
+	uint64_t offset = 0;
+	uint64_t next_frame = 0;
+
+	for (size_t i = replay->first_line; i < replay->lines.num; i++) {
+		const struct trace_line *line = &replay->lines.array[i];
+		if (i > replay->first_line && line->time_ns > last) {
+			uint64_t pause = line->time_ns - last;
+			offset += pause < options->max_pause_ns
+					  ? pause
+					  : options->max_pause_ns;
+		}
+		if (i == replay->first_line || line->time_ns > last)
+			last = line->time_ns;
+
+		for (; next_frame <= offset; next_frame += FRAME_NS) {
+			if (!options->no_pauses)
+				os_sleepto_ns(start + next_frame);
+			run_frame(replay);
+		}
+		if (!options->no_pauses)
+			os_sleepto_ns(start + offset);
+
+		const char *name = replay_line(replay, line);
+		if (name) {
+			struct recorded_time recorded = {name,
+							 line->handler_ns};
+			da_push_back(replay->recorded, &recorded);
+		}
+	}
+
+	size_t idle = 0;
+	for (size_t i = 0; i < MAX_SETTLE_FRAMES && idle < 2; i++) {
+		standin_tick(FRAME_SECONDS);
+		idle = standin_run_ui_tasks() ? 0 : idle + 1;
+		replay->frames++;
+	}
+	return offset;
+}
+
+/* Like closing the scene collection */
+static void free_sources(struct replay *replay)
+{
+	standin_frontend_event(OBS_FRONTEND_EVENT_SCENE_COLLECTION_CHANGING);
+	standin_select_scenes(NULL, NULL);
+
+	for (size_t id = 0; id < replay->ids.num; id++)
+		destroy_traced(replay, id);
+	da_free(replay->ids);
+	standin_run_ui_tasks();
+}
+
+static void print_results(struct replay *replay, uint64_t trace_ns,
+			  uint64_t replay_ns)
+{
+	printf("Replayed:\n");
+	bench_stats_print();
+
+	// the same table, with the times the trace has for the same events
+	bench_stats_reset();
+	for (size_t i = 0; i < replay->recorded.num; i++)
+		bench_stats_record(replay->recorded.array[i].name,
+				   replay->recorded.array[i].ns);
+	printf("\nRecorded:\n");
+	bench_stats_print();
+
+	printf("\n%zu events, %.1f s of trace replayed in %.1f s, %zu frames\n",
+	       replay->lines.num - replay->first_line,
+	       (double)trace_ns / 1e9, (double)replay_ns / 1e9,
+	       replay->frames);
+	printf("%zu sources from the collection, %zu created without their "
+	       "creation in the trace, %zu filter creations left to the "
+	       "plugin\n",
+	       replay->mapped, replay->placeholders, replay->skipped);
+}
+
+int main(int argc, char **argv)
+{
+	struct replay replay = {0};
+	if (!parse_options(argc, argv, &replay.options)) {
+		usage(argv[0]);
+		return 2;
+	}
+	if (!read_trace(&replay))
+		return 1;
+
+	standin_startup();
+	standin_set_log_level(replay.options.verbose ? LOG_INFO
+						     : LOG_WARNING);
+	standin_set_config_dir("source-defaults-replay-config");
+	bench_stats_init();
+	obs_module_load();
+
+	const char *collection_path = replay.options.collection_path;
+	bool loaded = !collection_path ||
+		      load_collection(&replay, collection_path);
+	if (loaded) {
+		uint64_t start = os_gettime_ns();
+		uint64_t trace_ns = replay_trace(&replay);
+		print_results(&replay, trace_ns, os_gettime_ns() - start);
+	}
+
+	free_sources(&replay);
+	obs_module_unload();
+	bench_stats_free();
+	da_free(replay.lines);
+	da_free(replay.recorded);
+
+	long leaks = standin_shutdown();
+	if (leaks) {
+		fprintf(stderr, "%ld allocations were not freed\n", leaks);
+		return 1;
+	}
+	return loaded ? 0 : 1;
+}
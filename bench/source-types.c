@@ -0,0 +1,114 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <string.h>
+#include <standin.h>
+
+#include "source-types.h"
+
+#define ASYNC_AV (OBS_SOURCE_ASYNC_VIDEO | OBS_SOURCE_AUDIO)
+
+struct known_type {
+	const char *id;
+	enum obs_source_type type;
+	uint32_t output_flags;
+};
+
+/* clang-format off */
+
+/* unversioned ids of the types that aren't guessed right from their name */
+static const struct known_type known_types[] = {
+	{"ffmpeg_source", OBS_SOURCE_TYPE_INPUT, ASYNC_AV},
+	{"vlc_source", OBS_SOURCE_TYPE_INPUT, ASYNC_AV},
+	{"dshow_input", OBS_SOURCE_TYPE_INPUT, ASYNC_AV},
+	{"av_capture_input", OBS_SOURCE_TYPE_INPUT, ASYNC_AV},
+	{"ndi_source", OBS_SOURCE_TYPE_INPUT, ASYNC_AV},
+	{"v4l2_input", OBS_SOURCE_TYPE_INPUT, OBS_SOURCE_ASYNC_VIDEO},
+	{"browser_source", OBS_SOURCE_TYPE_INPUT,
+	 OBS_SOURCE_VIDEO | OBS_SOURCE_AUDIO},
+	{"wasapi_input_capture", OBS_SOURCE_TYPE_INPUT, OBS_SOURCE_AUDIO},
+	{"wasapi_output_capture", OBS_SOURCE_TYPE_INPUT, OBS_SOURCE_AUDIO},
+	{"wasapi_process_output_capture", OBS_SOURCE_TYPE_INPUT,
+	 OBS_SOURCE_AUDIO},
+	{"pulse_input_capture", OBS_SOURCE_TYPE_INPUT, OBS_SOURCE_AUDIO},
+	{"pulse_output_capture", OBS_SOURCE_TYPE_INPUT, OBS_SOURCE_AUDIO},
+	{"coreaudio_input_capture", OBS_SOURCE_TYPE_INPUT, OBS_SOURCE_AUDIO},
+	{"coreaudio_output_capture", OBS_SOURCE_TYPE_INPUT, OBS_SOURCE_AUDIO},
+	{"alsa_input_capture", OBS_SOURCE_TYPE_INPUT, OBS_SOURCE_AUDIO},
+
+	{"async_delay_filter", OBS_SOURCE_TYPE_FILTER, OBS_SOURCE_ASYNC_VIDEO},
+	{"gain_filter", OBS_SOURCE_TYPE_FILTER, OBS_SOURCE_AUDIO},
+	{"compressor_filter", OBS_SOURCE_TYPE_FILTER, OBS_SOURCE_AUDIO},
+	{"upward_compressor_filter", OBS_SOURCE_TYPE_FILTER, OBS_SOURCE_AUDIO},
+	{"expander_filter", OBS_SOURCE_TYPE_FILTER, OBS_SOURCE_AUDIO},
+	{"limiter_filter", OBS_SOURCE_TYPE_FILTER, OBS_SOURCE_AUDIO},
+	{"noise_gate_filter", OBS_SOURCE_TYPE_FILTER, OBS_SOURCE_AUDIO},
+	{"noise_suppress_filter", OBS_SOURCE_TYPE_FILTER, OBS_SOURCE_AUDIO},
+	{"invert_polarity_filter", OBS_SOURCE_TYPE_FILTER, OBS_SOURCE_AUDIO},
+	{"basic_eq_filter", OBS_SOURCE_TYPE_FILTER, OBS_SOURCE_AUDIO},
+	{"vst_filter", OBS_SOURCE_TYPE_FILTER, OBS_SOURCE_AUDIO},
+};
+
+/* clang-format on */
+
+static bool has_suffix(const char *id, const char *suffix)
+{
+	size_t len = strlen(id);
+	size_t suffix_len = strlen(suffix);
+	return len >= suffix_len &&
+	       strcmp(id + len - suffix_len, suffix) == 0;
+}
+
+static struct known_type guess_type(const char *id)
+{
+	for (size_t i = 0; i < OBS_COUNTOF(known_types); i++) {
+		if (strcmp(known_types[i].id, id) == 0)
+			return known_types[i];
+	}
+
+	if (has_suffix(id, "_filter"))
+		return (struct known_type){id, OBS_SOURCE_TYPE_FILTER,
+					   OBS_SOURCE_VIDEO};
+	if (has_suffix(id, "_transition"))
+		return (struct known_type){id, OBS_SOURCE_TYPE_TRANSITION,
+					   OBS_SOURCE_VIDEO};
+	return (struct known_type){id, OBS_SOURCE_TYPE_INPUT,
+				   OBS_SOURCE_VIDEO};
+}
+
+enum obs_source_type source_types_ensure(const char *id)
+{
+	enum obs_source_type type;
+	if (strcmp(id, "scene") == 0 || strcmp(id, "group") == 0)
+		return OBS_SOURCE_TYPE_SCENE;
+	if (standin_type_registered(id, &type))
+		return type;
+
+	struct known_type known = guess_type(id);
+	switch (known.type) {
+	case OBS_SOURCE_TYPE_FILTER:
+		standin_register_filter(id, known.output_flags);
+		break;
+	case OBS_SOURCE_TYPE_TRANSITION:
+		standin_register_transition(id);
+		break;
+	default:
+		standin_register_input(id, known.output_flags);
+	}
+	return known.type;
+}
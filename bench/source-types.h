@@ -0,0 +1,29 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <obs.h>
+
+/**
+ * Registers a stand-in for a source type of OBS or a common plugin the
+ * first time it is needed, and returns what kind of type it is. Unknown
+ * ids are guessed from their name: "*_filter" and "*_transition", anything
+ * else is an input with video. Scenes and groups are always known.
+ */
+extern enum obs_source_type source_types_ensure(const char *id);
@@ -0,0 +1,220 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <string.h>
+#include <obs-module.h>
+#include <util/darray.h>
+#include <util/platform.h>
+#include <util/threading.h>
+
+#include "plugin-macros.generated.h"
+#include "apply-queue.h"
+#include "plugin-settings.h"
+
+// creations closer together than this belong to the same burst
+#define BURST_WINDOW_NS 100000000ULL
+
+struct queued_apply {
+	void *profile;
+	obs_weak_source_t *dst_weak;
+	uint64_t queued_ns;
+};
+
+struct drain_stats {
+	size_t applied;
+	size_t batches;
+	uint64_t max_wait_ns;
+	uint64_t max_apply_ns;
+	uint64_t max_batch_ns;
+};
+
+static struct {
+	pthread_mutex_t mutex;
+	DARRAY(struct queued_apply) items;
+	size_t head; // items before head are already taken
+
+	uint64_t last_creation_ns;
+	size_t burst_count;
+
+	volatile long count;
+	volatile bool batch_queued;
+	volatile bool active;
+
+	uint64_t budget_ns;
+	size_t burst_threshold;
+	apply_queue_cb_t apply;
+	apply_queue_release_cb_t release;
+
+	// only touched by the UI thread
+	struct drain_stats stats;
+} queue;
+
+static inline double ns_to_ms(uint64_t ns)
+{
+	return (double)ns / 1000000.0;
+}
+
+static bool pop_item(struct queued_apply *item)
+{
+	bool found = false;
+
+	pthread_mutex_lock(&queue.mutex);
+	if (queue.head < queue.items.num) {
+		*item = queue.items.array[queue.head++];
+		if (queue.head == queue.items.num) {
+			da_resize(queue.items, 0);
+			queue.head = 0;
+		}
+		found = true;
+	}
+	pthread_mutex_unlock(&queue.mutex);
+
+	if (found)
+		os_atomic_dec_long(&queue.count);
+	return found;
+}
+
+static void log_drained(void)
+{
+	struct drain_stats *stats = &queue.stats;
+
+	blog(LOG_INFO,
+	     "Applied defaults to %zu queued sources in %zu batches "
+	     "(max wait %.1f ms, slowest source %.2f ms, slowest batch %.2f ms)",
+	     stats->applied, stats->batches, ns_to_ms(stats->max_wait_ns),
+	     ns_to_ms(stats->max_apply_ns), ns_to_ms(stats->max_batch_ns));
+	memset(stats, 0, sizeof(*stats));
+}
+
+/* Runs on the UI thread, applies queued defaults until the budget is used */
+static void process_batch(void *param)
+{
+	UNUSED_PARAMETER(param);
+	if (!os_atomic_load_bool(&queue.active))
+		return;
+
+	struct drain_stats *stats = &queue.stats;
+	uint64_t start = os_gettime_ns();
+	uint64_t now = start;
+	size_t applied = 0;
+	struct queued_apply item;
+
+	while (now - start < queue.budget_ns && pop_item(&item)) {
+		if (now - item.queued_ns > stats->max_wait_ns)
+			stats->max_wait_ns = now - item.queued_ns;
+
+		obs_source_t *dst = obs_weak_source_get_source(item.dst_weak);
+		if (dst) {
+			queue.apply(item.profile, dst);
+			obs_source_release(dst);
+			applied++;
+		}
+		obs_weak_source_release(item.dst_weak);
+		queue.release(item.profile);
+
+		uint64_t end = os_gettime_ns();
+		if (end - now > stats->max_apply_ns)
+			stats->max_apply_ns = end - now;
+		now = end;
+	}
+
+	stats->applied += applied;
+	stats->batches++;
+	if (now - start > stats->max_batch_ns)
+		stats->max_batch_ns = now - start;
+
+	blog(LOG_DEBUG, "Applied defaults to %zu queued sources in %.2f ms",
+	     applied, ns_to_ms(now - start));
+
+	if (!os_atomic_load_long(&queue.count))
+		log_drained();
+	os_atomic_set_bool(&queue.batch_queued, false);
+}
+
+/* Graphics thread, schedules at most one batch per frame */
+static void apply_queue_tick(void *param, float seconds)
+{
+	UNUSED_PARAMETER(param);
+	UNUSED_PARAMETER(seconds);
+
+	if (!os_atomic_load_long(&queue.count))
+		return;
+	if (os_atomic_exchange_bool(&queue.batch_queued, true))
+		return;
+	obs_queue_task(OBS_TASK_UI, process_batch, NULL, false);
+}
+
+bool apply_queue_should_defer(void)
+{
+	uint64_t now = os_gettime_ns();
+	bool defer;
+
+	pthread_mutex_lock(&queue.mutex);
+	if (now - queue.last_creation_ns > BURST_WINDOW_NS)
+		queue.burst_count = 0;
+	queue.last_creation_ns = now;
+
+	// keep creation order once something is queued
+	defer = ++queue.burst_count > queue.burst_threshold ||
+		queue.head < queue.items.num;
+	pthread_mutex_unlock(&queue.mutex);
+	return defer;
+}
+
+void apply_queue_push(void *profile, obs_source_t *dst)
+{
+	struct queued_apply item;
+
+	item.profile = profile;
+	item.dst_weak = obs_source_get_weak_source(dst);
+	item.queued_ns = os_gettime_ns();
+
+	pthread_mutex_lock(&queue.mutex);
+	da_push_back(queue.items, &item);
+	pthread_mutex_unlock(&queue.mutex);
+	os_atomic_inc_long(&queue.count);
+}
+
+void apply_queue_init(apply_queue_cb_t apply, apply_queue_release_cb_t release)
+{
+	pthread_mutex_init(&queue.mutex, NULL);
+	da_init(queue.items);
+	queue.apply = apply;
+	queue.release = release;
+
+	queue.budget_ns = plugin_settings_batch_budget_ns();
+	queue.burst_threshold = plugin_settings_burst_threshold();
+
+	os_atomic_set_bool(&queue.active, true);
+	obs_add_tick_callback(apply_queue_tick, NULL);
+}
+
+void apply_queue_free(void)
+{
+	obs_remove_tick_callback(apply_queue_tick, NULL);
+	os_atomic_set_bool(&queue.active, false);
+
+	for (size_t i = queue.head; i < queue.items.num; i++) {
+		obs_weak_source_release(queue.items.array[i].dst_weak);
+		queue.release(queue.items.array[i].profile);
+	}
+	da_free(queue.items);
+	queue.head = 0;
+	os_atomic_set_long(&queue.count, 0);
+	pthread_mutex_destroy(&queue.mutex);
+}
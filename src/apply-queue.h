@@ -0,0 +1,46 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <obs.h>
+
+/**
+ * Queue for applying defaults outside of the source_create signal.
+ *
+ * When many sources are created at once (dropping a folder of media files,
+ * pasting a block of sources), applying the defaults inside every signal
+ * emission stalls the UI. Once a burst is detected, applications are queued
+ * and drained on the UI thread, one batch per rendered frame, each batch
+ * limited to a time budget.
+ */
+
+/* What to apply is up to the caller: apply() runs on the UI thread, and
+   release() once a queued profile was applied or dropped */
+typedef void (*apply_queue_cb_t)(void *profile, obs_source_t *dst);
+typedef void (*apply_queue_release_cb_t)(void *profile);
+
+extern void apply_queue_init(apply_queue_cb_t apply,
+			     apply_queue_release_cb_t release);
+extern void apply_queue_free(void);
+
+/* Counts a creation towards the current burst, returns true if the
+   defaults for it should be queued instead of applied right away. */
+extern bool apply_queue_should_defer(void);
+/* Takes over the reference to profile, keeps a weak one to dst */
+extern void apply_queue_push(void *profile, obs_source_t *dst);
@@ -0,0 +1,204 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <obs-module.h>
+#include <util/darray.h>
+#include <util/platform.h>
+#include <util/threading.h>
+#include <sys/stat.h>
+
+#include "plugin-macros.generated.h"
+#include "defaults-library.h"
+#include "frozen-defaults.h"
+#include "plugin-settings.h"
+
+#define LIBRARY_VERSION 1
+
+static struct {
+	char *path; // NULL without a library
+	float interval;
+	float elapsed;               // graphics thread only
+	volatile bool check_queued;  // a check is queued on the UI thread
+	volatile bool active;
+
+	/* UI thread only */
+	bool missing;
+	time_t mtime;
+	off_t size;
+} library;
+
+/* A file that goes missing is a change too, its defaults are dropped */
+static bool library_changed(void)
+{
+	struct stat st;
+	if (os_stat(library.path, &st) != 0) {
+		if (library.missing)
+			return false;
+		library.missing = true;
+		return true;
+	}
+	if (!library.missing && st.st_mtime == library.mtime &&
+	    st.st_size == library.size)
+		return false;
+
+	library.missing = false;
+	library.mtime = st.st_mtime;
+	library.size = st.st_size;
+	return true;
+}
+
+static void load_library(void)
+{
+	if (library.missing) {
+		blog(LOG_INFO, "The defaults library '%s' was removed",
+		     library.path);
+		frozen_store_set_library(NULL, 0);
+		return;
+	}
+
+	obs_data_t *data =
+		obs_data_create_from_json_file_safe(library.path, "bak");
+	if (!data) {
+		blog(LOG_WARNING, "Could not read the defaults library '%s'",
+		     library.path);
+		return;
+	}
+	if (obs_data_get_int(data, "version") > LIBRARY_VERSION)
+		blog(LOG_WARNING,
+		     "The defaults library '%s' was written by a newer version,"
+		     " it may not load completely.",
+		     library.path);
+
+	DARRAY(struct frozen_defaults *) loaded_defaults;
+	da_init(loaded_defaults);
+
+	obs_data_array_t *array = obs_data_get_array(data, "defaults");
+	size_t count = obs_data_array_count(array);
+	for (size_t i = 0; i < count; i++) {
+		obs_data_t *item = obs_data_array_item(array, i);
+		struct frozen_defaults *frozen = frozen_defaults_load(item);
+		if (frozen)
+			da_push_back(loaded_defaults, &frozen);
+		obs_data_release(item);
+	}
+	obs_data_array_release(array);
+	obs_data_release(data);
+
+	blog(LOG_INFO, "Loaded %zu defaults from the library '%s'",
+	     loaded_defaults.num, library.path);
+	frozen_store_set_library(loaded_defaults.array, loaded_defaults.num);
+	da_free(loaded_defaults);
+}
+
+static void check_library(void *param)
+{
+	UNUSED_PARAMETER(param);
+	os_atomic_set_bool(&library.check_queued, false);
+	if (os_atomic_load_bool(&library.active) && library_changed())
+		load_library();
+}
+
+/* Only queues the check, the file is never touched on the graphics thread */
+static void library_tick(void *param, float seconds)
+{
+	UNUSED_PARAMETER(param);
+	library.elapsed += seconds;
+	if (library.elapsed < library.interval)
+		return;
+
+	library.elapsed = 0.0f;
+	if (!os_atomic_exchange_bool(&library.check_queued, true))
+		obs_queue_task(OBS_TASK_UI, check_library, NULL, false);
+}
+
+static bool export_enum(void *param, struct frozen_defaults *frozen)
+{
+	obs_data_array_t *array = param;
+	obs_data_t *item = obs_data_create();
+	frozen_defaults_save(frozen, item);
+	obs_data_array_push_back(array, item);
+	obs_data_release(item);
+	return true;
+}
+
+/* Writes all frozen defaults, including the ones from the library */
+static bool export_library(const char *path)
+{
+	obs_data_t *data = obs_data_create();
+	obs_data_array_t *array = obs_data_array_create();
+	frozen_store_enum(export_enum, array);
+	obs_data_set_int(data, "version", LIBRARY_VERSION);
+	obs_data_set_array(data, "defaults", array);
+
+	// other instances never see a partially written file
+	bool success = obs_data_save_json_safe(data, path, "tmp", "bak");
+	if (success)
+		blog(LOG_INFO, "Exported %zu defaults to the library '%s'",
+		     obs_data_array_count(array), path);
+	else
+		blog(LOG_WARNING, "Could not write the defaults library '%s'",
+		     path);
+
+	obs_data_array_release(array);
+	obs_data_release(data);
+	return success;
+}
+
+static void export_library_proc(void *data, calldata_t *cd)
+{
+	UNUSED_PARAMETER(data);
+	const char *path = calldata_string(cd, "path");
+	if (!path || !*path)
+		path = library.path;
+	calldata_set_bool(cd, "success", path && export_library(path));
+}
+
+void defaults_library_init(void)
+{
+	proc_handler_t *ph = obs_get_proc_handler();
+	proc_handler_add(
+		ph,
+		"void source_defaults_export_library(in string path, out bool success)",
+		export_library_proc, NULL);
+
+	const char *path = plugin_settings_library_path();
+	if (!path)
+		return;
+
+	library.path = bstrdup(path);
+	library.interval = plugin_settings_library_poll_interval();
+	os_atomic_set_bool(&library.active, true);
+	// nothing to drop if there is no file yet
+	library.missing = true;
+	if (library_changed())
+		load_library();
+	if (library.interval > 0.0f)
+		obs_add_tick_callback(library_tick, NULL);
+}
+
+void defaults_library_free(void)
+{
+	if (!library.path)
+		return;
+
+	os_atomic_set_bool(&library.active, false);
+	if (library.interval > 0.0f)
+		obs_remove_tick_callback(library_tick, NULL);
+	bfree(library.path);
+	library.path = NULL;
+}
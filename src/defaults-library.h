@@ -0,0 +1,32 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <obs.h>
+
+/**
+ * A defaults library file shared by several OBS instances (e.g. portable
+ * installs on the same machine). It holds frozen defaults, one per default
+ * source, and is configured with `LibraryPath` in the [SourceDefaults]
+ * section of global.ini. Changes to the file are picked up by polling its
+ * modification time.
+ */
+
+extern void defaults_library_init(void);
+extern void defaults_library_free(void);
@@ -0,0 +1,306 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <obs-module.h>
+#include <util/dstr.h>
+#include <util/threading.h>
+
+#include "defaults-snapshot.h"
+#include "plugin-settings.h"
+
+/* ExpensiveFilters is a comma separated list, spaces around ids are fine */
+static bool is_expensive_filter(const char *id)
+{
+	const char *list = plugin_settings_expensive_filters();
+	size_t len = strlen(id);
+	while (*list) {
+		while (*list == ' ')
+			list++;
+		const char *end = strchr(list, ',');
+		size_t token_len = end ? (size_t)(end - list) : strlen(list);
+		while (token_len && list[token_len - 1] == ' ')
+			token_len--;
+
+		if (token_len == len && strncmp(list, id, len) == 0)
+			return true;
+		if (!end)
+			break;
+		list = end + 1;
+	}
+	return false;
+}
+
+static void enum_filters(obs_source_t *src, obs_source_t *filter, void *param)
+{
+	UNUSED_PARAMETER(src);
+	struct source_snapshot *snapshot = param;
+	const char *filter_id = obs_source_get_unversioned_id(filter);
+	if (strcmp(filter_id, "source_defaults_video") == 0 ||
+	    strcmp(filter_id, "source_defaults_audio") == 0)
+		return;
+
+	struct filter_template *tmpl = da_push_back_new(snapshot->filters);
+	tmpl->weak = obs_source_get_weak_source(filter);
+	tmpl->id = bstrdup(obs_source_get_id(filter));
+	tmpl->name = bstrdup(obs_source_get_name(filter));
+
+	obs_data_t *settings = obs_source_get_settings(filter);
+	tmpl->settings = obs_data_create();
+	obs_data_apply(tmpl->settings, settings);
+	obs_data_release(settings);
+
+	tmpl->hotkeys = obs_hotkeys_save_source(filter);
+	tmpl->enabled = obs_source_enabled(filter);
+	tmpl->is_private = obs_obj_is_private(filter);
+	tmpl->expensive = is_expensive_filter(filter_id);
+}
+
+static void free_filter_template(struct filter_template *tmpl)
+{
+	obs_weak_source_release(tmpl->weak);
+	bfree(tmpl->id);
+	bfree(tmpl->name);
+	obs_data_release(tmpl->settings);
+	obs_data_release(tmpl->hotkeys);
+}
+
+obs_source_t *filter_template_attach(const struct filter_template *tmpl,
+				     obs_source_t *dst)
+{
+	// same naming as obs_source_copy_single_filter
+	struct dstr name = {0};
+	dstr_copy(&name, tmpl->name);
+	for (int i = 2;; i++) {
+		obs_source_t *existing =
+			obs_source_get_filter_by_name(dst, name.array);
+		if (!existing)
+			break;
+		obs_source_release(existing);
+		dstr_printf(&name, "%s %d", tmpl->name, i);
+	}
+
+	// every instance needs its own settings object
+	obs_data_t *settings = obs_data_create();
+	obs_data_apply(settings, tmpl->settings);
+
+	obs_source_t *filter =
+		tmpl->is_private
+			? obs_source_create_private(tmpl->id, name.array,
+						    settings)
+			: obs_source_create(tmpl->id, name.array, settings,
+					    tmpl->hotkeys);
+	obs_data_release(settings);
+	dstr_free(&name);
+
+	if (filter) {
+		obs_source_set_enabled(filter, tmpl->enabled);
+		obs_source_filter_add(dst, filter);
+	}
+	return filter;
+}
+
+struct source_snapshot *source_snapshot_create(obs_source_t *source)
+{
+	struct source_snapshot *snapshot =
+		bzalloc(sizeof(struct source_snapshot));
+	snapshot->refs = 1;
+
+	obs_data_t *settings = obs_source_get_settings(source);
+	snapshot->settings = obs_data_create();
+	obs_data_apply(snapshot->settings, settings);
+	obs_data_release(settings);
+
+	obs_source_enum_filters(source, enum_filters, snapshot);
+
+	snapshot->volume = obs_source_get_volume(source);
+	snapshot->muted = obs_source_muted(source);
+	snapshot->balance = obs_source_get_balance_value(source);
+	snapshot->sync_offset = obs_source_get_sync_offset(source);
+	snapshot->mixers = obs_source_get_audio_mixers(source);
+	return snapshot;
+}
+
+void source_snapshot_addref(struct source_snapshot *snapshot)
+{
+	if (snapshot)
+		os_atomic_inc_long(&snapshot->refs);
+}
+
+void source_snapshot_release(struct source_snapshot *snapshot)
+{
+	if (!snapshot || os_atomic_dec_long(&snapshot->refs) > 0)
+		return;
+
+	for (size_t i = 0; i < snapshot->filters.num; i++)
+		free_filter_template(&snapshot->filters.array[i]);
+	da_free(snapshot->filters);
+	obs_data_release(snapshot->settings);
+	bfree(snapshot);
+}
+
+struct sceneitem_snapshot *sceneitem_snapshot_create(obs_sceneitem_t *item)
+{
+	struct sceneitem_snapshot *snapshot =
+		bzalloc(sizeof(struct sceneitem_snapshot));
+	snapshot->refs = 1;
+
+	if (item) {
+		obs_sceneitem_addref(item);
+		snapshot->item = item;
+		obs_sceneitem_get_info(item, &snapshot->info);
+		obs_sceneitem_get_crop(item, &snapshot->crop);
+		snapshot->visible = obs_sceneitem_visible(item);
+	}
+	return snapshot;
+}
+
+void sceneitem_snapshot_addref(struct sceneitem_snapshot *snapshot)
+{
+	if (snapshot)
+		os_atomic_inc_long(&snapshot->refs);
+}
+
+void sceneitem_snapshot_release(struct sceneitem_snapshot *snapshot)
+{
+	if (!snapshot || os_atomic_dec_long(&snapshot->refs) > 0)
+		return;
+
+	obs_sceneitem_release(snapshot->item);
+	bfree(snapshot);
+}
+
+static void save_filter_template(const struct filter_template *tmpl,
+				 obs_data_t *data)
+{
+	obs_data_set_string(data, "id", tmpl->id);
+	obs_data_set_string(data, "name", tmpl->name);
+	obs_data_set_obj(data, "settings", tmpl->settings);
+	if (tmpl->hotkeys)
+		obs_data_set_obj(data, "hotkeys", tmpl->hotkeys);
+	obs_data_set_bool(data, "enabled", tmpl->enabled);
+	obs_data_set_bool(data, "private", tmpl->is_private);
+	obs_data_set_bool(data, "expensive", tmpl->expensive);
+}
+
+static void load_filter_template(struct filter_template *tmpl,
+				 obs_data_t *data)
+{
+	tmpl->id = bstrdup(obs_data_get_string(data, "id"));
+	tmpl->name = bstrdup(obs_data_get_string(data, "name"));
+	tmpl->settings = obs_data_get_obj(data, "settings");
+	if (!tmpl->settings)
+		tmpl->settings = obs_data_create();
+	tmpl->hotkeys = obs_data_get_obj(data, "hotkeys");
+	tmpl->enabled = obs_data_get_bool(data, "enabled");
+	tmpl->is_private = obs_data_get_bool(data, "private");
+	tmpl->expensive = obs_data_get_bool(data, "expensive");
+}
+
+void source_snapshot_save(const struct source_snapshot *snapshot,
+			  obs_data_t *data)
+{
+	obs_data_set_obj(data, "settings", snapshot->settings);
+
+	obs_data_array_t *filters = obs_data_array_create();
+	for (size_t i = 0; i < snapshot->filters.num; i++) {
+		obs_data_t *filter = obs_data_create();
+		save_filter_template(&snapshot->filters.array[i], filter);
+		obs_data_array_push_back(filters, filter);
+		obs_data_release(filter);
+	}
+	obs_data_set_array(data, "filters", filters);
+	obs_data_array_release(filters);
+
+	obs_data_set_double(data, "volume", snapshot->volume);
+	obs_data_set_bool(data, "muted", snapshot->muted);
+	obs_data_set_double(data, "balance", snapshot->balance);
+	obs_data_set_int(data, "sync_offset", snapshot->sync_offset);
+	obs_data_set_int(data, "mixers", snapshot->mixers);
+}
+
+struct source_snapshot *source_snapshot_load(obs_data_t *data)
+{
+	struct source_snapshot *snapshot =
+		bzalloc(sizeof(struct source_snapshot));
+	snapshot->refs = 1;
+
+	snapshot->settings = obs_data_get_obj(data, "settings");
+	if (!snapshot->settings)
+		snapshot->settings = obs_data_create();
+
+	obs_data_array_t *filters = obs_data_get_array(data, "filters");
+	size_t count = obs_data_array_count(filters);
+	for (size_t i = 0; i < count; i++) {
+		obs_data_t *filter = obs_data_array_item(filters, i);
+		load_filter_template(da_push_back_new(snapshot->filters),
+				     filter);
+		obs_data_release(filter);
+	}
+	obs_data_array_release(filters);
+
+	snapshot->volume = (float)obs_data_get_double(data, "volume");
+	snapshot->muted = obs_data_get_bool(data, "muted");
+	snapshot->balance = (float)obs_data_get_double(data, "balance");
+	snapshot->sync_offset = obs_data_get_int(data, "sync_offset");
+	snapshot->mixers = (uint32_t)obs_data_get_int(data, "mixers");
+	return snapshot;
+}
+
+void sceneitem_snapshot_save(const struct sceneitem_snapshot *snapshot,
+			     obs_data_t *data)
+{
+	const struct obs_transform_info *info = &snapshot->info;
+	obs_data_set_vec2(data, "pos", &info->pos);
+	obs_data_set_double(data, "rot", info->rot);
+	obs_data_set_vec2(data, "scale", &info->scale);
+	obs_data_set_int(data, "alignment", info->alignment);
+	obs_data_set_int(data, "bounds_type", info->bounds_type);
+	obs_data_set_int(data, "bounds_alignment", info->bounds_alignment);
+	obs_data_set_vec2(data, "bounds", &info->bounds);
+
+	obs_data_set_int(data, "crop_left", snapshot->crop.left);
+	obs_data_set_int(data, "crop_top", snapshot->crop.top);
+	obs_data_set_int(data, "crop_right", snapshot->crop.right);
+	obs_data_set_int(data, "crop_bottom", snapshot->crop.bottom);
+	obs_data_set_bool(data, "visible", snapshot->visible);
+}
+
+struct sceneitem_snapshot *sceneitem_snapshot_load(obs_data_t *data)
+{
+	struct sceneitem_snapshot *snapshot =
+		bzalloc(sizeof(struct sceneitem_snapshot));
+	snapshot->refs = 1;
+
+	struct obs_transform_info *info = &snapshot->info;
+	obs_data_get_vec2(data, "pos", &info->pos);
+	info->rot = (float)obs_data_get_double(data, "rot");
+	obs_data_get_vec2(data, "scale", &info->scale);
+	info->alignment = (uint32_t)obs_data_get_int(data, "alignment");
+	info->bounds_type =
+		(enum obs_bounds_type)obs_data_get_int(data, "bounds_type");
+	info->bounds_alignment =
+		(uint32_t)obs_data_get_int(data, "bounds_alignment");
+	obs_data_get_vec2(data, "bounds", &info->bounds);
+
+	snapshot->crop.left = (int)obs_data_get_int(data, "crop_left");
+	snapshot->crop.top = (int)obs_data_get_int(data, "crop_top");
+	snapshot->crop.right = (int)obs_data_get_int(data, "crop_right");
+	snapshot->crop.bottom = (int)obs_data_get_int(data, "crop_bottom");
+	snapshot->visible = obs_data_get_bool(data, "visible");
+	return snapshot;
+}
@@ -0,0 +1,83 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <obs.h>
+#include <util/darray.h>
+
+/**
+ * Immutable copies of what a default source hands out to new sources, so
+ * bursts of new sources are served from memory. The filter rebuilds them
+ * only after the default source (or its scene item) signals a change.
+ */
+
+/* Everything needed to create a copy of a filter of the default source */
+struct filter_template {
+	obs_weak_source_t *weak;
+	char *id;
+	char *name;
+	obs_data_t *settings;
+	obs_data_t *hotkeys;
+	bool enabled;
+	bool is_private;
+	bool expensive; // slow to construct, can be attached later
+};
+
+struct source_snapshot {
+	volatile long refs;
+	obs_data_t *settings;
+	DARRAY(struct filter_template) filters;
+
+	/* audio, the monitoring type has no change signal so it isn't cached */
+	float volume;
+	bool muted;
+	float balance;
+	int64_t sync_offset;
+	uint32_t mixers;
+};
+
+struct sceneitem_snapshot {
+	volatile long refs;
+	obs_sceneitem_t *item; // NULL if the scene doesn't contain the source
+	struct obs_transform_info info;
+	struct obs_sceneitem_crop crop;
+	bool visible;
+};
+
+extern struct source_snapshot *source_snapshot_create(obs_source_t *source);
+extern void source_snapshot_addref(struct source_snapshot *snapshot);
+extern void source_snapshot_release(struct source_snapshot *snapshot);
+
+/* Creates the filter and adds it to dst, returns a new reference */
+extern obs_source_t *filter_template_attach(const struct filter_template *tmpl,
+					    obs_source_t *dst);
+
+extern struct sceneitem_snapshot *
+sceneitem_snapshot_create(obs_sceneitem_t *item);
+extern void sceneitem_snapshot_addref(struct sceneitem_snapshot *snapshot);
+extern void sceneitem_snapshot_release(struct sceneitem_snapshot *snapshot);
+
+/* For templates that outlive their source. Loaded snapshots have no live
+   filters or scene item, only the data. */
+extern void source_snapshot_save(const struct source_snapshot *snapshot,
+				 obs_data_t *data);
+extern struct source_snapshot *source_snapshot_load(obs_data_t *data);
+extern void sceneitem_snapshot_save(const struct sceneitem_snapshot *snapshot,
+				    obs_data_t *data);
+extern struct sceneitem_snapshot *sceneitem_snapshot_load(obs_data_t *data);
@@ -0,0 +1,202 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <string.h>
+#include <obs-module.h>
+#include <util/darray.h>
+#include <util/platform.h>
+#include <util/threading.h>
+
+#include "plugin-macros.generated.h"
+#include "deferred-filters.h"
+
+// attach anyway if the source never shows a frame
+#define ATTACH_TIMEOUT_NS 5000000000ULL
+
+struct deferred_filter {
+	obs_weak_source_t *dst_weak;
+	struct source_snapshot *snapshot;
+	size_t idx; // template in snapshot->filters
+	uint64_t queued_ns;
+};
+
+typedef DARRAY(struct deferred_filter) deferred_filter_array_t;
+
+static struct {
+	pthread_mutex_t mutex;
+	deferred_filter_array_t waiting;
+	volatile long count;
+} deferred;
+
+static void free_deferred_filter(struct deferred_filter *item)
+{
+	obs_weak_source_release(item->dst_weak);
+	source_snapshot_release(item->snapshot);
+}
+
+static bool has_first_frame(obs_source_t *dst)
+{
+	if (obs_source_get_output_flags(dst) & OBS_SOURCE_VIDEO)
+		return obs_source_get_width(dst) > 0;
+	return obs_source_showing(dst);
+}
+
+struct later_filters {
+	const struct source_snapshot *snapshot;
+	size_t idx;
+	obs_source_t *self;
+	size_t count;
+};
+
+static void count_later_filters(obs_source_t *dst, obs_source_t *filter,
+				void *param)
+{
+	UNUSED_PARAMETER(dst);
+	struct later_filters *data = param;
+	if (filter == data->self)
+		return;
+
+	const char *name = obs_source_get_name(filter);
+	for (size_t i = data->idx + 1; i < data->snapshot->filters.num; i++) {
+		if (strcmp(name, data->snapshot->filters.array[i].name) == 0) {
+			data->count++;
+			return;
+		}
+	}
+}
+
+static void attach_deferred_filter(struct deferred_filter *item)
+{
+	obs_source_t *dst = obs_weak_source_get_source(item->dst_weak);
+	if (!dst)
+		return;
+
+	const struct filter_template *tmpl =
+		&item->snapshot->filters.array[item->idx];
+	obs_source_t *filter = filter_template_attach(tmpl, dst);
+	if (filter) {
+		// added filters go last, move it above the ones that follow it
+		// in the template
+		struct later_filters data = {item->snapshot, item->idx, filter,
+					     0};
+		obs_source_enum_filters(dst, count_later_filters, &data);
+		for (size_t i = 0; i < data.count; i++)
+			obs_source_filter_set_order(dst, filter,
+						    OBS_ORDER_MOVE_UP);
+		obs_source_release(filter);
+	}
+	obs_source_release(dst);
+}
+
+static void attach_ready(void *param)
+{
+	deferred_filter_array_t *ready = param;
+	for (size_t i = 0; i < ready->num; i++) {
+		attach_deferred_filter(&ready->array[i]);
+		free_deferred_filter(&ready->array[i]);
+	}
+	da_free(*ready);
+	bfree(ready);
+}
+
+/**
+ * Graphics thread, only checks the sources, attaching happens in the UI.
+ * The waiting filters are taken out of the list for the checks, so a
+ * source that is released (and maybe destroyed) by a check doesn't hold
+ * up deferred_filters_push() on other threads.
+ */
+static void deferred_filters_tick(void *param, float seconds)
+{
+	UNUSED_PARAMETER(param);
+	UNUSED_PARAMETER(seconds);
+
+	if (!os_atomic_load_long(&deferred.count))
+		return;
+
+	uint64_t now = os_gettime_ns();
+	deferred_filter_array_t *ready = NULL;
+	deferred_filter_array_t waiting;
+	da_init(waiting);
+
+	pthread_mutex_lock(&deferred.mutex);
+	da_move(waiting, deferred.waiting);
+	pthread_mutex_unlock(&deferred.mutex);
+
+	for (size_t i = 0; i < waiting.num;) {
+		struct deferred_filter *item = &waiting.array[i];
+		obs_source_t *dst = obs_weak_source_get_source(item->dst_weak);
+		bool is_ready = !dst || has_first_frame(dst) ||
+				now - item->queued_ns > ATTACH_TIMEOUT_NS;
+		obs_source_release(dst);
+
+		if (!is_ready) {
+			i++;
+			continue;
+		}
+		if (!ready)
+			ready = bzalloc(sizeof(*ready));
+		// keeps the order, filters of one source become ready together
+		da_push_back(*ready, item);
+		da_erase(waiting, i);
+		os_atomic_dec_long(&deferred.count);
+	}
+
+	// filters pushed during the checks go after the ones still waiting
+	pthread_mutex_lock(&deferred.mutex);
+	da_push_back_array(waiting, deferred.waiting.array,
+			   deferred.waiting.num);
+	da_move(deferred.waiting, waiting);
+	pthread_mutex_unlock(&deferred.mutex);
+
+	if (ready)
+		obs_queue_task(OBS_TASK_UI, attach_ready, ready, false);
+}
+
+void deferred_filters_push(struct source_snapshot *snapshot, size_t idx,
+			   obs_source_t *dst)
+{
+	struct deferred_filter item;
+	item.dst_weak = obs_source_get_weak_source(dst);
+	item.snapshot = snapshot;
+	item.idx = idx;
+	item.queued_ns = os_gettime_ns();
+	source_snapshot_addref(snapshot);
+
+	pthread_mutex_lock(&deferred.mutex);
+	da_push_back(deferred.waiting, &item);
+	pthread_mutex_unlock(&deferred.mutex);
+	os_atomic_inc_long(&deferred.count);
+}
+
+void deferred_filters_init(void)
+{
+	pthread_mutex_init(&deferred.mutex, NULL);
+	da_init(deferred.waiting);
+	obs_add_tick_callback(deferred_filters_tick, NULL);
+}
+
+void deferred_filters_free(void)
+{
+	obs_remove_tick_callback(deferred_filters_tick, NULL);
+
+	for (size_t i = 0; i < deferred.waiting.num; i++)
+		free_deferred_filter(&deferred.waiting.array[i]);
+	da_free(deferred.waiting);
+	os_atomic_set_long(&deferred.count, 0);
+	pthread_mutex_destroy(&deferred.mutex);
+}
@@ -0,0 +1,35 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <obs.h>
+
+#include "defaults-snapshot.h"
+
+/**
+ * Expensive filters of a template can be attached once the new source has
+ * shown its first frame (or after a timeout), so creating the source does
+ * not wait for them. They are moved back into their place in the chain.
+ */
+
+extern void deferred_filters_init(void);
+extern void deferred_filters_free(void);
+
+extern void deferred_filters_push(struct source_snapshot *snapshot, size_t idx,
+				  obs_source_t *dst);
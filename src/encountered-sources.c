@@ -0,0 +1,258 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <obs-module.h>
+#include <obs-frontend-api.h>
+#include <util/threading.h>
+
+#include "plugin-macros.generated.h"
+#include "encountered-sources.h"
+#include "hash-table.h"
+
+#define SAVE_KEY "source_defaults_encountered"
+// written into the settings of every source by older versions
+#define LEGACY_KEY "com.source_defaults.encountered"
+
+#if LIBOBS_API_MAJOR_VER > 29 || \
+	(LIBOBS_API_MAJOR_VER == 29 && LIBOBS_API_MINOR_VER >= 1)
+#define KEY_BY_UUID
+#endif
+
+struct encountered_entry {
+	char *key;
+	uint32_t fingerprint; // of the settings of a removed source, else 0
+};
+
+static struct {
+	pthread_mutex_t mutex;
+	struct hash_table entries; // key -> struct encountered_entry
+} encountered;
+
+static const char *source_key(obs_source_t *source)
+{
+#ifdef KEY_BY_UUID
+	return obs_source_get_uuid(source);
+#else
+	return obs_source_get_name(source);
+#endif
+}
+
+static uint32_t settings_fingerprint(obs_data_t *settings)
+{
+	uint32_t hash = hash_table_hash_str(obs_data_get_json(settings));
+	return hash ? hash : 1;
+}
+
+static void clear_locked(void)
+{
+	size_t idx = 0;
+	struct encountered_entry *entry;
+	while (hash_table_next(&encountered.entries, &idx, NULL,
+			       (void **)&entry)) {
+		hash_table_remove(&encountered.entries, entry->key);
+		bfree(entry->key);
+		bfree(entry);
+	}
+}
+
+static void add_locked(const char *key)
+{
+	struct encountered_entry *entry =
+		hash_table_get(&encountered.entries, key);
+	if (entry) {
+		entry->fingerprint = 0;
+		return;
+	}
+
+	entry = bzalloc(sizeof(struct encountered_entry));
+	entry->key = bstrdup(key);
+	hash_table_set(&encountered.entries, entry->key, entry);
+}
+
+void encountered_sources_add(obs_source_t *source)
+{
+	const char *key = source_key(source);
+	if (!key)
+		return;
+
+	pthread_mutex_lock(&encountered.mutex);
+	add_locked(key);
+	pthread_mutex_unlock(&encountered.mutex);
+}
+
+bool encountered_sources_contains(obs_source_t *source, obs_data_t *settings)
+{
+	const char *key = source_key(source);
+	if (!key)
+		return false;
+
+	pthread_mutex_lock(&encountered.mutex);
+	struct encountered_entry *entry =
+		hash_table_get(&encountered.entries, key);
+	bool found = entry != NULL;
+	if (entry && entry->fingerprint) {
+		// undo restores the settings the source had when it was removed
+		found = entry->fingerprint == settings_fingerprint(settings);
+		if (found) {
+			entry->fingerprint = 0;
+		} else {
+			hash_table_remove(&encountered.entries, entry->key);
+			bfree(entry->key);
+			bfree(entry);
+		}
+	}
+	pthread_mutex_unlock(&encountered.mutex);
+	return found;
+}
+
+static void source_removed(void *data, calldata_t *cd)
+{
+	UNUSED_PARAMETER(data);
+	obs_source_t *source = calldata_ptr(cd, "source");
+	const char *key = source_key(source);
+	if (!key)
+		return;
+
+	pthread_mutex_lock(&encountered.mutex);
+	struct encountered_entry *entry =
+		hash_table_get(&encountered.entries, key);
+	if (entry) {
+		obs_data_t *settings = obs_source_get_settings(source);
+		entry->fingerprint = settings_fingerprint(settings);
+		obs_data_release(settings);
+	}
+	pthread_mutex_unlock(&encountered.mutex);
+}
+
+#ifndef KEY_BY_UUID
+static void source_renamed(void *data, calldata_t *cd)
+{
+	UNUSED_PARAMETER(data);
+	const char *prev_name = calldata_string(cd, "prev_name");
+	const char *new_name = calldata_string(cd, "new_name");
+	if (!prev_name || !new_name)
+		return;
+
+	pthread_mutex_lock(&encountered.mutex);
+	struct encountered_entry *entry =
+		hash_table_remove(&encountered.entries, prev_name);
+	if (entry) {
+		// replaces a removed source that had the new name
+		struct encountered_entry *prev =
+			hash_table_remove(&encountered.entries, new_name);
+		if (prev) {
+			bfree(prev->key);
+			bfree(prev);
+		}
+		bfree(entry->key);
+		entry->key = bstrdup(new_name);
+		hash_table_set(&encountered.entries, entry->key, entry);
+	}
+	pthread_mutex_unlock(&encountered.mutex);
+}
+#endif
+
+static bool add_legacy_marked(void *param, obs_source_t *source)
+{
+	UNUSED_PARAMETER(param);
+	const char *key = source_key(source);
+	if (!key || obs_source_get_type(source) != OBS_SOURCE_TYPE_INPUT)
+		return true;
+
+	obs_data_t *settings = obs_source_get_settings(source);
+	if (obs_data_get_bool(settings, LEGACY_KEY))
+		add_locked(key);
+	obs_data_release(settings);
+	return true;
+}
+
+/**
+ * Only the sources that still exist are saved, since the undo history
+ * doesn't outlive the scene collection.
+ */
+static void encountered_save_cb(obs_data_t *save_data, bool saving,
+				void *param)
+{
+	UNUSED_PARAMETER(param);
+
+	if (saving) {
+		obs_data_array_t *array = obs_data_array_create();
+		pthread_mutex_lock(&encountered.mutex);
+		size_t idx = 0;
+		struct encountered_entry *entry;
+		while (hash_table_next(&encountered.entries, &idx, NULL,
+				       (void **)&entry)) {
+			if (entry->fingerprint)
+				continue;
+			obs_data_t *data = obs_data_create();
+			obs_data_set_string(data, "key", entry->key);
+			obs_data_array_push_back(array, data);
+			obs_data_release(data);
+		}
+		pthread_mutex_unlock(&encountered.mutex);
+		obs_data_set_array(save_data, SAVE_KEY, array);
+		obs_data_array_release(array);
+		return;
+	}
+
+	obs_data_array_t *array = obs_data_get_array(save_data, SAVE_KEY);
+	size_t count = obs_data_array_count(array);
+
+	pthread_mutex_lock(&encountered.mutex);
+	clear_locked();
+	for (size_t i = 0; i < count; i++) {
+		obs_data_t *data = obs_data_array_item(array, i);
+		const char *key = obs_data_get_string(data, "key");
+		if (*key)
+			add_locked(key);
+		obs_data_release(data);
+	}
+	// the sources of collections saved by older versions are marked
+	if (!array)
+		obs_enum_sources(add_legacy_marked, NULL);
+	pthread_mutex_unlock(&encountered.mutex);
+	obs_data_array_release(array);
+}
+
+void encountered_sources_init(void)
+{
+	pthread_mutex_init(&encountered.mutex, NULL);
+	hash_table_init(&encountered.entries, hash_table_hash_str,
+			hash_table_equal_str);
+
+	signal_handler_t *sh = obs_get_signal_handler();
+	signal_handler_connect(sh, "source_remove", source_removed, NULL);
+#ifndef KEY_BY_UUID
+	signal_handler_connect(sh, "source_rename", source_renamed, NULL);
+#endif
+	obs_frontend_add_save_callback(encountered_save_cb, NULL);
+}
+
+void encountered_sources_free(void)
+{
+	obs_frontend_remove_save_callback(encountered_save_cb, NULL);
+	signal_handler_t *sh = obs_get_signal_handler();
+	signal_handler_disconnect(sh, "source_remove", source_removed, NULL);
+#ifndef KEY_BY_UUID
+	signal_handler_disconnect(sh, "source_rename", source_renamed, NULL);
+#endif
+
+	clear_locked();
+	hash_table_free(&encountered.entries);
+	pthread_mutex_destroy(&encountered.mutex);
+}
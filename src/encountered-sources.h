@@ -0,0 +1,41 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <obs.h>
+
+/**
+ * The input sources Source Defaults has already seen, so that a source
+ * recreated by undo isn't mistaken for a new one. It is a side table saved
+ * with the scene collection instead of a marker in the settings of every
+ * source, which would cost each of them an extra update.
+ *
+ * Sources are keyed by UUID where libobs has them (29.1 and later), by
+ * name otherwise, following renames. Removed sources stay in the table for
+ * undo, with a fingerprint of their settings, so a new source that only
+ * reuses the name of a removed one is still new.
+ */
+
+extern void encountered_sources_init(void);
+extern void encountered_sources_free(void);
+
+extern void encountered_sources_add(obs_source_t *source);
+/* Takes the settings of the source, which has just been created */
+extern bool encountered_sources_contains(obs_source_t *source,
+					 obs_data_t *settings);
@@ -0,0 +1,206 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <stdio.h>
+#include <time.h>
+#include <obs-module.h>
+#include <obs-frontend-api.h>
+#include <util/dstr.h>
+#include <util/platform.h>
+
+#include "plugin-macros.generated.h"
+#include "event-trace.h"
+#include "hash-table.h"
+#include "plugin-settings.h"
+
+#define TRACE_BUFFER_SIZE (64 * 1024)
+
+volatile bool event_trace_active = false;
+
+/* clang-format off */
+
+static const char *event_names[] = {
+	"source_create",
+	"source_destroy",
+	"source_rename",
+	"item_add",
+	"frontend",
+};
+
+/* clang-format on */
+
+static struct {
+	pthread_mutex_t mutex;
+	FILE *file;
+	uint64_t start_ns;
+	struct hash_table ids; // obs_source_t * -> id
+	uintptr_t next_id;
+} trace;
+
+static uintptr_t get_id_locked(obs_source_t *source)
+{
+	if (!source)
+		return 0;
+
+	uintptr_t id = (uintptr_t)hash_table_get(&trace.ids, source);
+	if (!id) {
+		id = ++trace.next_id;
+		hash_table_set(&trace.ids, source, (void *)id);
+	}
+	return id;
+}
+
+static void write_line_locked(const char *event, uintptr_t source_id,
+			      const char *type, uintptr_t scene_id,
+			      uint64_t start, uint64_t end)
+{
+	fprintf(trace.file, "%.1f\t%s\t%llu\t%s\t%llu\t%.1f\n",
+		(double)(start - trace.start_ns) / 1000.0, event,
+		(unsigned long long)source_id, type ? type : "",
+		(unsigned long long)scene_id, (double)(end - start) / 1000.0);
+}
+
+void event_trace_record(enum trace_event event, obs_source_t *source,
+			obs_source_t *scene, uint64_t start)
+{
+	uint64_t end = os_gettime_ns();
+	const char *type = source ? obs_source_get_unversioned_id(source)
+				  : NULL;
+
+	pthread_mutex_lock(&trace.mutex);
+	if (trace.file) {
+		uintptr_t source_id = get_id_locked(source);
+		uintptr_t scene_id = get_id_locked(scene);
+		write_line_locked(event_names[event], source_id, type,
+				  scene_id, start, end);
+
+		// a new source at the same address gets a new id
+		if (event == TRACE_SOURCE_DESTROY)
+			hash_table_remove(&trace.ids, source);
+	}
+	pthread_mutex_unlock(&trace.mutex);
+}
+
+void event_trace_frontend(int event, uint64_t start)
+{
+	uint64_t end = os_gettime_ns();
+	char type[16];
+	snprintf(type, sizeof(type), "%d", event);
+
+	// the scenes the event leaves selected, a replay switches to them
+	obs_source_t *program = obs_frontend_get_current_scene();
+	obs_source_t *preview =
+		obs_frontend_preview_program_mode_active()
+			? obs_frontend_get_current_preview_scene()
+			: NULL;
+
+	pthread_mutex_lock(&trace.mutex);
+	if (trace.file)
+		write_line_locked(event_names[TRACE_FRONTEND],
+				  get_id_locked(program), type,
+				  get_id_locked(preview), start, end);
+	pthread_mutex_unlock(&trace.mutex);
+
+	obs_source_release(program);
+	obs_source_release(preview);
+}
+
+/* destroy and rename have no handler of their own, they are only traced */
+static void source_destroy_traced(void *data, calldata_t *cd)
+{
+	UNUSED_PARAMETER(data);
+	event_trace_record(TRACE_SOURCE_DESTROY, calldata_ptr(cd, "source"),
+			   NULL, os_gettime_ns());
+}
+
+static void source_rename_traced(void *data, calldata_t *cd)
+{
+	UNUSED_PARAMETER(data);
+	event_trace_record(TRACE_SOURCE_RENAME, calldata_ptr(cd, "source"),
+			   NULL, os_gettime_ns());
+}
+
+static FILE *open_trace_file(void)
+{
+	char *dir = obs_module_config_path("traces");
+	if (!dir)
+		return NULL;
+	os_mkdirs(dir);
+
+	char stamp[32];
+	time_t now = time(NULL);
+	strftime(stamp, sizeof(stamp), "%Y-%m-%d %H-%M-%S", localtime(&now));
+
+	struct dstr path = {0};
+	dstr_printf(&path, "%s/trace %s.tsv", dir, stamp);
+	FILE *file = os_fopen(path.array, "w");
+	if (file) {
+		setvbuf(file, NULL, _IOFBF, TRACE_BUFFER_SIZE);
+		fprintf(file, "time_us\tevent\tsource\ttype\tscene\thandler_us\n");
+		blog(LOG_INFO, "Tracing events to '%s'", path.array);
+	} else {
+		blog(LOG_WARNING, "Failed to open trace file '%s'",
+		     path.array);
+	}
+	dstr_free(&path);
+	bfree(dir);
+	return file;
+}
+
+void event_trace_init(void)
+{
+	pthread_mutex_init(&trace.mutex, NULL);
+	hash_table_init(&trace.ids, hash_table_hash_ptr, hash_table_equal_ptr);
+
+	if (!plugin_settings_trace_events())
+		return;
+
+	trace.file = open_trace_file();
+	if (!trace.file)
+		return;
+
+	trace.start_ns = os_gettime_ns();
+	signal_handler_t *sh = obs_get_signal_handler();
+	signal_handler_connect(sh, "source_destroy", source_destroy_traced,
+			       NULL);
+	signal_handler_connect(sh, "source_rename", source_rename_traced,
+			       NULL);
+	os_atomic_set_bool(&event_trace_active, true);
+}
+
+void event_trace_free(void)
+{
+	if (os_atomic_load_bool(&event_trace_active)) {
+		os_atomic_set_bool(&event_trace_active, false);
+		signal_handler_t *sh = obs_get_signal_handler();
+		signal_handler_disconnect(sh, "source_destroy",
+					  source_destroy_traced, NULL);
+		signal_handler_disconnect(sh, "source_rename",
+					  source_rename_traced, NULL);
+	}
+
+	pthread_mutex_lock(&trace.mutex);
+	if (trace.file) {
+		fclose(trace.file);
+		trace.file = NULL;
+	}
+	pthread_mutex_unlock(&trace.mutex);
+
+	hash_table_free(&trace.ids);
+	pthread_mutex_destroy(&trace.mutex);
+}
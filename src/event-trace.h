@@ -0,0 +1,62 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <obs.h>
+#include <util/threading.h>
+
+/**
+ * Optional capture of the events the plugin reacts to, for profiling the
+ * load of a real show. Enabled with `TraceEvents=true` in the
+ * `[SourceDefaults]` section of the global config. Every run writes one
+ * tab separated file to the plugin config folder, one line per event:
+ *
+ *   time_us  event  source  type  scene  handler_us
+ *
+ * `source` and `scene` are small ids that identify the same object across
+ * lines (0 if there is none), `type` is the unversioned source id and
+ * `handler_us` the time the plugin spent in its handler. Frontend events
+ * are logged as `frontend` with the event number in the `type` column and
+ * the program and preview scene in the `source` and `scene` columns.
+ *
+ * bench/source-defaults-replay feeds such a file back through the plugin.
+ */
+
+enum trace_event {
+	TRACE_SOURCE_CREATE,
+	TRACE_SOURCE_DESTROY,
+	TRACE_SOURCE_RENAME,
+	TRACE_ITEM_ADD,
+	TRACE_FRONTEND,
+};
+
+extern volatile bool event_trace_active;
+
+extern void event_trace_init(void);
+extern void event_trace_free(void);
+
+/* start is the os_gettime_ns() from before the handler ran */
+extern void event_trace_record(enum trace_event event, obs_source_t *source,
+			       obs_source_t *scene, uint64_t start);
+extern void event_trace_frontend(int event, uint64_t start);
+
+static inline bool event_trace_enabled(void)
+{
+	return os_atomic_load_bool(&event_trace_active);
+}
@@ -0,0 +1,297 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <obs-module.h>
+#include <util/darray.h>
+#include <util/platform.h>
+#include <util/threading.h>
+
+#include "plugin-macros.generated.h"
+#include "hash-table.h"
+#include "existing-sources.h"
+#include "plugin-settings.h"
+
+struct existing_target {
+	obs_weak_source_t *weak;
+	DARRAY(obs_sceneitem_t *) items;
+};
+
+struct existing_job {
+	obs_weak_source_t *filter_weak;
+	char *name;
+	DARRAY(struct existing_target) targets;
+	size_t next; // written with existing.mutex locked
+	size_t applied;
+	int reported; // tenths of the targets that have been logged
+	uint64_t start_ns;
+};
+
+/* The job list only changes on the UI thread, the mutex is for readers of
+   the progress on other threads. */
+static struct {
+	pthread_mutex_t mutex;
+	DARRAY(struct existing_job *) jobs;
+
+	volatile long count;
+	volatile bool batch_queued;
+	volatile bool active;
+
+	uint64_t budget_ns;
+	existing_apply_cb_t apply;
+} existing;
+
+static void free_target(struct existing_target *target)
+{
+	obs_weak_source_release(target->weak);
+	target->weak = NULL;
+	for (size_t i = 0; i < target->items.num; i++)
+		obs_sceneitem_release(target->items.array[i]);
+	da_free(target->items);
+}
+
+static void free_job(struct existing_job *job)
+{
+	for (size_t i = job->next; i < job->targets.num; i++)
+		free_target(&job->targets.array[i]);
+	da_free(job->targets);
+	obs_weak_source_release(job->filter_weak);
+	bfree(job->name);
+	bfree(job);
+}
+
+static struct existing_job *find_job_locked(obs_source_t *filter)
+{
+	for (size_t i = 0; i < existing.jobs.num; i++) {
+		struct existing_job *job = existing.jobs.array[i];
+		if (obs_weak_source_references_source(job->filter_weak, filter))
+			return job;
+	}
+	return NULL;
+}
+
+static void report_progress(struct existing_job *job)
+{
+	size_t total = job->targets.num;
+	int tenth = (int)(job->next * 10 / total);
+	if (tenth <= job->reported || job->next == total)
+		return;
+
+	job->reported = tenth;
+	blog(LOG_INFO, "Applying '%s' to existing sources: %d%% (%zu/%zu)",
+	     job->name, tenth * 10, job->next, total);
+}
+
+static void finish_job(struct existing_job *job, bool cancelled)
+{
+	double ms = (double)(os_gettime_ns() - job->start_ns) / 1000000.0;
+	if (cancelled)
+		blog(LOG_INFO,
+		     "Applying '%s' to existing sources was cancelled after "
+		     "%zu of %zu sources",
+		     job->name, job->applied, job->targets.num);
+	else
+		blog(LOG_INFO,
+		     "Applied '%s' to %zu existing sources in %.1f ms",
+		     job->name, job->applied, ms);
+
+	pthread_mutex_lock(&existing.mutex);
+	da_erase_item(existing.jobs, &job);
+	pthread_mutex_unlock(&existing.mutex);
+	os_atomic_dec_long(&existing.count);
+	free_job(job);
+}
+
+/* UI thread, works on the oldest job until the budget is used */
+static void process_chunk(void *param)
+{
+	UNUSED_PARAMETER(param);
+	if (!os_atomic_load_bool(&existing.active))
+		return;
+
+	struct existing_job *job =
+		existing.jobs.num ? existing.jobs.array[0] : NULL;
+	if (!job) {
+		os_atomic_set_bool(&existing.batch_queued, false);
+		return;
+	}
+
+	obs_source_t *filter = obs_weak_source_get_source(job->filter_weak);
+	uint64_t start = os_gettime_ns();
+	uint64_t now = start;
+
+	while (filter && job->next < job->targets.num &&
+	       now - start < existing.budget_ns) {
+		struct existing_target *target = &job->targets.array[job->next];
+		obs_source_t *dst = obs_weak_source_get_source(target->weak);
+		if (dst) {
+			existing.apply(filter, dst, target->items.array,
+				       target->items.num);
+			obs_source_release(dst);
+			job->applied++;
+		}
+		free_target(target);
+
+		pthread_mutex_lock(&existing.mutex);
+		job->next++;
+		pthread_mutex_unlock(&existing.mutex);
+		now = os_gettime_ns();
+	}
+
+	if (!filter || job->next == job->targets.num)
+		finish_job(job, !filter);
+	else
+		report_progress(job);
+
+	obs_source_release(filter);
+	os_atomic_set_bool(&existing.batch_queued, false);
+}
+
+/* Graphics thread, schedules at most one chunk per frame */
+static void existing_tick(void *param, float seconds)
+{
+	UNUSED_PARAMETER(param);
+	UNUSED_PARAMETER(seconds);
+
+	if (!os_atomic_load_long(&existing.count))
+		return;
+	if (os_atomic_exchange_bool(&existing.batch_queued, true))
+		return;
+	obs_queue_task(OBS_TASK_UI, process_chunk, NULL, false);
+}
+
+struct collect_data {
+	struct existing_job *job;
+	existing_select_cb_t select;
+	void *param;
+	struct hash_table targets; // obs_source_t * -> index + 1
+};
+
+static bool collect_source(void *param, obs_source_t *source)
+{
+	struct collect_data *data = param;
+	if (!data->select(data->param, source))
+		return true;
+
+	struct existing_target target = {0};
+	target.weak = obs_source_get_weak_source(source);
+	size_t idx = da_push_back(data->job->targets, &target);
+	hash_table_set(&data->targets, source, (void *)(uintptr_t)(idx + 1));
+	return true;
+}
+
+static bool collect_item(obs_scene_t *scene, obs_sceneitem_t *item,
+			 void *param)
+{
+	UNUSED_PARAMETER(scene);
+	struct collect_data *data = param;
+	uintptr_t idx = (uintptr_t)hash_table_get(
+		&data->targets, obs_sceneitem_get_source(item));
+	if (idx) {
+		struct existing_target *target =
+			&data->job->targets.array[idx - 1];
+		obs_sceneitem_addref(item);
+		da_push_back(target->items, &item);
+	}
+	return true;
+}
+
+static bool collect_scene(void *param, obs_source_t *scene)
+{
+	obs_scene_enum_items(obs_scene_from_source(scene), collect_item,
+			     param);
+	return true;
+}
+
+bool existing_sources_start(obs_source_t *filter, existing_select_cb_t select,
+			    void *param, bool with_items)
+{
+	pthread_mutex_lock(&existing.mutex);
+	bool running = find_job_locked(filter) != NULL;
+	pthread_mutex_unlock(&existing.mutex);
+	if (running)
+		return false;
+
+	struct existing_job *job = bzalloc(sizeof(struct existing_job));
+	job->filter_weak = obs_source_get_weak_source(filter);
+	job->name = bstrdup(obs_source_get_name(filter));
+	job->start_ns = os_gettime_ns();
+
+	struct collect_data data = {
+		.job = job,
+		.select = select,
+		.param = param,
+	};
+	hash_table_init(&data.targets, hash_table_hash_ptr,
+			hash_table_equal_ptr);
+	obs_enum_sources(collect_source, &data);
+	if (with_items && job->targets.num)
+		obs_enum_scenes(collect_scene, &data);
+	hash_table_free(&data.targets);
+
+	if (!job->targets.num) {
+		blog(LOG_INFO, "No existing sources to apply '%s' to",
+		     job->name);
+		free_job(job);
+		return true;
+	}
+
+	blog(LOG_INFO, "Applying '%s' to %zu existing sources", job->name,
+	     job->targets.num);
+	pthread_mutex_lock(&existing.mutex);
+	da_push_back(existing.jobs, &job);
+	pthread_mutex_unlock(&existing.mutex);
+	os_atomic_inc_long(&existing.count);
+	return true;
+}
+
+bool existing_sources_progress(obs_source_t *filter, size_t *done,
+			       size_t *total)
+{
+	pthread_mutex_lock(&existing.mutex);
+	struct existing_job *job = find_job_locked(filter);
+	if (job) {
+		*done = job->next;
+		*total = job->targets.num;
+	}
+	pthread_mutex_unlock(&existing.mutex);
+	return job != NULL;
+}
+
+void existing_sources_init(existing_apply_cb_t apply)
+{
+	pthread_mutex_init(&existing.mutex, NULL);
+	da_init(existing.jobs);
+	existing.apply = apply;
+
+	existing.budget_ns = plugin_settings_batch_budget_ns();
+
+	os_atomic_set_bool(&existing.active, true);
+	obs_add_tick_callback(existing_tick, NULL);
+}
+
+void existing_sources_free(void)
+{
+	obs_remove_tick_callback(existing_tick, NULL);
+	os_atomic_set_bool(&existing.active, false);
+
+	for (size_t i = 0; i < existing.jobs.num; i++)
+		free_job(existing.jobs.array[i]);
+	da_free(existing.jobs);
+	os_atomic_set_long(&existing.count, 0);
+	pthread_mutex_destroy(&existing.mutex);
+}
@@ -0,0 +1,50 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <obs.h>
+
+/**
+ * Applies the defaults of a filter to sources that already exist. The
+ * sources (and their scene items, if needed) are collected once, then
+ * processed on the UI thread in chunks of one per rendered frame, each
+ * limited to the same time budget as the apply queue, so updating
+ * thousands of sources keeps the UI and the render loop responsive.
+ */
+
+typedef bool (*existing_select_cb_t)(void *param, obs_source_t *source);
+typedef void (*existing_apply_cb_t)(obs_source_t *filter, obs_source_t *dst,
+				    obs_sceneitem_t *const *items,
+				    size_t num_items);
+
+extern void existing_sources_init(existing_apply_cb_t apply);
+extern void existing_sources_free(void);
+
+/**
+ * UI thread only. Calls select for every public source, with_items also
+ * collects the scene items of the selected ones. Returns false if a job
+ * for the filter is already running. The job ends early if the filter is
+ * destroyed.
+ */
+extern bool existing_sources_start(obs_source_t *filter,
+				   existing_select_cb_t select, void *param,
+				   bool with_items);
+/* False if no job is running for the filter */
+extern bool existing_sources_progress(obs_source_t *filter, size_t *done,
+				      size_t *total);
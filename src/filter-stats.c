@@ -0,0 +1,212 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <string.h>
+#include <obs-module.h>
+#include <util/dstr.h>
+#include <util/platform.h>
+
+#include "plugin-macros.generated.h"
+#include "filter-stats.h"
+#include "plugin-settings.h"
+
+/* clang-format off */
+
+static const char *counter_names[] = {
+	"seen",
+	"matched",
+	"encountered",
+	"applied",
+	"deferred_visibility",
+};
+
+static const char *stage_names[] = {
+	"properties",
+	"filters",
+	"audio",
+	"scene_item",
+	"rename",
+};
+
+/* clang-format on */
+
+static struct filter_stats global_stats;
+
+static struct {
+	float interval;
+	float elapsed;
+	uint64_t last_applied;
+	uint64_t last_seen;
+} summary;
+
+static inline double ns_to_ms(uint64_t ns)
+{
+	return (double)ns / 1000000.0;
+}
+
+static void copy_stats(struct filter_stats *stats, struct filter_stats *copy)
+{
+	pthread_mutex_lock(&stats->mutex);
+	memcpy(copy->counters, stats->counters, sizeof(copy->counters));
+	memcpy(copy->stages, stats->stages, sizeof(copy->stages));
+	pthread_mutex_unlock(&stats->mutex);
+}
+
+static obs_data_t *stats_to_data(struct filter_stats *stats, bool global)
+{
+	struct filter_stats copy;
+	copy_stats(stats, &copy);
+
+	obs_data_t *data = obs_data_create();
+	for (size_t i = global ? 0 : 1; i < STATS_COUNTER_COUNT; i++)
+		obs_data_set_int(data, counter_names[i],
+				 (long long)copy.counters[i]);
+
+	obs_data_t *stages = obs_data_create();
+	for (size_t i = 0; i < STATS_STAGE_COUNT; i++) {
+		struct stats_stage_time *stage = &copy.stages[i];
+		obs_data_t *stage_data = obs_data_create();
+		obs_data_set_int(stage_data, "count",
+				 (long long)stage->count);
+		obs_data_set_double(stage_data, "total_ms",
+				    ns_to_ms(stage->total_ns));
+		obs_data_set_double(stage_data, "max_ms",
+				    ns_to_ms(stage->max_ns));
+		obs_data_set_obj(stages, stage_names[i], stage_data);
+		obs_data_release(stage_data);
+	}
+	obs_data_set_obj(data, "stages", stages);
+	obs_data_release(stages);
+	return data;
+}
+
+static void get_stats_proc(void *data, calldata_t *cd)
+{
+	struct filter_stats *stats = data;
+	obs_data_t *stats_data = stats_to_data(stats, stats == &global_stats);
+	calldata_set_string(cd, "stats", obs_data_get_json(stats_data));
+	obs_data_release(stats_data);
+}
+
+static void add_stage(struct filter_stats *stats, enum stats_stage stage,
+		      uint64_t ns)
+{
+	struct stats_stage_time *time = &stats->stages[stage];
+
+	pthread_mutex_lock(&stats->mutex);
+	time->count++;
+	time->total_ns += ns;
+	if (ns > time->max_ns)
+		time->max_ns = ns;
+	pthread_mutex_unlock(&stats->mutex);
+}
+
+void filter_stats_count(struct filter_stats *stats, enum stats_counter counter)
+{
+	if (stats) {
+		pthread_mutex_lock(&stats->mutex);
+		stats->counters[counter]++;
+		pthread_mutex_unlock(&stats->mutex);
+	}
+	pthread_mutex_lock(&global_stats.mutex);
+	global_stats.counters[counter]++;
+	pthread_mutex_unlock(&global_stats.mutex);
+}
+
+void filter_stats_stage(struct filter_stats *stats, enum stats_stage stage,
+			uint64_t start)
+{
+	uint64_t ns = os_gettime_ns() - start;
+	if (stats)
+		add_stage(stats, stage, ns);
+	add_stage(&global_stats, stage, ns);
+}
+
+void filter_stats_init(struct filter_stats *stats, obs_source_t *filter)
+{
+	memset(stats, 0, sizeof(*stats));
+	pthread_mutex_init(&stats->mutex, NULL);
+
+	proc_handler_t *ph = obs_source_get_proc_handler(filter);
+	proc_handler_add(ph, "void get_stats(out string stats)",
+			 get_stats_proc, stats);
+}
+
+void filter_stats_free(struct filter_stats *stats)
+{
+	pthread_mutex_destroy(&stats->mutex);
+}
+
+static void log_summary(void)
+{
+	struct filter_stats copy;
+	copy_stats(&global_stats, &copy);
+
+	// stay quiet while nothing happens
+	if (copy.counters[STATS_SEEN] == summary.last_seen &&
+	    copy.counters[STATS_APPLIED] == summary.last_applied)
+		return;
+	summary.last_seen = copy.counters[STATS_SEEN];
+	summary.last_applied = copy.counters[STATS_APPLIED];
+
+	struct dstr line = {0};
+	for (size_t i = 0; i < STATS_COUNTER_COUNT; i++)
+		dstr_catf(&line, "%s%s %llu", i ? ", " : "", counter_names[i],
+			  (unsigned long long)copy.counters[i]);
+	dstr_cat(&line, "; ms total/max:");
+	for (size_t i = 0; i < STATS_STAGE_COUNT; i++)
+		dstr_catf(&line, " %s %.1f/%.2f", stage_names[i],
+			  ns_to_ms(copy.stages[i].total_ns),
+			  ns_to_ms(copy.stages[i].max_ns));
+
+	blog(LOG_INFO, "stats: %s", line.array);
+	dstr_free(&line);
+}
+
+static void stats_tick(void *param, float seconds)
+{
+	UNUSED_PARAMETER(param);
+	summary.elapsed += seconds;
+	if (summary.elapsed < summary.interval)
+		return;
+
+	summary.elapsed = 0.0f;
+	log_summary();
+}
+
+void filter_stats_global_init(void)
+{
+	memset(&global_stats, 0, sizeof(global_stats));
+	pthread_mutex_init(&global_stats.mutex, NULL);
+
+	proc_handler_t *ph = obs_get_proc_handler();
+	proc_handler_add(ph, "void source_defaults_get_stats(out string stats)",
+			 get_stats_proc, &global_stats);
+
+	summary.interval = plugin_settings_stats_interval();
+	if (summary.interval > 0.0f)
+		obs_add_tick_callback(stats_tick, NULL);
+}
+
+void filter_stats_global_free(void)
+{
+	if (summary.interval > 0.0f)
+		obs_remove_tick_callback(stats_tick, NULL);
+	log_summary();
+	pthread_mutex_destroy(&global_stats.mutex);
+}
@@ -0,0 +1,72 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <obs.h>
+#include <util/threading.h>
+
+/**
+ * Counters and stage timings, per filter and for the whole plugin. Every
+ * filter has a `get_stats` proc (`void get_stats(out string stats)`) and
+ * the global proc handler has `source_defaults_get_stats`, both return
+ * JSON. A compact summary is also logged periodically.
+ */
+
+enum stats_counter {
+	STATS_SEEN, // only counted globally
+	STATS_MATCHED,
+	STATS_ENCOUNTERED,
+	STATS_APPLIED,
+	STATS_DEFERRED_VISIBILITY,
+	STATS_COUNTER_COUNT,
+};
+
+enum stats_stage {
+	STATS_STAGE_PROPERTIES,
+	STATS_STAGE_FILTERS,
+	STATS_STAGE_AUDIO,
+	STATS_STAGE_SCENEITEM,
+	STATS_STAGE_RENAME,
+	STATS_STAGE_COUNT,
+};
+
+struct stats_stage_time {
+	uint64_t count;
+	uint64_t total_ns;
+	uint64_t max_ns;
+};
+
+struct filter_stats {
+	pthread_mutex_t mutex;
+	uint64_t counters[STATS_COUNTER_COUNT];
+	struct stats_stage_time stages[STATS_STAGE_COUNT];
+};
+
+extern void filter_stats_init(struct filter_stats *stats,
+			      obs_source_t *filter);
+extern void filter_stats_free(struct filter_stats *stats);
+
+/* stats may be NULL to only count globally */
+extern void filter_stats_count(struct filter_stats *stats,
+			       enum stats_counter counter);
+extern void filter_stats_stage(struct filter_stats *stats,
+			       enum stats_stage stage, uint64_t start);
+
+extern void filter_stats_global_init(void);
+extern void filter_stats_global_free(void);
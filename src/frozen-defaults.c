@@ -0,0 +1,311 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <obs-module.h>
+#include <obs-frontend-api.h>
+#include <util/darray.h>
+#include <util/threading.h>
+
+#include "plugin-macros.generated.h"
+#include "frozen-defaults.h"
+
+#define SAVE_KEY "source_defaults_frozen"
+
+static struct {
+	pthread_mutex_t mutex;
+	DARRAY(struct frozen_defaults *) frozen;
+	DARRAY(struct frozen_defaults *) library; // read-only, not saved
+	frozen_changed_cb_t changed;
+} store;
+
+void frozen_defaults_save(const struct frozen_defaults *frozen,
+			  obs_data_t *data)
+{
+	obs_data_set_string(data, "name", frozen->name);
+	obs_data_set_string(data, "type", frozen->type);
+	obs_data_set_string(data, "id", frozen->id);
+	obs_data_set_obj(data, "filter_settings", frozen->filter_settings);
+	obs_data_set_int(data, "monitoring", frozen->monitoring);
+
+	obs_data_t *source = obs_data_create();
+	source_snapshot_save(frozen->snapshot, source);
+	obs_data_set_obj(data, "source", source);
+	obs_data_release(source);
+
+	if (frozen->sceneitem_snapshot) {
+		obs_data_t *item = obs_data_create();
+		sceneitem_snapshot_save(frozen->sceneitem_snapshot, item);
+		obs_data_set_obj(data, "scene_item", item);
+		obs_data_release(item);
+	}
+}
+
+struct frozen_defaults *frozen_defaults_load(obs_data_t *data)
+{
+	obs_data_t *source = obs_data_get_obj(data, "source");
+	if (!source)
+		return NULL;
+
+	struct frozen_defaults *frozen =
+		bzalloc(sizeof(struct frozen_defaults));
+	frozen->refs = 1;
+	frozen->name = bstrdup(obs_data_get_string(data, "name"));
+	frozen->type = bstrdup(obs_data_get_string(data, "type"));
+	frozen->id = bstrdup(obs_data_get_string(data, "id"));
+	frozen->filter_settings = obs_data_get_obj(data, "filter_settings");
+	if (!frozen->filter_settings)
+		frozen->filter_settings = obs_data_create();
+	frozen->monitoring =
+		(enum obs_monitoring_type)obs_data_get_int(data, "monitoring");
+
+	frozen->snapshot = source_snapshot_load(source);
+	obs_data_release(source);
+
+	obs_data_t *item = obs_data_get_obj(data, "scene_item");
+	if (item)
+		frozen->sceneitem_snapshot = sceneitem_snapshot_load(item);
+	obs_data_release(item);
+	return frozen;
+}
+
+struct frozen_defaults *
+frozen_defaults_create(obs_source_t *source, obs_data_t *filter_settings,
+		       const struct source_snapshot *snapshot,
+		       const struct sceneitem_snapshot *sceneitem_snapshot)
+{
+	// going through the saved form drops every live reference
+	struct frozen_defaults parts = {
+		.name = (char *)obs_source_get_name(source),
+		.type = (char *)obs_source_get_unversioned_id(source),
+		.id = (char *)obs_source_get_id(source),
+		.filter_settings = filter_settings,
+		.monitoring = obs_source_get_monitoring_type(source),
+		.snapshot = (struct source_snapshot *)snapshot,
+		.sceneitem_snapshot =
+			(struct sceneitem_snapshot *)sceneitem_snapshot,
+	};
+	obs_data_t *data = obs_data_create();
+	frozen_defaults_save(&parts, data);
+	struct frozen_defaults *frozen = frozen_defaults_load(data);
+	obs_data_release(data);
+	return frozen;
+}
+
+void frozen_defaults_addref(struct frozen_defaults *frozen)
+{
+	if (frozen)
+		os_atomic_inc_long(&frozen->refs);
+}
+
+void frozen_defaults_release(struct frozen_defaults *frozen)
+{
+	if (!frozen || os_atomic_dec_long(&frozen->refs) > 0)
+		return;
+
+	bfree(frozen->name);
+	bfree(frozen->type);
+	bfree(frozen->id);
+	obs_data_release(frozen->filter_settings);
+	source_snapshot_release(frozen->snapshot);
+	sceneitem_snapshot_release(frozen->sceneitem_snapshot);
+	bfree(frozen);
+}
+
+static size_t find_locked(const char *name)
+{
+	for (size_t i = 0; i < store.frozen.num; i++) {
+		if (strcmp(store.frozen.array[i]->name, name) == 0)
+			return i;
+	}
+	return DARRAY_INVALID;
+}
+
+static void clear_locked(void)
+{
+	for (size_t i = 0; i < store.frozen.num; i++)
+		frozen_defaults_release(store.frozen.array[i]);
+	da_resize(store.frozen, 0);
+}
+
+static void clear_library_locked(void)
+{
+	for (size_t i = 0; i < store.library.num; i++)
+		frozen_defaults_release(store.library.array[i]);
+	da_resize(store.library, 0);
+}
+
+void frozen_store_put(struct frozen_defaults *frozen)
+{
+	if (!frozen)
+		return;
+
+	pthread_mutex_lock(&store.mutex);
+	size_t idx = find_locked(frozen->name);
+	if (idx != DARRAY_INVALID) {
+		frozen_defaults_release(store.frozen.array[idx]);
+		store.frozen.array[idx] = frozen;
+	} else {
+		da_push_back(store.frozen, &frozen);
+	}
+	pthread_mutex_unlock(&store.mutex);
+
+	store.changed();
+}
+
+bool frozen_store_remove(const char *name)
+{
+	pthread_mutex_lock(&store.mutex);
+	size_t idx = find_locked(name);
+	if (idx != DARRAY_INVALID) {
+		frozen_defaults_release(store.frozen.array[idx]);
+		da_erase(store.frozen, idx);
+	}
+	pthread_mutex_unlock(&store.mutex);
+
+	if (idx != DARRAY_INVALID)
+		store.changed();
+	return idx != DARRAY_INVALID;
+}
+
+void frozen_store_set_library(struct frozen_defaults **frozen, size_t count)
+{
+	pthread_mutex_lock(&store.mutex);
+	clear_library_locked();
+	da_push_back_array(store.library, frozen, count);
+	pthread_mutex_unlock(&store.mutex);
+
+	store.changed();
+}
+
+void frozen_store_enum(frozen_enum_cb_t enum_cb, void *param)
+{
+	pthread_mutex_lock(&store.mutex);
+	bool more = true;
+	for (size_t i = 0; more && i < store.frozen.num; i++)
+		more = enum_cb(param, store.frozen.array[i]);
+	for (size_t i = 0; more && i < store.library.num; i++) {
+		struct frozen_defaults *frozen = store.library.array[i];
+		if (find_locked(frozen->name) == DARRAY_INVALID)
+			more = enum_cb(param, frozen);
+	}
+	pthread_mutex_unlock(&store.mutex);
+}
+
+/* The frozen defaults belong to the scene collection they were made in */
+static void frozen_save_cb(obs_data_t *save_data, bool saving, void *param)
+{
+	UNUSED_PARAMETER(param);
+
+	if (saving) {
+		obs_data_array_t *array = obs_data_array_create();
+		pthread_mutex_lock(&store.mutex);
+		for (size_t i = 0; i < store.frozen.num; i++) {
+			obs_data_t *data = obs_data_create();
+			frozen_defaults_save(store.frozen.array[i], data);
+			obs_data_array_push_back(array, data);
+			obs_data_release(data);
+		}
+		pthread_mutex_unlock(&store.mutex);
+		obs_data_set_array(save_data, SAVE_KEY, array);
+		obs_data_array_release(array);
+		return;
+	}
+
+	obs_data_array_t *array = obs_data_get_array(save_data, SAVE_KEY);
+	size_t count = obs_data_array_count(array);
+
+	pthread_mutex_lock(&store.mutex);
+	clear_locked();
+	for (size_t i = 0; i < count; i++) {
+		obs_data_t *data = obs_data_array_item(array, i);
+		struct frozen_defaults *frozen = frozen_defaults_load(data);
+		if (frozen)
+			da_push_back(store.frozen, &frozen);
+		obs_data_release(data);
+	}
+	pthread_mutex_unlock(&store.mutex);
+	obs_data_array_release(array);
+
+	if (count)
+		blog(LOG_INFO, "Loaded %zu frozen default sources", count);
+	store.changed();
+}
+
+static bool list_frozen_enum(void *param, struct frozen_defaults *frozen)
+{
+	obs_data_array_t *names = param;
+	obs_data_t *entry = obs_data_create();
+	obs_data_set_string(entry, "name", frozen->name);
+	obs_data_set_string(entry, "type", frozen->type);
+	// store.mutex is held by frozen_store_enum()
+	obs_data_set_bool(entry, "library",
+			  find_locked(frozen->name) == DARRAY_INVALID);
+	obs_data_array_push_back(names, entry);
+	obs_data_release(entry);
+	return true;
+}
+
+static void list_frozen_proc(void *data, calldata_t *cd)
+{
+	UNUSED_PARAMETER(data);
+	obs_data_t *result = obs_data_create();
+	obs_data_array_t *names = obs_data_array_create();
+	frozen_store_enum(list_frozen_enum, names);
+
+	obs_data_set_array(result, "frozen", names);
+	calldata_set_string(cd, "frozen", obs_data_get_json(result));
+	obs_data_array_release(names);
+	obs_data_release(result);
+}
+
+static void remove_frozen_proc(void *data, calldata_t *cd)
+{
+	UNUSED_PARAMETER(data);
+	const char *name = calldata_string(cd, "name");
+	calldata_set_bool(cd, "removed", name && frozen_store_remove(name));
+}
+
+void frozen_store_init(frozen_changed_cb_t changed)
+{
+	pthread_mutex_init(&store.mutex, NULL);
+	da_init(store.frozen);
+	da_init(store.library);
+	store.changed = changed;
+
+	proc_handler_t *ph = obs_get_proc_handler();
+	proc_handler_add(ph,
+			 "void source_defaults_list_frozen(out string frozen)",
+			 list_frozen_proc, NULL);
+	proc_handler_add(
+		ph,
+		"void source_defaults_remove_frozen(in string name, out bool removed)",
+		remove_frozen_proc, NULL);
+
+	obs_frontend_add_save_callback(frozen_save_cb, NULL);
+}
+
+void frozen_store_free(void)
+{
+	obs_frontend_remove_save_callback(frozen_save_cb, NULL);
+
+	clear_locked();
+	clear_library_locked();
+	da_free(store.frozen);
+	da_free(store.library);
+	pthread_mutex_destroy(&store.mutex);
+}
@@ -0,0 +1,73 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <obs.h>
+
+#include "defaults-snapshot.h"
+
+/**
+ * Defaults that were frozen from a default source, so the source itself
+ * (and the browser, decoder or device behind it) doesn't have to stay
+ * around as a template. They are stored with the scene collection and
+ * served from data alone. Frozen defaults are immutable, freezing the same
+ * source again replaces them.
+ *
+ * Defaults from a shared library file are kept apart from the ones of the
+ * scene collection, which take precedence when both have the same name.
+ */
+
+struct frozen_defaults {
+	volatile long refs;
+	char *name; // of the source they were frozen from
+	char *type; // unversioned id
+	char *id;
+	obs_data_t *filter_settings;
+	enum obs_monitoring_type monitoring;
+	struct source_snapshot *snapshot;
+	struct sceneitem_snapshot *sceneitem_snapshot; // NULL without an item
+};
+
+/* Copies everything, nothing refers to the source afterwards */
+extern struct frozen_defaults *
+frozen_defaults_create(obs_source_t *source, obs_data_t *filter_settings,
+		       const struct source_snapshot *snapshot,
+		       const struct sceneitem_snapshot *sceneitem_snapshot);
+extern void frozen_defaults_save(const struct frozen_defaults *frozen,
+				 obs_data_t *data);
+/* Returns NULL if the data has no source snapshot */
+extern struct frozen_defaults *frozen_defaults_load(obs_data_t *data);
+extern void frozen_defaults_addref(struct frozen_defaults *frozen);
+extern void frozen_defaults_release(struct frozen_defaults *frozen);
+
+/* Called (without any lock held) after the stored defaults changed */
+typedef void (*frozen_changed_cb_t)(void);
+typedef bool (*frozen_enum_cb_t)(void *param, struct frozen_defaults *frozen);
+
+extern void frozen_store_init(frozen_changed_cb_t changed);
+extern void frozen_store_free(void);
+
+/* Takes over the reference, replaces defaults frozen from the same name */
+extern void frozen_store_put(struct frozen_defaults *frozen);
+extern bool frozen_store_remove(const char *name);
+/* Takes over the references and replaces all defaults of the library */
+extern void frozen_store_set_library(struct frozen_defaults **frozen,
+				     size_t count);
+/* The store is locked during the enumeration, library defaults come last */
+extern void frozen_store_enum(frozen_enum_cb_t enum_cb, void *param);
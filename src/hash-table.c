@@ -0,0 +1,213 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <string.h>
+#include <util/bmem.h>
+
+#include "hash-table.h"
+
+#define ENTRY_EMPTY 0
+#define ENTRY_USED 1
+#define ENTRY_DELETED 2
+
+#define MIN_CAPACITY 16
+
+void hash_table_init(struct hash_table *table, hash_table_hash_t hash,
+		     hash_table_equal_t equal)
+{
+	memset(table, 0, sizeof(*table));
+	table->hash = hash;
+	table->equal = equal;
+}
+
+void hash_table_free(struct hash_table *table)
+{
+	bfree(table->entries);
+	table->entries = NULL;
+	table->capacity = 0;
+	table->count = 0;
+	table->used = 0;
+}
+
+void hash_table_clear(struct hash_table *table)
+{
+	if (table->entries)
+		memset(table->entries, 0,
+		       table->capacity * sizeof(struct hash_table_entry));
+	table->count = 0;
+	table->used = 0;
+}
+
+static struct hash_table_entry *find_entry(const struct hash_table *table,
+					   const void *key, uint32_t hash)
+{
+	size_t mask = table->capacity - 1;
+	size_t idx = hash & mask;
+
+	for (;;) {
+		struct hash_table_entry *entry = &table->entries[idx];
+		if (entry->state == ENTRY_EMPTY)
+			return NULL;
+		if (entry->state == ENTRY_USED && entry->hash == hash &&
+		    table->equal(entry->key, key))
+			return entry;
+		idx = (idx + 1) & mask;
+	}
+}
+
+static void insert_entry(struct hash_table *table, const void *key,
+			 void *value, uint32_t hash)
+{
+	size_t mask = table->capacity - 1;
+	size_t idx = hash & mask;
+
+	while (table->entries[idx].state == ENTRY_USED)
+		idx = (idx + 1) & mask;
+
+	struct hash_table_entry *entry = &table->entries[idx];
+	if (entry->state == ENTRY_EMPTY)
+		table->used++;
+	entry->key = key;
+	entry->value = value;
+	entry->hash = hash;
+	entry->state = ENTRY_USED;
+	table->count++;
+}
+
+static void rehash(struct hash_table *table, size_t capacity)
+{
+	struct hash_table_entry *old_entries = table->entries;
+	size_t old_capacity = table->capacity;
+
+	table->entries = bzalloc(capacity * sizeof(struct hash_table_entry));
+	table->capacity = capacity;
+	table->count = 0;
+	table->used = 0;
+
+	for (size_t i = 0; i < old_capacity; i++) {
+		struct hash_table_entry *entry = &old_entries[i];
+		if (entry->state == ENTRY_USED)
+			insert_entry(table, entry->key, entry->value,
+				     entry->hash);
+	}
+	bfree(old_entries);
+}
+
+void *hash_table_get(const struct hash_table *table, const void *key)
+{
+	if (!table->count)
+		return NULL;
+
+	struct hash_table_entry *entry =
+		find_entry(table, key, table->hash(key));
+	return entry ? entry->value : NULL;
+}
+
+void *hash_table_set(struct hash_table *table, const void *key, void *value)
+{
+	uint32_t hash = table->hash(key);
+
+	if (table->count) {
+		struct hash_table_entry *entry = find_entry(table, key, hash);
+		if (entry) {
+			void *old_value = entry->value;
+			entry->key = key;
+			entry->value = value;
+			return old_value;
+		}
+	}
+
+	// keep the load factor (including tombstones) below 3/4
+	if ((table->used + 1) * 4 > table->capacity * 3) {
+		size_t capacity = table->capacity ? table->capacity
+						  : MIN_CAPACITY;
+		while ((table->count + 1) * 2 > capacity)
+			capacity *= 2;
+		rehash(table, capacity);
+	}
+
+	insert_entry(table, key, value, hash);
+	return NULL;
+}
+
+void *hash_table_remove(struct hash_table *table, const void *key)
+{
+	if (!table->count)
+		return NULL;
+
+	struct hash_table_entry *entry =
+		find_entry(table, key, table->hash(key));
+	if (!entry)
+		return NULL;
+
+	void *value = entry->value;
+	entry->key = NULL;
+	entry->value = NULL;
+	entry->state = ENTRY_DELETED;
+	table->count--;
+	return value;
+}
+
+bool hash_table_next(const struct hash_table *table, size_t *idx,
+		     const void **key, void **value)
+{
+	for (; *idx < table->capacity; (*idx)++) {
+		struct hash_table_entry *entry = &table->entries[*idx];
+		if (entry->state != ENTRY_USED)
+			continue;
+
+		if (key)
+			*key = entry->key;
+		if (value)
+			*value = entry->value;
+		(*idx)++;
+		return true;
+	}
+	return false;
+}
+
+/* FNV-1a */
+uint32_t hash_table_hash_str(const void *key)
+{
+	const unsigned char *str = key;
+	uint32_t hash = 2166136261u;
+	while (*str) {
+		hash ^= *str++;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+bool hash_table_equal_str(const void *key1, const void *key2)
+{
+	return strcmp(key1, key2) == 0;
+}
+
+uint32_t hash_table_hash_ptr(const void *key)
+{
+	uint64_t val = (uint64_t)(uintptr_t)key;
+	val ^= val >> 33;
+	val *= 0xff51afd7ed558ccdULL;
+	val ^= val >> 33;
+	return (uint32_t)val;
+}
+
+bool hash_table_equal_ptr(const void *key1, const void *key2)
+{
+	return key1 == key2;
+}
@@ -0,0 +1,78 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <util/c99defs.h>
+
+/**
+ * Small open-addressing hash table. Keys are not copied, so the caller has
+ * to keep them alive for as long as they are in the table (usually by
+ * storing the key inside the value).
+ */
+
+typedef uint32_t (*hash_table_hash_t)(const void *key);
+typedef bool (*hash_table_equal_t)(const void *key1, const void *key2);
+
+struct hash_table_entry {
+	const void *key;
+	void *value;
+	uint32_t hash;
+	uint8_t state;
+};
+
+struct hash_table {
+	struct hash_table_entry *entries;
+	size_t capacity;
+	size_t count;
+	size_t used; // live entries plus tombstones
+	hash_table_hash_t hash;
+	hash_table_equal_t equal;
+};
+
+extern void hash_table_init(struct hash_table *table, hash_table_hash_t hash,
+			    hash_table_equal_t equal);
+extern void hash_table_free(struct hash_table *table);
+extern void hash_table_clear(struct hash_table *table);
+
+extern void *hash_table_get(const struct hash_table *table, const void *key);
+/* Inserts or replaces, returns the previous value (or NULL) */
+extern void *hash_table_set(struct hash_table *table, const void *key,
+			    void *value);
+/* Returns the removed value (or NULL). Safe to call while iterating. */
+extern void *hash_table_remove(struct hash_table *table, const void *key);
+
+/**
+ * Iterates over all entries, start with *idx = 0:
+ *
+ *   size_t idx = 0;
+ *   void *value;
+ *   while (hash_table_next(&table, &idx, NULL, &value)) { ... }
+ */
+extern bool hash_table_next(const struct hash_table *table, size_t *idx,
+			    const void **key, void **value);
+
+static inline size_t hash_table_count(const struct hash_table *table)
+{
+	return table->count;
+}
+
+extern uint32_t hash_table_hash_str(const void *key);
+extern bool hash_table_equal_str(const void *key1, const void *key2);
+extern uint32_t hash_table_hash_ptr(const void *key);
+extern bool hash_table_equal_ptr(const void *key1, const void *key2);
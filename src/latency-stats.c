@@ -0,0 +1,103 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <obs-module.h>
+#include <util/threading.h>
+
+#include "plugin-macros.generated.h"
+#include "latency-stats.h"
+
+#define SUB_STEPS (1 << LATENCY_SUB_BITS)
+
+static size_t bucket_index(uint64_t ns)
+{
+	if (ns < SUB_STEPS)
+		return (size_t)ns;
+
+	size_t msb = 0;
+	while (ns >> (msb + 1))
+		msb++;
+	if (msb >= LATENCY_MAX_BITS)
+		return LATENCY_BUCKETS - 1;
+
+	size_t sub = (size_t)(ns >> (msb - LATENCY_SUB_BITS)) & (SUB_STEPS - 1);
+	return ((msb - LATENCY_SUB_BITS + 1) << LATENCY_SUB_BITS) + sub;
+}
+
+static uint64_t bucket_upper_bound(size_t idx)
+{
+	if (idx < SUB_STEPS)
+		return idx;
+
+	size_t shift = (idx >> LATENCY_SUB_BITS) - 1;
+	uint64_t sub = idx & (SUB_STEPS - 1);
+	return ((SUB_STEPS + sub + 1) << shift) - 1;
+}
+
+void latency_stats_record(struct latency_stats *stats, uint64_t ns)
+{
+	os_atomic_inc_long(&stats->buckets[bucket_index(ns)]);
+	os_atomic_inc_long(&stats->count);
+
+	long us = (long)(ns / 1000);
+	long max_us = os_atomic_load_long(&stats->max_us);
+	while (us > max_us &&
+	       !os_atomic_compare_swap_long(&stats->max_us, max_us, us))
+		max_us = os_atomic_load_long(&stats->max_us);
+}
+
+uint64_t latency_stats_percentile(const struct latency_stats *stats,
+				  double percentile)
+{
+	long count = os_atomic_load_long(&stats->count);
+	long target = (long)((double)count * percentile / 100.0 + 0.5);
+	if (target < 1)
+		target = 1;
+
+	long seen = 0;
+	for (size_t i = 0; i < LATENCY_BUCKETS; i++) {
+		seen += os_atomic_load_long(&stats->buckets[i]);
+		if (seen >= target)
+			return bucket_upper_bound(i);
+	}
+	return 0;
+}
+
+void latency_stats_log(const struct latency_stats *stats)
+{
+	long count = os_atomic_load_long(&stats->count);
+	if (!count)
+		return;
+
+	blog(LOG_INFO,
+	     "%s latency: %ld samples, p50 %.3f ms, p90 %.3f ms, "
+	     "p99 %.3f ms, max %.3f ms",
+	     stats->name, count,
+	     (double)latency_stats_percentile(stats, 50.0) / 1000000.0,
+	     (double)latency_stats_percentile(stats, 90.0) / 1000000.0,
+	     (double)latency_stats_percentile(stats, 99.0) / 1000000.0,
+	     (double)os_atomic_load_long(&stats->max_us) / 1000.0);
+}
+
+void latency_stats_reset(struct latency_stats *stats)
+{
+	for (size_t i = 0; i < LATENCY_BUCKETS; i++)
+		os_atomic_set_long(&stats->buckets[i], 0);
+	os_atomic_set_long(&stats->count, 0);
+	os_atomic_set_long(&stats->max_us, 0);
+}
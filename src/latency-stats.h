@@ -0,0 +1,45 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <util/c99defs.h>
+
+/**
+ * Lock-free latency histogram for the hot paths, logged when the plugin is
+ * unloaded. Buckets are logarithmic with four steps per power of two, so
+ * percentiles are accurate to within 25%.
+ */
+
+#define LATENCY_SUB_BITS 2
+#define LATENCY_MAX_BITS 40 // about 18 minutes in ns
+#define LATENCY_BUCKETS (((LATENCY_MAX_BITS - 1) << LATENCY_SUB_BITS) + 4)
+
+struct latency_stats {
+	const char *name;
+	volatile long buckets[LATENCY_BUCKETS];
+	volatile long count;
+	volatile long max_us;
+};
+
+extern void latency_stats_record(struct latency_stats *stats, uint64_t ns);
+/* Upper bound of the bucket that holds the given percentile, in ns */
+extern uint64_t latency_stats_percentile(const struct latency_stats *stats,
+					 double percentile);
+extern void latency_stats_log(const struct latency_stats *stats);
+extern void latency_stats_reset(struct latency_stats *stats);
@@ -18,8 +18,11 @@ with this program. If not, see <https://www.gnu.org/licenses/>
 
 #include <obs-frontend-api.h>
 #include <obs-module.h>
+#include <util/platform.h>
 
 #include "plugin-macros.generated.h"
+#include "source-defaults-filter.h"
+#include "event-trace.h"
 
 OBS_DECLARE_MODULE()
 OBS_MODULE_USE_DEFAULT_LOCALE(PLUGIN_NAME, "en-US")
@@ -32,12 +35,35 @@ static void source_defaults_frontend_event_cb(enum obs_frontend_event event,
 					      void *data)
 {
 	UNUSED_PARAMETER(data);
+	uint64_t start = os_gettime_ns();
 	if (event == OBS_FRONTEND_EVENT_FINISHED_LOADING ||
 	    event == OBS_FRONTEND_EVENT_SCENE_COLLECTION_CHANGED) {
 		loaded = true;
-	} else if (event == OBS_FRONTEND_EVENT_SCENE_COLLECTION_CHANGING) {
+		source_defaults_collection_loaded();
+	} else if (event == OBS_FRONTEND_EVENT_SCENE_COLLECTION_CHANGING ||
+		   event == OBS_FRONTEND_EVENT_EXIT) {
 		loaded = false;
 	}
+
+	if (event == OBS_FRONTEND_EVENT_SCENE_LIST_CHANGED)
+		source_defaults_scene_list_changed();
+
+	switch (event) {
+	case OBS_FRONTEND_EVENT_FINISHED_LOADING:
+	case OBS_FRONTEND_EVENT_SCENE_COLLECTION_CHANGED:
+	case OBS_FRONTEND_EVENT_SCENE_CHANGED:
+	case OBS_FRONTEND_EVENT_PREVIEW_SCENE_CHANGED:
+	case OBS_FRONTEND_EVENT_SCENE_LIST_CHANGED:
+	case OBS_FRONTEND_EVENT_STUDIO_MODE_ENABLED:
+	case OBS_FRONTEND_EVENT_STUDIO_MODE_DISABLED:
+		source_defaults_target_scene_changed();
+		break;
+	default:
+		break;
+	}
+
+	if (event_trace_enabled())
+		event_trace_frontend(event, start);
 }
 
 bool obs_module_load(void)
@@ -46,6 +72,7 @@ bool obs_module_load(void)
 	     PLUGIN_VERSION);
 	obs_register_source(&source_defaults_video_info);
 	obs_register_source(&source_defaults_audio_info);
+	source_defaults_init();
 
 	obs_frontend_add_event_callback(source_defaults_frontend_event_cb,
 					NULL);
@@ -54,5 +81,6 @@ bool obs_module_load(void)
 
 void obs_module_unload()
 {
+	source_defaults_free();
 	blog(LOG_INFO, "plugin unloaded");
 }
@@ -0,0 +1,107 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <obs-module.h>
+#include <obs-frontend-api.h>
+
+#include "plugin-macros.generated.h"
+#include "plugin-settings.h"
+
+#define SECTION "SourceDefaults"
+
+#define BATCH_BUDGET "BatchBudgetMs"
+#define BURST_THRESHOLD "BurstThreshold"
+#define TRACE_EVENTS "TraceEvents"
+#define STATS_INTERVAL "StatsLogInterval"
+#define LIBRARY_PATH "LibraryPath"
+#define LIBRARY_POLL_INTERVAL "LibraryPollInterval"
+#define EXPENSIVE_FILTERS "ExpensiveFilters"
+
+#define DEFAULT_BATCH_BUDGET_MS 4
+#define DEFAULT_BURST_THRESHOLD 3
+#define DEFAULT_STATS_INTERVAL 300 // seconds
+#define DEFAULT_LIBRARY_POLL_INTERVAL 2 // seconds
+// filters that load models, LUTs or plugins when they are created
+#define DEFAULT_EXPENSIVE_FILTERS                                  \
+	"clut_filter,noise_suppress_filter,nv_greenscreen_filter," \
+	"vst_filter,shader_filter"
+
+void plugin_settings_init(void)
+{
+	config_t *config = obs_frontend_get_global_config();
+	config_set_default_uint(config, SECTION, BATCH_BUDGET,
+				DEFAULT_BATCH_BUDGET_MS);
+	config_set_default_uint(config, SECTION, BURST_THRESHOLD,
+				DEFAULT_BURST_THRESHOLD);
+	config_set_default_bool(config, SECTION, TRACE_EVENTS, false);
+	config_set_default_uint(config, SECTION, STATS_INTERVAL,
+				DEFAULT_STATS_INTERVAL);
+	config_set_default_string(config, SECTION, LIBRARY_PATH, "");
+	config_set_default_uint(config, SECTION, LIBRARY_POLL_INTERVAL,
+				DEFAULT_LIBRARY_POLL_INTERVAL);
+	config_set_default_string(config, SECTION, EXPENSIVE_FILTERS,
+				  DEFAULT_EXPENSIVE_FILTERS);
+}
+
+uint64_t plugin_settings_batch_budget_ns(void)
+{
+	config_t *config = obs_frontend_get_global_config();
+	uint64_t budget_ns =
+		config_get_uint(config, SECTION, BATCH_BUDGET) * 1000000ULL;
+
+	// a batch always applies at least one source, even with no budget
+	return budget_ns ? budget_ns : 1;
+}
+
+size_t plugin_settings_burst_threshold(void)
+{
+	config_t *config = obs_frontend_get_global_config();
+	return (size_t)config_get_uint(config, SECTION, BURST_THRESHOLD);
+}
+
+bool plugin_settings_trace_events(void)
+{
+	config_t *config = obs_frontend_get_global_config();
+	return config_get_bool(config, SECTION, TRACE_EVENTS);
+}
+
+float plugin_settings_stats_interval(void)
+{
+	config_t *config = obs_frontend_get_global_config();
+	return (float)config_get_uint(config, SECTION, STATS_INTERVAL);
+}
+
+const char *plugin_settings_library_path(void)
+{
+	config_t *config = obs_frontend_get_global_config();
+	const char *path = config_get_string(config, SECTION, LIBRARY_PATH);
+	return path && *path ? path : NULL;
+}
+
+float plugin_settings_library_poll_interval(void)
+{
+	config_t *config = obs_frontend_get_global_config();
+	return (float)config_get_uint(config, SECTION, LIBRARY_POLL_INTERVAL);
+}
+
+const char *plugin_settings_expensive_filters(void)
+{
+	config_t *config = obs_frontend_get_global_config();
+	const char *ids = config_get_string(config, SECTION, EXPENSIVE_FILTERS);
+	return ids ? ids : "";
+}
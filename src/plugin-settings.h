@@ -0,0 +1,44 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <obs.h>
+
+/**
+ * The [SourceDefaults] section of OBS's global.ini. All keys and their
+ * defaults live in plugin-settings.c, so modules that share a setting (like
+ * the batch budget of the apply queue and of existing sources) can't drift
+ * apart. plugin_settings_init() has to run before the modules read them.
+ */
+
+extern void plugin_settings_init(void);
+
+/* Time per frame for applying queued or existing sources, at least 1 ns */
+extern uint64_t plugin_settings_batch_budget_ns(void);
+/* Creations in quick succession that are applied before batching starts */
+extern size_t plugin_settings_burst_threshold(void);
+extern bool plugin_settings_trace_events(void);
+/* Seconds between the statistics summaries, 0 disables them */
+extern float plugin_settings_stats_interval(void);
+/* NULL without a shared defaults library */
+extern const char *plugin_settings_library_path(void);
+/* Seconds between checks for library changes, 0 only loads it once */
+extern float plugin_settings_library_poll_interval(void);
+/* Comma separated ids of the filters that can be attached after a frame */
+extern const char *plugin_settings_expensive_filters(void);
@@ -0,0 +1,493 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <string.h>
+#include <util/bmem.h>
+
+#include "hash-table.h"
+#include "profile-rules.h"
+
+// bitsets of up to this many words live on the stack while matching
+#define STACK_WORDS 16
+
+static void lowercase(char *str)
+{
+	for (; *str; str++) {
+		if (*str >= 'A' && *str <= 'Z')
+			*str += 'a' - 'A';
+	}
+}
+
+static bool is_separator(char c)
+{
+	return c == ',' || c == ';' || c == ' ' || c == '\t';
+}
+
+void profile_rules_parse(struct profile_rules *rules, const char *extensions,
+			 const char *name_pattern, const char *scene,
+			 enum rule_audio audio)
+{
+	memset(rules, 0, sizeof(*rules));
+
+	const char *pos = extensions ? extensions : "";
+	while (*pos) {
+		while (*pos && (is_separator(*pos) || *pos == '.'))
+			pos++;
+		const char *end = pos;
+		while (*end && !is_separator(*end))
+			end++;
+		if (end > pos) {
+			char *extension = bstrdup_n(pos, end - pos);
+			lowercase(extension);
+			da_push_back(rules->extensions, &extension);
+		}
+		pos = end;
+	}
+
+	if (name_pattern && *name_pattern)
+		rules->name_pattern = bstrdup(name_pattern);
+	if (scene && *scene)
+		rules->scene = bstrdup(scene);
+	rules->audio = audio;
+}
+
+void profile_rules_copy(struct profile_rules *dst,
+			const struct profile_rules *src)
+{
+	memset(dst, 0, sizeof(*dst));
+	for (size_t i = 0; i < src->extensions.num; i++) {
+		char *extension = bstrdup(src->extensions.array[i]);
+		da_push_back(dst->extensions, &extension);
+	}
+	dst->name_pattern = bstrdup(src->name_pattern);
+	dst->scene = bstrdup(src->scene);
+	dst->audio = src->audio;
+}
+
+void profile_rules_free(struct profile_rules *rules)
+{
+	for (size_t i = 0; i < rules->extensions.num; i++)
+		bfree(rules->extensions.array[i]);
+	da_free(rules->extensions);
+	bfree(rules->name_pattern);
+	bfree(rules->scene);
+	memset(rules, 0, sizeof(*rules));
+}
+
+static bool str_equal(const char *str1, const char *str2)
+{
+	if (!str1 || !str2)
+		return str1 == str2;
+	return strcmp(str1, str2) == 0;
+}
+
+bool profile_rules_equal(const struct profile_rules *rules1,
+			 const struct profile_rules *rules2)
+{
+	if (rules1->extensions.num != rules2->extensions.num ||
+	    rules1->audio != rules2->audio ||
+	    !str_equal(rules1->name_pattern, rules2->name_pattern) ||
+	    !str_equal(rules1->scene, rules2->scene))
+		return false;
+
+	for (size_t i = 0; i < rules1->extensions.num; i++) {
+		if (strcmp(rules1->extensions.array[i],
+			   rules2->extensions.array[i]) != 0)
+			return false;
+	}
+	return true;
+}
+
+int profile_rules_specificity(const struct profile_rules *rules)
+{
+	return (rules->extensions.num ? 1 : 0) +
+	       (rules->name_pattern ? 1 : 0) + (rules->scene ? 1 : 0) +
+	       (rules->audio != RULE_AUDIO_ANY ? 1 : 0);
+}
+
+bool rule_file_extension(const char *path, char *buf, size_t size)
+{
+	const char *dot = NULL;
+	for (const char *pos = path ? path : ""; *pos; pos++) {
+		if (*pos == '.')
+			dot = pos;
+		else if (*pos == '/' || *pos == '\\')
+			dot = NULL;
+	}
+	if (!dot || !dot[1])
+		return false;
+
+	size_t len = strlen(dot + 1);
+	if (len >= size)
+		return false;
+	memcpy(buf, dot + 1, len + 1);
+	lowercase(buf);
+	return true;
+}
+
+/************************/
+
+static const char *next_char(const char *str)
+{
+	str++;
+	while ((*str & 0xC0) == 0x80)
+		str++;
+	return str;
+}
+
+/* '?' matches one UTF-8 character, '*' any number of them */
+static bool glob_match(const char *pattern, const char *str)
+{
+	const char *star = NULL;
+	const char *retry = NULL;
+
+	while (*str) {
+		if (*pattern == '*') {
+			star = ++pattern;
+			retry = str;
+		} else if (*pattern == '?') {
+			pattern++;
+			str = next_char(str);
+		} else if (*pattern == *str) {
+			pattern++;
+			str++;
+		} else if (star) {
+			pattern = star;
+			str = retry = next_char(retry);
+		} else {
+			return false;
+		}
+	}
+	while (*pattern == '*')
+		pattern++;
+	return !*pattern;
+}
+
+static inline void bit_set(uint64_t *bits, size_t idx)
+{
+	bits[idx / 64] |= 1ULL << (idx % 64);
+}
+
+static inline bool bit_get(const uint64_t *bits, size_t idx)
+{
+	return (bits[idx / 64] >> (idx % 64)) & 1;
+}
+
+/* Profiles that require one extension, name or scene */
+struct bitset_entry {
+	char *key;
+	uint64_t *bits;
+};
+
+struct trie_child;
+
+/* Name patterns, keyed by their literal prefix */
+struct trie_node {
+	DARRAY(struct trie_child) children;
+	DARRAY(size_t) patterns; // profiles whose literal prefix ends here
+};
+
+struct trie_child {
+	char c;
+	struct trie_node *node;
+};
+
+struct compiled_profile {
+	int specificity;
+	char *pattern; // only for names with wildcards
+	size_t prefix_len;
+};
+
+struct rule_matcher {
+	size_t count;
+	size_t words;
+	struct compiled_profile *profiles;
+
+	uint64_t *ruled;
+	uint64_t *any_extension;
+	uint64_t *any_name;
+	uint64_t *any_scene;
+	uint64_t *audio_ok[2]; // indexed by whether the subject has audio
+
+	struct hash_table extensions; // -> struct bitset_entry
+	struct hash_table names;      // names without wildcards
+	struct hash_table scenes;
+	struct trie_node patterns;
+
+	bool uses_extension;
+	bool uses_patterns;
+};
+
+static uint64_t *bitset_create(const struct rule_matcher *matcher)
+{
+	return bzalloc(matcher->words * sizeof(uint64_t));
+}
+
+static uint64_t *get_bitset(struct rule_matcher *matcher,
+			    struct hash_table *table, const char *key)
+{
+	struct bitset_entry *entry = hash_table_get(table, key);
+	if (!entry) {
+		entry = bzalloc(sizeof(struct bitset_entry));
+		entry->key = bstrdup(key);
+		entry->bits = bitset_create(matcher);
+		hash_table_set(table, entry->key, entry);
+	}
+	return entry->bits;
+}
+
+static const uint64_t *find_bitset(const struct hash_table *table,
+				   const char *key)
+{
+	struct bitset_entry *entry = key ? hash_table_get(table, key) : NULL;
+	return entry ? entry->bits : NULL;
+}
+
+static void free_bitsets(struct hash_table *table)
+{
+	size_t idx = 0;
+	struct bitset_entry *entry;
+	while (hash_table_next(table, &idx, NULL, (void **)&entry)) {
+		bfree(entry->key);
+		bfree(entry->bits);
+		bfree(entry);
+	}
+	hash_table_free(table);
+}
+
+static struct trie_node *trie_child(const struct trie_node *node, char c)
+{
+	for (size_t i = 0; i < node->children.num; i++) {
+		if (node->children.array[i].c == c)
+			return node->children.array[i].node;
+	}
+	return NULL;
+}
+
+static struct trie_node *trie_insert(struct trie_node *node, const char *key,
+				     size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		struct trie_node *child = trie_child(node, key[i]);
+		if (!child) {
+			struct trie_child new_child = {
+				.c = key[i],
+				.node = bzalloc(sizeof(struct trie_node)),
+			};
+			da_push_back(node->children, &new_child);
+			child = new_child.node;
+		}
+		node = child;
+	}
+	return node;
+}
+
+static void trie_free(struct trie_node *node)
+{
+	for (size_t i = 0; i < node->children.num; i++) {
+		trie_free(node->children.array[i].node);
+		bfree(node->children.array[i].node);
+	}
+	da_free(node->children);
+	da_free(node->patterns);
+}
+
+static void compile_name(struct rule_matcher *matcher, size_t idx,
+			 const char *name_pattern)
+{
+	if (!name_pattern) {
+		bit_set(matcher->any_name, idx);
+		return;
+	}
+
+	size_t prefix_len = strcspn(name_pattern, "*?");
+	if (!name_pattern[prefix_len]) {
+		bit_set(get_bitset(matcher, &matcher->names, name_pattern),
+			idx);
+		return;
+	}
+
+	struct compiled_profile *profile = &matcher->profiles[idx];
+	profile->pattern = bstrdup(name_pattern);
+	profile->prefix_len = prefix_len;
+	struct trie_node *node =
+		trie_insert(&matcher->patterns, name_pattern, prefix_len);
+	da_push_back(node->patterns, &idx);
+	matcher->uses_patterns = true;
+}
+
+struct rule_matcher *
+rule_matcher_create(const struct profile_rules *const *rules, size_t count)
+{
+	struct rule_matcher *matcher = bzalloc(sizeof(struct rule_matcher));
+	matcher->count = count;
+	matcher->words = (count + 63) / 64;
+	matcher->profiles = bzalloc(count * sizeof(struct compiled_profile));
+	matcher->ruled = bitset_create(matcher);
+	matcher->any_extension = bitset_create(matcher);
+	matcher->any_name = bitset_create(matcher);
+	matcher->any_scene = bitset_create(matcher);
+	matcher->audio_ok[0] = bitset_create(matcher);
+	matcher->audio_ok[1] = bitset_create(matcher);
+	hash_table_init(&matcher->extensions, hash_table_hash_str,
+			hash_table_equal_str);
+	hash_table_init(&matcher->names, hash_table_hash_str,
+			hash_table_equal_str);
+	hash_table_init(&matcher->scenes, hash_table_hash_str,
+			hash_table_equal_str);
+
+	for (size_t i = 0; i < count; i++) {
+		const struct profile_rules *profile = rules[i];
+		matcher->profiles[i].specificity =
+			profile_rules_specificity(profile);
+		if (matcher->profiles[i].specificity)
+			bit_set(matcher->ruled, i);
+
+		if (!profile->extensions.num)
+			bit_set(matcher->any_extension, i);
+		for (size_t j = 0; j < profile->extensions.num; j++) {
+			bit_set(get_bitset(matcher, &matcher->extensions,
+					   profile->extensions.array[j]),
+				i);
+			matcher->uses_extension = true;
+		}
+
+		if (!profile->scene)
+			bit_set(matcher->any_scene, i);
+		else
+			bit_set(get_bitset(matcher, &matcher->scenes,
+					   profile->scene),
+				i);
+
+		if (profile->audio != RULE_AUDIO_WITH)
+			bit_set(matcher->audio_ok[0], i);
+		if (profile->audio != RULE_AUDIO_WITHOUT)
+			bit_set(matcher->audio_ok[1], i);
+
+		compile_name(matcher, i, profile->name_pattern);
+	}
+	return matcher;
+}
+
+void rule_matcher_destroy(struct rule_matcher *matcher)
+{
+	if (!matcher)
+		return;
+
+	for (size_t i = 0; i < matcher->count; i++)
+		bfree(matcher->profiles[i].pattern);
+	bfree(matcher->profiles);
+	bfree(matcher->ruled);
+	bfree(matcher->any_extension);
+	bfree(matcher->any_name);
+	bfree(matcher->any_scene);
+	bfree(matcher->audio_ok[0]);
+	bfree(matcher->audio_ok[1]);
+	free_bitsets(&matcher->extensions);
+	free_bitsets(&matcher->names);
+	free_bitsets(&matcher->scenes);
+	trie_free(&matcher->patterns);
+	bfree(matcher);
+}
+
+bool rule_matcher_has_rules(const struct rule_matcher *matcher, size_t idx)
+{
+	return idx < matcher->count && bit_get(matcher->ruled, idx);
+}
+
+bool rule_matcher_uses_extension(const struct rule_matcher *matcher)
+{
+	return matcher->uses_extension;
+}
+
+/* result &= any | required, where a missing required set is empty */
+static void and_either(uint64_t *result, const uint64_t *any,
+		       const uint64_t *required, size_t words)
+{
+	for (size_t i = 0; i < words; i++)
+		result[i] &= any[i] | (required ? required[i] : 0);
+}
+
+/* Only the patterns of profiles that are still candidates are evaluated */
+static void match_patterns(const struct rule_matcher *matcher,
+			   const struct trie_node *node, const char *rest,
+			   const uint64_t *candidates, uint64_t *name_ok)
+{
+	for (size_t i = 0; i < node->patterns.num; i++) {
+		size_t idx = node->patterns.array[i];
+		if (!bit_get(candidates, idx) || bit_get(name_ok, idx))
+			continue;
+
+		const struct compiled_profile *profile =
+			&matcher->profiles[idx];
+		if (glob_match(profile->pattern + profile->prefix_len, rest))
+			bit_set(name_ok, idx);
+	}
+}
+
+long rule_matcher_match(const struct rule_matcher *matcher,
+			const struct rule_subject *subject)
+{
+	size_t words = matcher->words;
+	uint64_t stack_bits[2 * STACK_WORDS];
+	uint64_t *result = words <= STACK_WORDS
+				   ? stack_bits
+				   : bmalloc(2 * words * sizeof(uint64_t));
+	uint64_t *name_ok = result + words;
+
+	memcpy(result, matcher->ruled, words * sizeof(uint64_t));
+	and_either(result, matcher->any_extension,
+		   find_bitset(&matcher->extensions, subject->extension),
+		   words);
+	and_either(result, matcher->any_scene,
+		   find_bitset(&matcher->scenes, subject->scene), words);
+	and_either(result, matcher->audio_ok[subject->has_audio ? 1 : 0],
+		   NULL, words);
+
+	// names last, the fewer candidates the fewer patterns to evaluate
+	const char *name = subject->name ? subject->name : "";
+	const uint64_t *exact = find_bitset(&matcher->names, name);
+	for (size_t i = 0; i < words; i++)
+		name_ok[i] = matcher->any_name[i] | (exact ? exact[i] : 0);
+
+	if (matcher->uses_patterns) {
+		const struct trie_node *node = &matcher->patterns;
+		for (size_t depth = 0; node; depth++) {
+			match_patterns(matcher, node, name + depth, result,
+				       name_ok);
+			if (!name[depth])
+				break;
+			node = trie_child(node, name[depth]);
+		}
+	}
+	for (size_t i = 0; i < words; i++)
+		result[i] &= name_ok[i];
+
+	long best = -1;
+	for (size_t i = 0; i < matcher->count; i++) {
+		if (!bit_get(result, i))
+			continue;
+		if (best < 0 || matcher->profiles[i].specificity >
+					matcher->profiles[best].specificity)
+			best = (long)i;
+	}
+
+	if (result != stack_bits)
+		bfree(result);
+	return best;
+}
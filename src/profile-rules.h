@@ -0,0 +1,86 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <util/c99defs.h>
+#include <util/darray.h>
+
+/**
+ * Rules that choose between several Source Defaults filters (profiles) on
+ * sources of the same type. Each filter parses its rules once per settings
+ * update, and the rules of all profiles of a type are compiled into a
+ * rule_matcher whenever that set changes. Matching a new source then takes
+ * a few hash lookups, a walk down a trie of the literal name prefixes and
+ * bitset operations, no matter how many profiles there are.
+ */
+
+enum rule_audio {
+	RULE_AUDIO_ANY,
+	RULE_AUDIO_WITH,
+	RULE_AUDIO_WITHOUT,
+};
+
+struct profile_rules {
+	DARRAY(char *) extensions; // lowercase, without the dot
+	char *name_pattern;        // '*' and '?' wildcards, NULL for any name
+	char *scene;               // NULL for any scene
+	enum rule_audio audio;
+};
+
+/* Extensions may be separated by commas, semicolons or spaces */
+extern void profile_rules_parse(struct profile_rules *rules,
+				const char *extensions,
+				const char *name_pattern, const char *scene,
+				enum rule_audio audio);
+extern void profile_rules_copy(struct profile_rules *dst,
+			       const struct profile_rules *src);
+extern void profile_rules_free(struct profile_rules *rules);
+extern bool profile_rules_equal(const struct profile_rules *rules1,
+				const struct profile_rules *rules2);
+/* Number of rules that are set, 0 if the profile matches every source */
+extern int profile_rules_specificity(const struct profile_rules *rules);
+
+/* What the rules are checked against */
+struct rule_subject {
+	const char *name;
+	const char *extension; // lowercase, NULL if the source has no file
+	const char *scene;     // where new sources are added, may be NULL
+	bool has_audio;
+};
+
+/* Writes the lowercase extension of path to buf, false if there is none */
+extern bool rule_file_extension(const char *path, char *buf, size_t size);
+
+struct rule_matcher;
+
+extern struct rule_matcher *
+rule_matcher_create(const struct profile_rules *const *rules, size_t count);
+extern void rule_matcher_destroy(struct rule_matcher *matcher);
+
+extern bool rule_matcher_has_rules(const struct rule_matcher *matcher,
+				   size_t idx);
+/* Whether subjects need an extension, reading it means reading settings */
+extern bool rule_matcher_uses_extension(const struct rule_matcher *matcher);
+
+/**
+ * Returns the index of the most specific profile with rules that matches
+ * the subject, or -1. Ties go to the profile that comes first.
+ */
+extern long rule_matcher_match(const struct rule_matcher *matcher,
+			       const struct rule_subject *subject);
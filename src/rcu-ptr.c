@@ -0,0 +1,78 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <string.h>
+#include <util/platform.h>
+#include <util/threading.h>
+
+#include "rcu-ptr.h"
+
+void rcu_ptr_init(struct rcu_ptr *rcu, void *ptr)
+{
+	memset(rcu, 0, sizeof(*rcu));
+	rcu->slots[0].ptr = ptr;
+}
+
+void *rcu_ptr_read_begin(struct rcu_ptr *rcu, long *slot)
+{
+	for (;;) {
+		long idx = os_atomic_load_long(&rcu->current);
+		os_atomic_inc_long(&rcu->slots[idx].readers);
+
+		// the writer only refills slots that are not current, so the
+		// slot is stable if it is still current after pinning it
+		if (os_atomic_load_long(&rcu->current) == idx) {
+			*slot = idx;
+			return rcu->slots[idx].ptr;
+		}
+		os_atomic_dec_long(&rcu->slots[idx].readers);
+	}
+}
+
+void rcu_ptr_read_end(struct rcu_ptr *rcu, long slot)
+{
+	os_atomic_dec_long(&rcu->slots[slot].readers);
+}
+
+void *rcu_ptr_publish(struct rcu_ptr *rcu, void *ptr)
+{
+	long old = os_atomic_load_long(&rcu->current);
+	long next = old;
+
+	// readers only pin other slots for a moment before retrying
+	for (;;) {
+		next = (next + 1) % RCU_PTR_SLOTS;
+		if (next == old) {
+			os_sleep_ms(0);
+			continue;
+		}
+		if (!os_atomic_load_long(&rcu->slots[next].readers))
+			break;
+	}
+
+	rcu->slots[next].ptr = ptr;
+	os_atomic_set_long(&rcu->current, next);
+
+	// wait for the readers that pinned the old slot in time
+	while (os_atomic_load_long(&rcu->slots[old].readers))
+		os_sleep_ms(0);
+
+	void *prev = rcu->slots[old].ptr;
+	rcu->slots[old].ptr = NULL;
+	return prev;
+}
@@ -0,0 +1,66 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <util/c99defs.h>
+
+/**
+ * A pointer that is read without taking a lock and replaced by one writer
+ * at a time, for state that every source creation reads but that rarely
+ * changes. libobs has no pointer sized atomics, so the pointer lives in a
+ * small ring of slots: a reader pins the current slot with a counter, and
+ * the writer only refills a slot that nobody pins.
+ *
+ * The read section only has to last for taking a reference:
+ *
+ *   long slot;
+ *   struct thing *thing = rcu_ptr_read_begin(&ptr, &slot);
+ *   thing_addref(thing);
+ *   rcu_ptr_read_end(&ptr, slot);
+ */
+
+#define RCU_PTR_SLOTS 4
+
+struct rcu_ptr_slot {
+	volatile long readers;
+	void *ptr;
+};
+
+struct rcu_ptr {
+	volatile long current;
+	struct rcu_ptr_slot slots[RCU_PTR_SLOTS];
+};
+
+extern void rcu_ptr_init(struct rcu_ptr *rcu, void *ptr);
+
+extern void *rcu_ptr_read_begin(struct rcu_ptr *rcu, long *slot);
+extern void rcu_ptr_read_end(struct rcu_ptr *rcu, long slot);
+
+/**
+ * Writers have to be serialized by the caller. Returns the replaced
+ * pointer once no reader can see it anymore, so the publisher's reference
+ * to it can be released right away.
+ */
+extern void *rcu_ptr_publish(struct rcu_ptr *rcu, void *ptr);
+
+/* The published pointer, only for the (serialized) writers */
+static inline void *rcu_ptr_current(const struct rcu_ptr *rcu)
+{
+	return rcu->slots[rcu->current].ptr;
+}
@@ -0,0 +1,221 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <obs-module.h>
+#include <obs-frontend-api.h>
+#include <util/darray.h>
+#include <util/threading.h>
+
+#include "plugin-macros.generated.h"
+#include "scene-catalog.h"
+#include "hash-table.h"
+
+struct catalog_entry {
+	char *name;
+	obs_source_t *scene; // only the key of catalog.scenes, no reference
+	obs_weak_source_t *scene_weak;
+};
+
+static struct {
+	pthread_mutex_t mutex;
+	struct hash_table names;  // name -> struct catalog_entry, first one
+	struct hash_table scenes; // obs_source_t * -> struct catalog_entry
+	DARRAY(struct catalog_entry *) order;
+} catalog;
+
+static void free_entry(struct catalog_entry *entry)
+{
+	obs_weak_source_release(entry->scene_weak);
+	bfree(entry->name);
+	bfree(entry);
+}
+
+static void clear_locked(void)
+{
+	for (size_t i = 0; i < catalog.order.num; i++) {
+		struct catalog_entry *entry = catalog.order.array[i];
+		hash_table_remove(&catalog.names, entry->name);
+		hash_table_remove(&catalog.scenes, entry->scene);
+		free_entry(entry);
+	}
+	da_resize(catalog.order, 0);
+}
+
+static void add_locked(obs_source_t *scene)
+{
+	if (hash_table_get(&catalog.scenes, scene))
+		return;
+
+	struct catalog_entry *entry = bzalloc(sizeof(struct catalog_entry));
+	entry->name = bstrdup(obs_source_get_name(scene));
+	entry->scene = scene;
+	entry->scene_weak = obs_source_get_weak_source(scene);
+	da_push_back(catalog.order, &entry);
+	hash_table_set(&catalog.scenes, scene, entry);
+	if (!hash_table_get(&catalog.names, entry->name))
+		hash_table_set(&catalog.names, entry->name, entry);
+}
+
+/* Another scene with the same name takes over, like obs_get_scene_by_name */
+static void unmap_locked(struct catalog_entry *entry)
+{
+	if (hash_table_get(&catalog.names, entry->name) != entry)
+		return;
+
+	hash_table_remove(&catalog.names, entry->name);
+	for (size_t i = 0; i < catalog.order.num; i++) {
+		struct catalog_entry *other = catalog.order.array[i];
+		if (other != entry && strcmp(other->name, entry->name) == 0) {
+			hash_table_set(&catalog.names, other->name, other);
+			break;
+		}
+	}
+}
+
+/* Groups are scenes too, but can't be parent scenes */
+static bool is_scene(obs_source_t *source)
+{
+	return obs_scene_from_source(source) != NULL;
+}
+
+static void scene_created(void *data, calldata_t *cd)
+{
+	UNUSED_PARAMETER(data);
+	obs_source_t *source = calldata_ptr(cd, "source");
+	if (!is_scene(source))
+		return;
+
+	pthread_mutex_lock(&catalog.mutex);
+	add_locked(source);
+	pthread_mutex_unlock(&catalog.mutex);
+}
+
+static void scene_destroyed(void *data, calldata_t *cd)
+{
+	UNUSED_PARAMETER(data);
+	obs_source_t *source = calldata_ptr(cd, "source");
+	if (!is_scene(source))
+		return;
+
+	pthread_mutex_lock(&catalog.mutex);
+	struct catalog_entry *entry =
+		hash_table_remove(&catalog.scenes, source);
+	if (entry) {
+		da_erase_item(catalog.order, &entry);
+		unmap_locked(entry);
+		free_entry(entry);
+	}
+	pthread_mutex_unlock(&catalog.mutex);
+}
+
+static void scene_renamed(void *data, calldata_t *cd)
+{
+	UNUSED_PARAMETER(data);
+	obs_source_t *source = calldata_ptr(cd, "source");
+	if (!is_scene(source))
+		return;
+
+	pthread_mutex_lock(&catalog.mutex);
+	struct catalog_entry *entry = hash_table_get(&catalog.scenes, source);
+	if (entry) {
+		unmap_locked(entry);
+		bfree(entry->name);
+		entry->name = bstrdup(calldata_string(cd, "new_name"));
+		if (!hash_table_get(&catalog.names, entry->name))
+			hash_table_set(&catalog.names, entry->name, entry);
+	}
+	pthread_mutex_unlock(&catalog.mutex);
+}
+
+/* clang-format off */
+
+static const struct {
+	const char *name;
+	signal_callback_t callback;
+} catalog_signals[] = {
+	{"source_create", scene_created},
+	{"source_destroy", scene_destroyed},
+	{"source_rename", scene_renamed},
+};
+
+/* clang-format on */
+
+void scene_catalog_init(void)
+{
+	pthread_mutex_init(&catalog.mutex, NULL);
+	hash_table_init(&catalog.names, hash_table_hash_str,
+			hash_table_equal_str);
+	hash_table_init(&catalog.scenes, hash_table_hash_ptr,
+			hash_table_equal_ptr);
+	da_init(catalog.order);
+
+	signal_handler_t *sh = obs_get_signal_handler();
+	for (size_t i = 0; i < OBS_COUNTOF(catalog_signals); i++)
+		signal_handler_connect(sh, catalog_signals[i].name,
+				       catalog_signals[i].callback, NULL);
+}
+
+void scene_catalog_free(void)
+{
+	signal_handler_t *sh = obs_get_signal_handler();
+	for (size_t i = 0; i < OBS_COUNTOF(catalog_signals); i++)
+		signal_handler_disconnect(sh, catalog_signals[i].name,
+					  catalog_signals[i].callback, NULL);
+
+	clear_locked();
+	da_free(catalog.order);
+	hash_table_free(&catalog.names);
+	hash_table_free(&catalog.scenes);
+	pthread_mutex_destroy(&catalog.mutex);
+}
+
+void scene_catalog_refresh(void)
+{
+	struct obs_frontend_source_list scenes = {0};
+	obs_frontend_get_scenes(&scenes);
+
+	pthread_mutex_lock(&catalog.mutex);
+	clear_locked();
+	for (size_t i = 0; i < scenes.sources.num; i++)
+		add_locked(scenes.sources.array[i]);
+	pthread_mutex_unlock(&catalog.mutex);
+
+	obs_frontend_source_list_free(&scenes);
+}
+
+obs_scene_t *scene_catalog_get(const char *name)
+{
+	pthread_mutex_lock(&catalog.mutex);
+	struct catalog_entry *entry = hash_table_get(&catalog.names, name);
+	obs_source_t *source =
+		entry ? obs_weak_source_get_source(entry->scene_weak) : NULL;
+	pthread_mutex_unlock(&catalog.mutex);
+
+	obs_scene_t *scene = obs_scene_from_source(source);
+	if (!scene)
+		obs_source_release(source);
+	return scene;
+}
+
+void scene_catalog_enum_names(scene_catalog_enum_cb_t enum_cb, void *param)
+{
+	pthread_mutex_lock(&catalog.mutex);
+	for (size_t i = 0; i < catalog.order.num; i++)
+		enum_cb(param, catalog.order.array[i]->name);
+	pthread_mutex_unlock(&catalog.mutex);
+}
@@ -0,0 +1,43 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <obs.h>
+
+/**
+ * Names of all scenes in the order of the frontend, shared by the property
+ * lists and the parent scene lookups of every filter. It follows
+ * `source_create`, `source_destroy` and `source_rename`, so looking up a
+ * scene by name doesn't go through all sources, and is rebuilt from the
+ * frontend when the scene list changes.
+ */
+
+typedef void (*scene_catalog_enum_cb_t)(void *param, const char *name);
+
+extern void scene_catalog_init(void);
+extern void scene_catalog_free(void);
+
+/* UI thread only */
+extern void scene_catalog_refresh(void);
+
+/* Returns a new reference to the first scene named name, or NULL */
+extern obs_scene_t *scene_catalog_get(const char *name);
+/* The catalog is locked during the enumeration */
+extern void scene_catalog_enum_names(scene_catalog_enum_cb_t enum_cb,
+				     void *param);
@@ -0,0 +1,255 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <obs-module.h>
+#include <util/darray.h>
+#include <util/threading.h>
+
+#include "scene-index.h"
+#include "hash-table.h"
+
+struct indexed_source {
+	obs_source_t *source; // key, not referenced
+	DARRAY(obs_sceneitem_t *) items; // bottom to top, referenced
+};
+
+struct scene_index {
+	long refs; // guarded by indexes.mutex
+	obs_source_t *scene_source; // key, valid while referenced
+
+	pthread_mutex_t mutex;
+	struct hash_table sources; // obs_source_t * -> struct indexed_source
+	bool dirty;
+	uint64_t version;
+};
+
+static struct {
+	pthread_mutex_t mutex;
+	struct hash_table scenes; // obs_source_t * -> struct scene_index
+} indexes;
+
+static void add_item(struct hash_table *sources, obs_sceneitem_t *item)
+{
+	obs_source_t *source = obs_sceneitem_get_source(item);
+	struct indexed_source *entry = hash_table_get(sources, source);
+	if (!entry) {
+		entry = bzalloc(sizeof(struct indexed_source));
+		entry->source = source;
+		hash_table_set(sources, source, entry);
+	}
+	obs_sceneitem_addref(item);
+	da_push_back(entry->items, &item);
+}
+
+static void remove_item(struct hash_table *sources, obs_sceneitem_t *item)
+{
+	obs_source_t *source = obs_sceneitem_get_source(item);
+	struct indexed_source *entry = hash_table_get(sources, source);
+	size_t idx = entry ? da_find(entry->items, &item, 0) : DARRAY_INVALID;
+	if (idx == DARRAY_INVALID)
+		return;
+
+	da_erase(entry->items, idx);
+	obs_sceneitem_release(item);
+	if (!entry->items.num) {
+		hash_table_remove(sources, source);
+		da_free(entry->items);
+		bfree(entry);
+	}
+}
+
+static void free_sources(struct hash_table *sources)
+{
+	size_t idx = 0;
+	struct indexed_source *entry;
+	while (hash_table_next(sources, &idx, NULL, (void **)&entry)) {
+		for (size_t i = 0; i < entry->items.num; i++)
+			obs_sceneitem_release(entry->items.array[i]);
+		da_free(entry->items);
+		bfree(entry);
+	}
+	hash_table_free(sources);
+}
+
+static bool build_sources_enum(obs_scene_t *scene, obs_sceneitem_t *item,
+			       void *param)
+{
+	UNUSED_PARAMETER(scene);
+	add_item(param, item);
+	return true;
+}
+
+static void item_added(void *data, calldata_t *cd)
+{
+	struct scene_index *index = data;
+	obs_sceneitem_t *item = calldata_ptr(cd, "item");
+
+	pthread_mutex_lock(&index->mutex);
+	index->version++;
+	// new items are always added on top
+	if (!index->dirty)
+		add_item(&index->sources, item);
+	pthread_mutex_unlock(&index->mutex);
+}
+
+static void item_removed(void *data, calldata_t *cd)
+{
+	struct scene_index *index = data;
+	obs_sceneitem_t *item = calldata_ptr(cd, "item");
+
+	pthread_mutex_lock(&index->mutex);
+	index->version++;
+	if (!index->dirty)
+		remove_item(&index->sources, item);
+	pthread_mutex_unlock(&index->mutex);
+}
+
+/* Removals aren't tracked until the rebuild, so the stale refs go now */
+static void items_reordered(void *data, calldata_t *cd)
+{
+	UNUSED_PARAMETER(cd);
+	struct scene_index *index = data;
+	struct hash_table stale;
+	hash_table_init(&stale, hash_table_hash_ptr, hash_table_equal_ptr);
+
+	pthread_mutex_lock(&index->mutex);
+	index->version++;
+	if (!index->dirty) {
+		struct hash_table sources = index->sources;
+		index->sources = stale;
+		stale = sources;
+		index->dirty = true;
+	}
+	pthread_mutex_unlock(&index->mutex);
+
+	free_sources(&stale);
+}
+
+/* clang-format off */
+
+static const struct {
+	const char *signal;
+	signal_callback_t callback;
+} index_signals[] = {
+	{"item_add", item_added},
+	{"item_remove", item_removed},
+	{"reorder", items_reordered},
+	{"refresh", items_reordered},
+};
+
+/* clang-format on */
+
+void scene_index_init(void)
+{
+	pthread_mutex_init(&indexes.mutex, NULL);
+	hash_table_init(&indexes.scenes, hash_table_hash_ptr,
+			hash_table_equal_ptr);
+}
+
+void scene_index_free(void)
+{
+	hash_table_free(&indexes.scenes);
+	pthread_mutex_destroy(&indexes.mutex);
+}
+
+struct scene_index *scene_index_acquire(obs_scene_t *scene)
+{
+	obs_source_t *scene_source = obs_scene_get_source(scene);
+
+	pthread_mutex_lock(&indexes.mutex);
+	struct scene_index *index =
+		hash_table_get(&indexes.scenes, scene_source);
+	if (!index) {
+		index = bzalloc(sizeof(struct scene_index));
+		index->scene_source = scene_source;
+		pthread_mutex_init(&index->mutex, NULL);
+		hash_table_init(&index->sources, hash_table_hash_ptr,
+				hash_table_equal_ptr);
+		index->dirty = true;
+		hash_table_set(&indexes.scenes, scene_source, index);
+
+		signal_handler_t *sh =
+			obs_source_get_signal_handler(scene_source);
+		for (size_t i = 0; i < OBS_COUNTOF(index_signals); i++)
+			signal_handler_connect(sh, index_signals[i].signal,
+					       index_signals[i].callback,
+					       index);
+	}
+	index->refs++;
+	pthread_mutex_unlock(&indexes.mutex);
+	return index;
+}
+
+void scene_index_release(struct scene_index *index)
+{
+	if (!index)
+		return;
+
+	pthread_mutex_lock(&indexes.mutex);
+	bool last = --index->refs == 0;
+	if (last)
+		hash_table_remove(&indexes.scenes, index->scene_source);
+	pthread_mutex_unlock(&indexes.mutex);
+	if (!last)
+		return;
+
+	signal_handler_t *sh =
+		obs_source_get_signal_handler(index->scene_source);
+	for (size_t i = 0; i < OBS_COUNTOF(index_signals); i++)
+		signal_handler_disconnect(sh, index_signals[i].signal,
+					  index_signals[i].callback, index);
+
+	free_sources(&index->sources);
+	pthread_mutex_destroy(&index->mutex);
+	bfree(index);
+}
+
+obs_sceneitem_t *scene_index_find(struct scene_index *index,
+				  obs_source_t *source)
+{
+	struct hash_table fresh;
+	hash_table_init(&fresh, hash_table_hash_ptr, hash_table_equal_ptr);
+
+	pthread_mutex_lock(&index->mutex);
+	if (index->dirty) {
+		// item_remove is signaled with the scene locked, so the scene
+		// can't be enumerated while holding the index mutex
+		uint64_t version = index->version;
+		pthread_mutex_unlock(&index->mutex);
+		obs_scene_enum_items(obs_scene_from_source(index->scene_source),
+				     build_sources_enum, &fresh);
+		pthread_mutex_lock(&index->mutex);
+
+		if (index->version == version) {
+			struct hash_table old = index->sources;
+			index->sources = fresh;
+			fresh = old;
+			index->dirty = false;
+		}
+	}
+
+	// if the scene changed during the rebuild, answer from the rebuild
+	struct hash_table *sources = index->dirty ? &fresh : &index->sources;
+	struct indexed_source *entry = hash_table_get(sources, source);
+	obs_sceneitem_t *item = entry ? entry->items.array[0] : NULL;
+	obs_sceneitem_addref(item);
+	pthread_mutex_unlock(&index->mutex);
+
+	free_sources(&fresh);
+	return item;
+}
@@ -0,0 +1,40 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <obs.h>
+
+/**
+ * Index from source to scene items for the parent scenes of the filters,
+ * shared by all filters with the same parent scene. It is kept up to date
+ * from `item_add`/`item_remove` and rebuilt lazily after `reorder` and
+ * `refresh`, so looking up the bottommost item of a source is constant time.
+ */
+
+struct scene_index;
+
+extern void scene_index_init(void);
+extern void scene_index_free(void);
+
+extern struct scene_index *scene_index_acquire(obs_scene_t *scene);
+extern void scene_index_release(struct scene_index *index);
+
+/* Returns a new reference to the bottommost item of source, or NULL */
+extern obs_sceneitem_t *scene_index_find(struct scene_index *index,
+					 obs_source_t *source);
@@ -20,12 +20,34 @@ with this program. If not, see <https://www.gnu.org/licenses/>
 #include <obs-frontend-api.h>
 #include <util/dstr.h>
 #include <util/base.h>
+#include <util/darray.h>
+#include <util/platform.h>
+#include <util/profiler.h>
+#include <util/threading.h>
 
 #include "plugin-macros.generated.h"
-
-// so that old sources don't return with an empty settings object,
-// thus letting us distinguish between "new" sources and recreated sources due to undo/redo
-#define ENCOUNTERED_KEY "com.source_defaults.encountered"
+#include "source-defaults-filter.h"
+#include "hash-table.h"
+#include "defaults-snapshot.h"
+#include "apply-queue.h"
+#include "deferred-filters.h"
+#include "transition-pool.h"
+#include "scene-index.h"
+#include "scene-catalog.h"
+#include "latency-stats.h"
+#include "event-trace.h"
+#include "filter-stats.h"
+#include "rcu-ptr.h"
+#include "profile-rules.h"
+#include "existing-sources.h"
+#include "frozen-defaults.h"
+#include "defaults-library.h"
+#include "plugin-settings.h"
+#include "encountered-sources.h"
+
+// Show/Hide state of a template that is kept inactive, in the filter settings.
+// Only present while the template is hidden.
+#define TEMPLATE_VISIBLE_KEY "com.source_defaults.template_visible"
 
 // source settings
 #define COPY_PROPERTIES 0
@@ -42,6 +64,12 @@ with this program. If not, see <https://www.gnu.org/licenses/>
 #define COPY_VISIBILITY 1
 #define COPY_VISIBILITY_TRANSITIONS 2
 
+// what "Apply to existing sources" applies
+#define EXISTING_PROPERTIES 0
+#define EXISTING_FILTERS 1
+#define EXISTING_AUDIO 2
+#define EXISTING_TRANSFORM 3
+
 #define S_SCENEITEM_SETTINGS "scene_item_settings"
 #define T_SCENEITEM_SETTINGS "Scene item settings"
 #define S_PARENT_SCENE "parent_scene"
@@ -51,6 +79,13 @@ with this program. If not, see <https://www.gnu.org/licenses/>
 	"The following settings of this source will be copied from the selected scene. " \
 	"If you have duplicates of this source, it will be copied from the bottommost one."
 
+#define S_SHARE_TRANSITIONS "share_visibility_transitions"
+#define T_SHARE_TRANSITIONS "Share Show/Hide Transitions"
+#define T_SHARE_TRANSITIONS_LONG_DESC                                                    \
+	"New scene items use one shared copy of each transition instead of their own. " \
+	"Editing the transition of one of them changes it for all of them. "            \
+	"Items added after that get a new copy."
+
 #define S_NAME_SETTINGS "name_settings"
 #define T_NAME_SETTINGS "Source name settings"
 #define S_PREFIX "name_prefix"
@@ -58,6 +93,60 @@ with this program. If not, see <https://www.gnu.org/licenses/>
 #define S_PREFIX_NOT_YET_APPLIED "prefix_not_yet_applied"
 #define T_PREFIX_NOT_YET_APPLIED "Only if not yet applied"
 
+#define S_PROFILE_RULES "profile_rules"
+#define T_PROFILE_RULES "Profile rules"
+#define T_PROFILE_RULES_DESC                                                             \
+	"Leave the rules empty to use this filter for every new source of its type. "    \
+	"With several filters on sources of the same type, a new source only gets the " \
+	"one whose rules match it most specifically."
+#define S_MATCH_EXTENSIONS "match_extensions"
+#define T_MATCH_EXTENSIONS "File extensions"
+#define T_MATCH_EXTENSIONS_LONG_DESC                                              \
+	"Comma separated, e.g. mp4, mov. Only media and image sources that are " \
+	"created from a file (e.g. by drag and drop) have one."
+#define S_MATCH_NAME "match_name"
+#define T_MATCH_NAME "Name pattern"
+#define T_MATCH_NAME_LONG_DESC \
+	"* matches any text and ? a single character, e.g. Camera*"
+#define S_MATCH_SCENE "match_scene"
+#define T_MATCH_SCENE "Target scene"
+#define T_MATCH_SCENE_LONG_DESC \
+	"The current scene (or the preview scene in studio mode) when the source is created."
+#define S_MATCH_AUDIO "match_audio"
+#define T_MATCH_AUDIO "Audio"
+
+#define S_EXISTING_SETTINGS "existing_settings"
+#define T_EXISTING_SETTINGS "Existing Sources"
+#define S_APPLY_EXISTING "apply_to_existing"
+#define T_APPLY_EXISTING "Apply to existing sources"
+#define T_APPLY_EXISTING_LONG_DESC                                                 \
+	"Applies the ticked categories to all existing sources of the same type. " \
+	"Sources that have their own Source Defaults filter are skipped. A scene " \
+	"rule picks the sources in that scene."
+
+#define S_FREEZE "freeze_template"
+#define T_FREEZE "Freeze template"
+#define T_FREEZE_LONG_DESC                                                         \
+	"Stores these defaults with the scene collection, so this source can be " \
+	"deleted. New sources get the frozen defaults when no Source Defaults "   \
+	"filter of their type applies."
+#define S_UNFREEZE "remove_frozen_template"
+#define T_UNFREEZE "Remove frozen template"
+
+#define S_KEEP_INACTIVE "keep_template_inactive"
+#define T_KEEP_INACTIVE "Keep this source inactive"
+#define T_KEEP_INACTIVE_LONG_DESC                                                   \
+	"Hides this source in its parent scene and leaves it out of the audio "    \
+	"mixer, so it isn't activated, rendered or mixed when the scene is "       \
+	"previewed or nested. New sources still get the Show/Hide state it had " \
+	"before."
+
+#define S_DEFER_EXPENSIVE_FILTERS "defer_expensive_filters"
+#define T_DEFER_EXPENSIVE_FILTERS "Attach expensive filters after the first frame"
+#define T_DEFER_EXPENSIVE_FILTERS_LONG_DESC                                     \
+	"Filters that are slow to create (LUTs, noise suppression, VST, etc.) " \
+	"are added once the new source shows its first frame."
+
 extern bool loaded;
 
 /* clang-format off */
@@ -81,6 +170,14 @@ static const char *sceneitem_option_keys[] = {
 	"copy_visibility_transitions",
 };
 
+// what "Apply to existing sources" applies
+static const char *existing_option_keys[] = {
+	"existing_properties",
+	"existing_filters",
+	"existing_audio",
+	"existing_transform",
+};
+
 static const char *option_labels[] = {
 	"Properties",
 	"Filters",
@@ -98,19 +195,33 @@ static const char *sceneitem_option_labels[] = {
 	"Show/Hide Transitions",
 };
 
+static const char *existing_option_labels[] = {
+	"Properties (replaces e.g. their file paths)",
+	"Missing Filters",
+	"Audio settings ticked above",
+	"Transform",
+};
+
 /* clang-format on */
-struct source_defaults {
-	obs_source_t *source; // the filter itself
+
+/**
+ * The settings of a filter as the creation paths see them. A published
+ * config is never modified: writers publish a modified copy, and readers
+ * keep a reference for as long as they apply one source, so creations on
+ * other threads neither lock nor see half of an update.
+ */
+struct defaults_config {
+	volatile long refs;
 	obs_weak_source_t *parent_source_weak;
-	obs_weak_source_t *dst_source_weak;
 	obs_weak_source_t *parent_scene_weak;
+	char *parent_scene_name;
 	bool options[OBS_COUNTOF(option_keys)];
 	bool sceneitem_options[OBS_COUNTOF(sceneitem_option_keys)];
-	char *parent_scene_name;
-
-	// for deferred sceneitem visibility, because toggling right away doesn't work
-	obs_sceneitem_t *src_sceneitem;
-	obs_sceneitem_t *dst_sceneitem;
+	bool existing_options[OBS_COUNTOF(existing_option_keys)];
+	bool defer_expensive_filters;
+	bool share_transitions;
+	bool keep_inactive;
+	struct profile_rules rules;
 
 	/* source name settings */
 	bool apply_name_settings;
@@ -118,71 +229,353 @@ struct source_defaults {
 	bool prefix_if_not_yet_applied;
 };
 
-struct sceneitem_find_data {
-	obs_source_t *source_to_find;
-	obs_sceneitem_t *found_sceneitem;
-	obs_source_t *scene_to_skip;
+struct source_defaults {
+	obs_source_t *source; // the filter itself
+	struct transition_pool transitions;
+	struct filter_stats stats;
+
+	/* struct defaults_config, config_mutex serializes the writers */
+	pthread_mutex_t config_mutex;
+	struct rcu_ptr config;
+
+	/* registry, guarded by registry.mutex */
+	bool registered;
+	bool composite_parent;
+	char *parent_type; // unversioned id of the parent, NULL until resolved
+	char *parent_id;
+	obs_source_t *monitored_parent; // not referenced, the filter is on it
+
+	/* cached defaults, rebuilt after the parent source/scene changes.
+	   Only the rebuilds take snapshot_mutex, readers use rcu_ptr. */
+	pthread_mutex_t snapshot_mutex;
+	struct rcu_ptr source_snapshot;
+	struct rcu_ptr sceneitem_snapshot;
+	struct scene_index *parent_scene_index; // guarded by snapshot_mutex
+	volatile bool source_snapshot_dirty;
+	volatile bool sceneitem_snapshot_dirty;
+
+	/* template kept inactive, the snapshots use template_visible */
+	volatile bool template_hidden;
+	volatile bool template_visible;
+	bool template_audio_off;    // audio turned off in this session
+	bool template_audio_active; // before that, UI thread only
+};
+
+/* Frozen defaults and the filter settings they were frozen with */
+struct frozen_profile {
+	struct frozen_defaults *defaults;
+	struct defaults_config *config;
+};
+
+struct type_view_filter {
+	obs_weak_source_t *filter_weak;
+	char *parent_id;
+};
+
+/* What a new source of one type is matched against, immutable */
+struct type_view {
+	volatile long refs;
+	char *type;
+	DARRAY(struct type_view_filter) filters;
+	struct rule_matcher *matcher; // NULL if none of the filters has rules
+
+	// only used when none of the filters applies
+	DARRAY(struct frozen_profile) frozen;
+	struct rule_matcher *frozen_matcher;
+};
+
+/* The type views of all types, replaced as a whole by the writers */
+struct registry_view {
+	volatile long refs;
+	struct hash_table types; // unversioned id -> struct type_view
+};
+
+/* All enabled filters of one source type, keyed by the unversioned id */
+struct defaults_type_entry {
+	char *type;
+	DARRAY(struct source_defaults *) filters;
+	DARRAY(struct frozen_profile) frozen;
+	struct type_view *view; // compiled from the above
 };
 
+/**
+ * One `source_create` handler for the whole plugin, so a new source only
+ * wakes up the filters of its own type instead of every filter. Creations
+ * read the published view without locking, the mutex is for the writers.
+ */
+static struct {
+	pthread_mutex_t mutex;
+	struct hash_table types;
+	// enabled filters that are not attached to a source yet
+	DARRAY(struct source_defaults *) unresolved;
+	volatile bool has_unresolved;
+	struct rcu_ptr view;
+} registry;
+
+struct pending_dst {
+	obs_weak_source_t *dst_weak;
+	struct source_defaults *src;
+	struct frozen_profile frozen; // instead of src
+	uint64_t expires_ns;
+};
+
+// the scene item is usually added right after the source is created
+#define PENDING_TIMEOUT_NS 10000000000ULL
+// bounds what sources that never get a scene item can hold on to
+#define MAX_PENDING 1024
+#define HUB_SWEEP_INTERVAL 0.25f
+
+/**
+ * Sources that still wait for their scene item. The scenes are only
+ * connected to `item_add` while something is pending: the source that makes
+ * the table non-empty connects every scene before its `source_create`
+ * handler returns, so its scene item can't be missed. Once the table is
+ * empty, each scene disconnects itself on its next `item_add`, inside its
+ * own signal, so a disconnect never races with the connect for a new
+ * pending source. Editing scenes costs nothing otherwise, unless the event
+ * trace needs every item.
+ */
+static struct {
+	pthread_mutex_t mutex;
+	struct hash_table pending; // obs_source_t * -> struct pending_dst
+	volatile long count;
+	bool armed;  // scenes are connected, or are being connected
+	long arming; // connects in progress
+
+	volatile bool sweep_queued;
+	float since_sweep; // graphics thread only
+} hub;
+
+/**
+ * Filters created while a scene collection loads. Their parent scenes only
+ * exist once loading has finished, then all of them are resolved in one
+ * pass over the scenes.
+ */
+static struct {
+	pthread_mutex_t mutex;
+	DARRAY(struct source_defaults *) filters;
+} loading;
+
+/**
+ * Name of the scene new sources are added to, for the profile rules. Only
+ * the UI thread publishes it, creations read it during matching.
+ */
+static struct rcu_ptr target_scene;
+
+/* measured around the dispatch of matched sources and scene items */
+static struct latency_stats creation_latency = {.name = "source_create"};
+static struct latency_stats item_add_latency = {.name = "item_add"};
+
+/* profiler regions, the profiler tells them apart by pointer */
+static const char *source_created_name = "source_defaults: source_created_cb";
+static const char *apply_name = "source_defaults: source_defaults_apply";
+static const char *scene_item_add_name = "source_defaults: scene_item_add_cb";
+static const char *apply_sceneitem_name =
+	"source_defaults: apply_sceneitem_defaults";
+static const char *transitions_name =
+	"source_defaults: copy_visibility_transitions";
+static const char *deferred_sceneitem_name =
+	"source_defaults: deferred_sceneitem_defaults";
+
+/* clang-format off */
+
+static const char *stage_names[STATS_STAGE_COUNT] = {
+	"source_defaults: copy_properties",
+	"source_defaults: copy_filters",
+	"source_defaults: copy_audio",
+	"source_defaults: copy_sceneitem_settings",
+	"source_defaults: apply_name_prefix",
+};
+
+/* clang-format on */
+
+static inline uint64_t stage_begin(enum stats_stage stage)
+{
+	profile_start(stage_names[stage]);
+	return os_gettime_ns();
+}
+
+static inline void stage_end(struct filter_stats *stats,
+			     enum stats_stage stage, uint64_t start)
+{
+	filter_stats_stage(stats, stage, start);
+	profile_end(stage_names[stage]);
+}
+
 /* Forward declarations */
-static void source_defaults_frontend_event_cb(enum obs_frontend_event event,
-					      void *data);
 static void source_defaults_enable(void *data, calldata_t *cd);
+static void source_defaults_get_defaults(obs_data_t *settings);
+extern struct obs_source_info source_defaults_video_info;
+extern struct obs_source_info source_defaults_audio_info;
 
 /************************/
 
-static void enum_filters(obs_source_t *src, obs_source_t *filter, void *param)
+static struct defaults_config *config_get(struct source_defaults *src)
 {
-	UNUSED_PARAMETER(src);
-	obs_source_t *dst = param;
-	const char *filter_id = obs_source_get_unversioned_id(filter);
-	if (strcmp(filter_id, "source_defaults_video") != 0 &&
-	    strcmp(filter_id, "source_defaults_audio") != 0) {
-		obs_source_copy_single_filter(dst, filter);
-	}
+	long slot;
+	struct defaults_config *config =
+		rcu_ptr_read_begin(&src->config, &slot);
+	os_atomic_inc_long(&config->refs);
+	rcu_ptr_read_end(&src->config, slot);
+	return config;
+}
+
+static void config_release(struct defaults_config *config)
+{
+	if (!config || os_atomic_dec_long(&config->refs) > 0)
+		return;
+
+	obs_weak_source_release(config->parent_source_weak);
+	obs_weak_source_release(config->parent_scene_weak);
+	bfree(config->parent_scene_name);
+	profile_rules_free(&config->rules);
+	bfree(config->prefix);
+	bfree(config);
+}
+
+/* Locks out other writers and returns a private copy to modify */
+static struct defaults_config *config_edit_begin(struct source_defaults *src)
+{
+	pthread_mutex_lock(&src->config_mutex);
+	const struct defaults_config *current = rcu_ptr_current(&src->config);
+
+	struct defaults_config *config = bmemdup(current, sizeof(*config));
+	config->refs = 1;
+	obs_weak_source_addref(config->parent_source_weak);
+	obs_weak_source_addref(config->parent_scene_weak);
+	config->parent_scene_name = bstrdup(current->parent_scene_name);
+	profile_rules_copy(&config->rules, &current->rules);
+	config->prefix = bstrdup(current->prefix);
+	return config;
+}
+
+static void config_edit_end(struct source_defaults *src,
+			    struct defaults_config *config)
+{
+	config_release(rcu_ptr_publish(&src->config, config));
+	pthread_mutex_unlock(&src->config_mutex);
+}
+
+/* For the rare writer that only replaces the parent source */
+static void config_set_parent_source(struct source_defaults *src,
+				     obs_source_t *parent_source)
+{
+	struct defaults_config *config = config_edit_begin(src);
+	obs_weak_source_release(config->parent_source_weak);
+	config->parent_source_weak = obs_source_get_weak_source(parent_source);
+	config_edit_end(src, config);
+}
+
+static void add_scene_name(void *param, const char *name)
+{
+	obs_property_list_add_string(param, name, name);
 }
 
 static void fill_scene_list(obs_property_t *scene_list)
 {
-	char **scene_names = obs_frontend_get_scene_names();
-	for (char **temp = scene_names; *temp; temp++) {
-		obs_property_list_add_string(scene_list, *temp, *temp);
+	scene_catalog_enum_names(add_scene_name, scene_list);
+}
+
+/**
+ * Same result as comparing `obs_data_get_json` against "{}" (only user set
+ * values are serialized), without serializing the whole settings tree.
+ */
+static bool has_user_values(obs_data_t *data)
+{
+	bool found = false;
+	obs_data_item_t *item = obs_data_first(data);
+	for (; item; obs_data_item_next(&item)) {
+		if (obs_data_item_has_user_value(item)) {
+			found = true;
+			break;
+		}
 	}
-	bfree(scene_names);
+	obs_data_item_release(&item);
+	return found;
 }
 
+/* What a source shows, drag and drop sets it before `source_create` */
+static const char *identity_keys[] = {"local_file", "file", "url", "input"};
+
 /**
- * Finds the first sceneitem that has the specified source, because the `source_create`
- * signal only returns the source.
+ * The settings are copied first, so the destination only gets one update.
+ * A path or URL the destination already has is kept.
  */
-static bool find_source_sceneitem(obs_scene_t *scene, obs_sceneitem_t *item,
-				  void *param)
-{
-	UNUSED_PARAMETER(scene);
-	struct sceneitem_find_data *find_data = param;
-	obs_source_t *current_source = obs_sceneitem_get_source(item);
-	if (current_source == find_data->source_to_find) {
-		obs_sceneitem_addref(item);
-		find_data->found_sceneitem = item;
-		return false;
+static void copy_properties(struct source_snapshot *snapshot,
+			    obs_source_t *dst)
+{
+	obs_data_t *settings = obs_data_create();
+	obs_data_apply(settings, snapshot->settings);
+
+	obs_data_t *current = obs_source_get_settings(dst);
+	for (size_t i = 0; i < OBS_COUNTOF(identity_keys); i++) {
+		if (obs_data_has_user_value(current, identity_keys[i]))
+			obs_data_erase(settings, identity_keys[i]);
 	}
-	return true;
+	obs_data_release(current);
+
+	obs_source_update(dst, settings);
+
+	obs_data_release(settings);
 }
 
-static bool find_source_sceneitem_all_scenes(void *param, obs_source_t *scene)
+/**
+ * Filters are created from the templates in the snapshot instead of
+ * duplicating the live filters of the default source one by one.
+ */
+static void copy_filters(const struct defaults_config *config,
+			 struct source_snapshot *snapshot, obs_source_t *dst)
 {
-	struct sceneitem_find_data *find_data = param;
-	if (strcmp(obs_source_get_name(scene),
-		   obs_source_get_name(find_data->scene_to_skip)) == 0)
-		return true;
-	obs_scene_enum_items(obs_scene_from_source(scene),
-			     find_source_sceneitem, find_data);
-	if (find_data->found_sceneitem)
-		return false;
-	return true;
+	for (size_t i = 0; i < snapshot->filters.num; i++) {
+		struct filter_template *tmpl = &snapshot->filters.array[i];
+		if (config->defer_expensive_filters && tmpl->expensive) {
+			deferred_filters_push(snapshot, i, dst);
+			continue;
+		}
+		obs_source_release(filter_template_attach(tmpl, dst));
+	}
+}
+
+/**
+ * Every audio setter emits its own signal, so values that already match
+ * (e.g. the default 100% volume) are not set again.
+ */
+static void copy_audio(const struct defaults_config *config,
+		       struct source_snapshot *snapshot,
+		       enum obs_monitoring_type monitoring, obs_source_t *dst)
+{
+	if (config->options[COPY_AUDIO_MONITORING]) {
+		if (obs_source_get_monitoring_type(dst) != monitoring)
+			obs_source_set_monitoring_type(dst, monitoring);
+	}
+	if (config->options[COPY_VOLUME]) {
+		float volume = snapshot->volume;
+		if (obs_source_get_volume(dst) != volume)
+			obs_source_set_volume(dst, volume);
+	}
+	if (config->options[COPY_MUTED]) {
+		bool muted = snapshot->muted;
+		if (obs_source_muted(dst) != muted)
+			obs_source_set_muted(dst, muted);
+	}
+	if (config->options[COPY_BALANCE]) {
+		float balance = snapshot->balance;
+		if (obs_source_get_balance_value(dst) != balance)
+			obs_source_set_balance_value(dst, balance);
+	}
+	if (config->options[COPY_SYNC_OFFSET]) {
+		int64_t sync_offset = snapshot->sync_offset;
+		if (obs_source_get_sync_offset(dst) != sync_offset)
+			obs_source_set_sync_offset(dst, sync_offset);
+	}
+	if (config->options[COPY_AUDIO_TRACKS]) {
+		uint32_t tracks = snapshot->mixers;
+		if (obs_source_get_audio_mixers(dst) != tracks)
+			obs_source_set_audio_mixers(dst, tracks);
+	}
 }
 
-static bool any_true(bool *booleans, size_t count)
+static bool any_true(const bool *booleans, size_t count)
 {
 	for (size_t i = 0; i < count; i++) {
 		if (booleans[i])
@@ -191,33 +584,41 @@ static bool any_true(bool *booleans, size_t count)
 	return false;
 }
 
-static void copy_transform(obs_sceneitem_t *src, obs_sceneitem_t *dst)
+static void copy_transform(struct sceneitem_snapshot *snapshot,
+			   obs_sceneitem_t *dst)
 {
 	obs_sceneitem_defer_update_begin(dst);
-	struct obs_transform_info info;
-	obs_sceneitem_get_info(src, &info);
-	obs_sceneitem_set_info(dst, &info);
-
-	struct obs_sceneitem_crop crop;
-	obs_sceneitem_get_crop(src, &crop);
-	obs_sceneitem_set_crop(dst, &crop);
+	obs_sceneitem_set_info(dst, &snapshot->info);
+	obs_sceneitem_set_crop(dst, &snapshot->crop);
 	obs_sceneitem_defer_update_end(dst);
 }
 
-static void copy_visibility_transitions(obs_sceneitem_t *src,
+/**
+ * Scene item transitions are private, like the ones the frontend creates,
+ * so they are saved with the scene item instead of piling up as sources.
+ */
+static void copy_visibility_transitions(struct source_defaults *defaults,
+					const struct defaults_config *config,
+					obs_sceneitem_t *src,
 					obs_sceneitem_t *dst)
 {
+	profile_start(transitions_name);
 	struct dstr new_name = {0};
 	const char *dst_name =
 		obs_source_get_name(obs_sceneitem_get_source(dst));
 	for (size_t i = 0; i < 2; i++) {
-		dstr_copy(&new_name, dst_name);
-		dstr_cat(&new_name,
-			 i ? " Show Transition" : " Hide Transition");
-
 		obs_source_t *transition = obs_sceneitem_get_transition(src, i);
-		obs_source_t *transition_copy =
-			obs_source_duplicate(transition, new_name.array, false);
+		obs_source_t *transition_copy;
+		if (config->share_transitions) {
+			transition_copy = transition_pool_get(
+				&defaults->transitions, transition, i);
+		} else {
+			dstr_copy(&new_name, dst_name);
+			dstr_cat(&new_name, i ? " Show Transition"
+					      : " Hide Transition");
+			transition_copy = obs_source_duplicate(
+				transition, new_name.array, true);
+		}
 		obs_sceneitem_set_transition(dst, i, transition_copy);
 		obs_source_release(transition_copy);
 
@@ -226,10 +627,12 @@ static void copy_visibility_transitions(obs_sceneitem_t *src,
 		obs_sceneitem_set_transition_duration(dst, i, duration);
 	}
 	dstr_free(&new_name);
+	profile_end(transitions_name);
 }
 
-static void log_changes(struct source_defaults *src, const char *src_name,
-			const char *dst_name, bool sceneitem_settings)
+static void log_changes(const struct defaults_config *config,
+			const char *src_name, const char *dst_name,
+			bool sceneitem_settings)
 {
 	struct dstr log = {0};
 	bool first_bool = true;
@@ -239,7 +642,7 @@ static void log_changes(struct source_defaults *src, const char *src_name,
 	if (sceneitem_settings) {
 		for (size_t i = 0; i < OBS_COUNTOF(sceneitem_option_keys);
 		     i++) {
-			if (src->sceneitem_options[i]) {
+			if (config->sceneitem_options[i]) {
 				if (first_bool) {
 					dstr_cat(&log,
 						 sceneitem_option_labels[i]);
@@ -252,7 +655,7 @@ static void log_changes(struct source_defaults *src, const char *src_name,
 		}
 	} else {
 		for (size_t i = 0; i < OBS_COUNTOF(option_keys); i++) {
-			if (src->options[i]) {
+			if (config->options[i]) {
 				if (first_bool) {
 					dstr_cat(&log, option_labels[i]);
 					first_bool = false;
@@ -264,7 +667,7 @@ static void log_changes(struct source_defaults *src, const char *src_name,
 		}
 	}
 	/* Source Name Settings */
-	if (src->apply_name_settings && strcmp(src->prefix, "") != 0) {
+	if (config->apply_name_settings && strcmp(config->prefix, "") != 0) {
 		if (first_bool) {
 			dstr_cat(&log, T_PREFIX);
 			first_bool = false;
@@ -281,108 +684,502 @@ static void log_changes(struct source_defaults *src, const char *src_name,
 	dstr_free(&log);
 }
 
+/* Deferred sceneitem visibility, because toggling right away doesn't work.
+   Every scene item gets its own, so items added together don't overwrite
+   each other. */
+struct deferred_visibility {
+	obs_sceneitem_t *src_sceneitem;
+	obs_sceneitem_t *dst_sceneitem;
+	bool visible; // for frozen defaults, which have no src_sceneitem
+};
+
+/**
+ * All toggles queued until the next frame, applied by a single graphics
+ * task instead of one task per scene item.
+ */
+static struct {
+	pthread_mutex_t mutex;
+	DARRAY(struct deferred_visibility) pending;
+	volatile bool task_queued;
+	volatile bool active;
+} visibility_batch;
+
+static void free_deferred_visibility(struct deferred_visibility *visibility)
+{
+	obs_sceneitem_release(visibility->src_sceneitem);
+	obs_sceneitem_release(visibility->dst_sceneitem);
+}
+
 static void deferred_sceneitem_defaults(void *data)
 {
-	struct source_defaults *src = data;
-	if (!src->src_sceneitem || !src->dst_sceneitem)
+	UNUSED_PARAMETER(data);
+	if (!os_atomic_load_bool(&visibility_batch.active))
+		return;
+
+	profile_start(deferred_sceneitem_name);
+	DARRAY(struct deferred_visibility) batch;
+	da_init(batch);
+
+	pthread_mutex_lock(&visibility_batch.mutex);
+	da_move(batch, visibility_batch.pending);
+	os_atomic_set_bool(&visibility_batch.task_queued, false);
+	pthread_mutex_unlock(&visibility_batch.mutex);
+
+	// the items only update their transforms once, after all toggles
+	for (size_t i = 0; i < batch.num; i++)
+		obs_sceneitem_defer_update_begin(batch.array[i].dst_sceneitem);
+	for (size_t i = 0; i < batch.num; i++) {
+		struct deferred_visibility *visibility = &batch.array[i];
+		obs_sceneitem_t *src_item = visibility->src_sceneitem;
+		bool visible = src_item ? obs_sceneitem_visible(src_item)
+					: visibility->visible;
+		obs_sceneitem_set_visible(visibility->dst_sceneitem, visible);
+	}
+	for (size_t i = 0; i < batch.num; i++) {
+		obs_sceneitem_defer_update_end(batch.array[i].dst_sceneitem);
+		free_deferred_visibility(&batch.array[i]);
+	}
+
+	da_free(batch);
+	profile_end(deferred_sceneitem_name);
+}
+
+static void queue_deferred_visibility(obs_sceneitem_t *src_sceneitem,
+				      obs_sceneitem_t *dst_sceneitem,
+				      bool visible)
+{
+	struct deferred_visibility visibility = {
+		.src_sceneitem = src_sceneitem,
+		.dst_sceneitem = dst_sceneitem,
+		.visible = visible,
+	};
+	obs_sceneitem_addref(src_sceneitem);
+	obs_sceneitem_addref(dst_sceneitem);
+
+	pthread_mutex_lock(&visibility_batch.mutex);
+	da_push_back(visibility_batch.pending, &visibility);
+	bool queue_task =
+		!os_atomic_exchange_bool(&visibility_batch.task_queued, true);
+	pthread_mutex_unlock(&visibility_batch.mutex);
+
+	if (queue_task)
+		obs_queue_task(OBS_TASK_GRAPHICS, deferred_sceneitem_defaults,
+			       NULL, false);
+}
+
+static void parent_source_changed(void *data, calldata_t *cd);
+
+/* clang-format off */
+
+// signals of the template filters that invalidate the cached chain
+static const char *template_filter_signals[] = {
+	"update",
+	"enable",
+	"rename",
+};
+
+/* clang-format on */
+
+static void monitor_template_filters(struct source_defaults *src,
+				     struct source_snapshot *snapshot,
+				     bool monitor)
+{
+	if (!snapshot)
 		return;
-	if (src->sceneitem_options[COPY_VISIBILITY]) {
-		bool visible = obs_sceneitem_visible(src->src_sceneitem);
-		obs_sceneitem_set_visible(src->dst_sceneitem, visible);
-		obs_sceneitem_release(src->src_sceneitem);
-		obs_sceneitem_release(src->dst_sceneitem);
-		src->src_sceneitem = NULL;
-		src->dst_sceneitem = NULL;
+
+	for (size_t i = 0; i < snapshot->filters.num; i++) {
+		obs_source_t *filter = obs_weak_source_get_source(
+			snapshot->filters.array[i].weak);
+		if (!filter)
+			continue;
+
+		signal_handler_t *sh = obs_source_get_signal_handler(filter);
+		for (size_t j = 0; j < OBS_COUNTOF(template_filter_signals);
+		     j++) {
+			if (monitor)
+				signal_handler_connect(
+					sh, template_filter_signals[j],
+					parent_source_changed, src);
+			else
+				signal_handler_disconnect(
+					sh, template_filter_signals[j],
+					parent_source_changed, src);
+		}
+		obs_source_release(filter);
+	}
+}
+
+/**
+ * Whether the caller has to rebuild a snapshot, with snapshot_mutex locked
+ * if so. While one creation rebuilds, concurrent creations keep using the
+ * previous snapshot instead of waiting for it, unless there is none yet.
+ */
+static bool lock_for_rebuild(struct source_defaults *src, const void *snapshot,
+			     const volatile bool *dirty)
+{
+	if (snapshot && !os_atomic_load_bool(dirty))
+		return false;
+
+	if (!snapshot)
+		pthread_mutex_lock(&src->snapshot_mutex);
+	else if (pthread_mutex_trylock(&src->snapshot_mutex) != 0)
+		return false;
+	return true;
+}
+
+static struct source_snapshot *
+get_source_snapshot(struct source_defaults *src, obs_source_t *parent_source)
+{
+	long slot;
+	struct source_snapshot *snapshot =
+		rcu_ptr_read_begin(&src->source_snapshot, &slot);
+	source_snapshot_addref(snapshot);
+	rcu_ptr_read_end(&src->source_snapshot, slot);
+
+	if (!lock_for_rebuild(src, snapshot, &src->source_snapshot_dirty))
+		return snapshot;
+
+	// another creation may have rebuilt it in the meantime
+	struct source_snapshot *current =
+		rcu_ptr_current(&src->source_snapshot);
+	if (os_atomic_exchange_bool(&src->source_snapshot_dirty, false) ||
+	    !current) {
+		monitor_template_filters(src, current, false);
+		current = source_snapshot_create(parent_source);
+		monitor_template_filters(src, current, true);
+		source_snapshot_release(
+			rcu_ptr_publish(&src->source_snapshot, current));
+	}
+	source_snapshot_addref(current);
+	pthread_mutex_unlock(&src->snapshot_mutex);
+
+	source_snapshot_release(snapshot);
+	return current;
+}
+
+static struct sceneitem_snapshot *
+get_sceneitem_snapshot(struct source_defaults *src, obs_source_t *parent_source)
+{
+	long slot;
+	struct sceneitem_snapshot *snapshot =
+		rcu_ptr_read_begin(&src->sceneitem_snapshot, &slot);
+	sceneitem_snapshot_addref(snapshot);
+	rcu_ptr_read_end(&src->sceneitem_snapshot, slot);
+
+	if (!lock_for_rebuild(src, snapshot, &src->sceneitem_snapshot_dirty))
+		return snapshot;
+
+	struct sceneitem_snapshot *current =
+		rcu_ptr_current(&src->sceneitem_snapshot);
+	if (os_atomic_exchange_bool(&src->sceneitem_snapshot_dirty, false) ||
+	    !current) {
+		// the bottommost duplicate is used
+		obs_sceneitem_t *item =
+			src->parent_scene_index
+				? scene_index_find(src->parent_scene_index,
+						   parent_source)
+				: NULL;
+
+		current = sceneitem_snapshot_create(item);
+		if (item && os_atomic_load_bool(&src->template_hidden))
+			current->visible =
+				os_atomic_load_bool(&src->template_visible);
+		sceneitem_snapshot_release(
+			rcu_ptr_publish(&src->sceneitem_snapshot, current));
+		obs_sceneitem_release(item);
 	}
+	sceneitem_snapshot_addref(current);
+	pthread_mutex_unlock(&src->snapshot_mutex);
+
+	sceneitem_snapshot_release(snapshot);
+	return current;
+}
+
+static void parent_source_changed(void *data, calldata_t *cd)
+{
+	UNUSED_PARAMETER(cd);
+	struct source_defaults *src = data;
+	os_atomic_set_bool(&src->source_snapshot_dirty, true);
+}
+
+static void parent_sceneitem_changed(void *data, calldata_t *cd)
+{
+	UNUSED_PARAMETER(cd);
+	struct source_defaults *src = data;
+	os_atomic_set_bool(&src->sceneitem_snapshot_dirty, true);
+}
+
+/* clang-format off */
+
+// signals that invalidate the cached defaults
+static const char *parent_source_signals[] = {
+	"update",
+	"filter_add",
+	"filter_remove",
+	"reorder_filters",
+	"volume",
+	"mute",
+	"audio_sync",
+	"audio_mixers",
+	"audio_balance",
+};
+
+static const char *parent_scene_signals[] = {
+	"item_add",
+	"item_remove",
+	"reorder",
+	"refresh",
+	"item_transform",
+	"item_visible",
+};
+
+/* clang-format on */
+
+/* Called with registry.mutex locked */
+static void start_monitoring_parent_source(struct source_defaults *src,
+					   obs_source_t *source)
+{
+	signal_handler_t *sh = obs_source_get_signal_handler(source);
+	for (size_t i = 0; i < OBS_COUNTOF(parent_source_signals); i++)
+		signal_handler_connect(sh, parent_source_signals[i],
+				       parent_source_changed, src);
+	src->monitored_parent = source;
+	os_atomic_set_bool(&src->source_snapshot_dirty, true);
+}
+
+/**
+ * Uses the raw parent instead of the weak reference in the config: while
+ * the parent is destroyed it removes its filters, and still signals after
+ * the weak reference stopped resolving.
+ */
+static void stop_monitoring_parent_source(struct source_defaults *src)
+{
+	pthread_mutex_lock(&registry.mutex);
+	obs_source_t *source = src->monitored_parent;
+	src->monitored_parent = NULL;
+	pthread_mutex_unlock(&registry.mutex);
+	if (!source)
+		return;
+
+	signal_handler_t *sh = obs_source_get_signal_handler(source);
+	for (size_t i = 0; i < OBS_COUNTOF(parent_source_signals); i++)
+		signal_handler_disconnect(sh, parent_source_signals[i],
+					  parent_source_changed, src);
 }
 
 static void apply_sceneitem_defaults(void *data, obs_sceneitem_t *dst_sceneitem)
 {
 	struct source_defaults *src = data;
+	profile_start(apply_sceneitem_name);
+	struct defaults_config *config = config_get(src);
 	// First get the parent scene of the default source
 	obs_source_t *parent_scene_source =
-		obs_weak_source_get_source(src->parent_scene_weak);
+		obs_weak_source_get_source(config->parent_scene_weak);
 	obs_scene_t *parent_scene = obs_scene_from_source(parent_scene_source);
 	obs_source_t *parent_source =
-		obs_weak_source_get_source(src->parent_source_weak);
+		obs_weak_source_get_source(config->parent_source_weak);
 	const char *parent_source_name = obs_source_get_name(parent_source);
 	const char *dst_source_name =
 		obs_source_get_name(obs_sceneitem_get_source(dst_sceneitem));
 
-	struct sceneitem_find_data *parent_find_data =
-		bzalloc(sizeof(struct sceneitem_find_data));
+	struct sceneitem_snapshot *snapshot =
+		parent_scene ? get_sceneitem_snapshot(src, parent_source) : NULL;
 
 	if (parent_scene) {
-		parent_find_data->source_to_find = parent_source;
-		obs_scene_enum_items(parent_scene, find_source_sceneitem,
-				     parent_find_data);
-		if (parent_find_data->found_sceneitem) {
+		if (snapshot->item) {
+			uint64_t start = stage_begin(STATS_STAGE_SCENEITEM);
 			// Apply source defaults
-			if (src->sceneitem_options[COPY_TRANSFORM]) {
-				copy_transform(
-					parent_find_data->found_sceneitem,
-					dst_sceneitem);
+			if (config->sceneitem_options[COPY_TRANSFORM]) {
+				copy_transform(snapshot, dst_sceneitem);
 			}
-			if (src->sceneitem_options[COPY_VISIBILITY]) {
+			if (config->sceneitem_options[COPY_VISIBILITY]) {
 				// try to set it right away for less latency when possible
-				bool visible = obs_sceneitem_visible(
-					parent_find_data->found_sceneitem);
 				obs_sceneitem_set_visible(dst_sceneitem,
-							  visible);
-
-				obs_sceneitem_release(src->src_sceneitem);
-				obs_sceneitem_release(src->dst_sceneitem);
-				src->src_sceneitem =
-					parent_find_data->found_sceneitem;
-				src->dst_sceneitem = dst_sceneitem;
-				obs_sceneitem_addref(src->src_sceneitem);
-				obs_sceneitem_addref(src->dst_sceneitem);
-				obs_queue_task(OBS_TASK_GRAPHICS,
-					       deferred_sceneitem_defaults, src,
-					       false);
+							  snapshot->visible);
+
+				// a hidden template is not what is copied
+				bool hidden = os_atomic_load_bool(
+					&src->template_hidden);
+				queue_deferred_visibility(
+					hidden ? NULL : snapshot->item,
+					dst_sceneitem, snapshot->visible);
+				filter_stats_count(&src->stats,
+						   STATS_DEFERRED_VISIBILITY);
 			}
-			if (src->sceneitem_options[COPY_VISIBILITY_TRANSITIONS]) {
-				copy_visibility_transitions(
-					parent_find_data->found_sceneitem,
-					dst_sceneitem);
+			if (config->sceneitem_options[COPY_VISIBILITY_TRANSITIONS]) {
+				copy_visibility_transitions(src, config,
+							    snapshot->item,
+							    dst_sceneitem);
 			}
+			stage_end(&src->stats, STATS_STAGE_SCENEITEM, start);
 
-			log_changes(src, parent_source_name, dst_source_name,
-				    true);
+			log_changes(config, parent_source_name,
+				    dst_source_name, true);
 		} else {
 			blog(LOG_WARNING,
 			     "Selected parent scene '%s' does not contain '%s',"
 			     " scene item settings not copied.",
-			     src->parent_scene_name, parent_source_name);
+			     config->parent_scene_name, parent_source_name);
 		}
 	} else {
 		blog(LOG_WARNING,
 		     "Parent scene '%s' not found, scene item settings not copied.",
-		     src->parent_scene_name);
+		     config->parent_scene_name);
 	}
 
-	obs_sceneitem_release(parent_find_data->found_sceneitem);
-	bfree(parent_find_data);
+	sceneitem_snapshot_release(snapshot);
 	obs_source_release(parent_scene_source);
 	obs_source_release(parent_source);
+	config_release(config);
+	profile_end(apply_sceneitem_name);
+}
+
+/**
+ * Hidden scene items are neither activated nor rendered, even when their
+ * scene is previewed or nested, and sources without active audio are left
+ * out of the mixer. The Show/Hide state the template had is kept in the
+ * filter settings, so the snapshots still copy it. Nothing is touched
+ * unless the state changes, and turning the option off restores what the
+ * template had before.
+ */
+static void set_template_inactive(struct source_defaults *src,
+				  const struct defaults_config *config,
+				  obs_source_t *parent_source, bool inactive)
+{
+	if (!parent_source)
+		return;
+
+	// audio_active isn't saved with the source, so it is turned off once
+	// per session, also when the template was hidden before loading
+	if (inactive && !src->template_audio_off) {
+		src->template_audio_active =
+			obs_source_audio_active(parent_source);
+		src->template_audio_off = true;
+		obs_source_set_audio_active(parent_source, false);
+	} else if (!inactive && src->template_audio_off) {
+		src->template_audio_off = false;
+		obs_source_set_audio_active(parent_source,
+					    src->template_audio_active);
+	}
+	if (inactive == os_atomic_load_bool(&src->template_hidden))
+		return;
+
+	struct sceneitem_snapshot *snapshot =
+		config->parent_scene_weak
+			? get_sceneitem_snapshot(src, parent_source)
+			: NULL;
+	obs_sceneitem_t *item = snapshot ? snapshot->item : NULL;
+	obs_data_t *settings = obs_source_get_settings(src->source);
+	if (inactive) {
+		bool visible = item ? snapshot->visible : true;
+		obs_data_set_bool(settings, TEMPLATE_VISIBLE_KEY, visible);
+		os_atomic_set_bool(&src->template_visible, visible);
+		os_atomic_set_bool(&src->template_hidden, true);
+		if (item)
+			obs_sceneitem_set_visible(item, false);
+	} else {
+		bool visible = os_atomic_load_bool(&src->template_visible);
+		obs_data_erase(settings, TEMPLATE_VISIBLE_KEY);
+		os_atomic_set_bool(&src->template_hidden, false);
+		if (item)
+			obs_sceneitem_set_visible(item, visible);
+	}
+	os_atomic_set_bool(&src->sceneitem_snapshot_dirty, true);
+	blog(LOG_INFO, "%s default source '%s'",
+	     inactive ? "Deactivated" : "Reactivated",
+	     obs_source_get_name(parent_source));
+
+	obs_data_release(settings);
+	sceneitem_snapshot_release(snapshot);
+}
+
+/* Show/Hide transitions are not part of frozen defaults */
+static void apply_frozen_sceneitem(const struct frozen_profile *profile,
+				   obs_sceneitem_t *dst_sceneitem)
+{
+	const struct defaults_config *config = profile->config;
+	struct sceneitem_snapshot *snapshot =
+		profile->defaults->sceneitem_snapshot;
+	profile_start(apply_sceneitem_name);
+	uint64_t start = stage_begin(STATS_STAGE_SCENEITEM);
+	if (config->sceneitem_options[COPY_TRANSFORM])
+		copy_transform(snapshot, dst_sceneitem);
+	if (config->sceneitem_options[COPY_VISIBILITY]) {
+		obs_sceneitem_set_visible(dst_sceneitem, snapshot->visible);
+		queue_deferred_visibility(NULL, dst_sceneitem,
+					  snapshot->visible);
+		filter_stats_count(NULL, STATS_DEFERRED_VISIBILITY);
+	}
+	stage_end(NULL, STATS_STAGE_SCENEITEM, start);
+
+	log_changes(config, profile->defaults->name,
+		    obs_source_get_name(obs_sceneitem_get_source(dst_sceneitem)),
+		    true);
+	profile_end(apply_sceneitem_name);
+}
+
+/* The snapshot rebuilds use the index with snapshot_mutex locked */
+static void set_parent_scene_index(struct source_defaults *src,
+				   struct scene_index *index)
+{
+	pthread_mutex_lock(&src->snapshot_mutex);
+	struct scene_index *old_index = src->parent_scene_index;
+	src->parent_scene_index = index;
+	pthread_mutex_unlock(&src->snapshot_mutex);
+	scene_index_release(old_index);
+}
+
+/**
+ * The snapshot references the scene item of the default source, which
+ * references the source and so this filter. It is dropped together with the
+ * item, or the source and its filters could never be destroyed. NULL drops
+ * it whatever item it has.
+ */
+static void drop_sceneitem_snapshot(struct source_defaults *src,
+				    obs_sceneitem_t *item)
+{
+	struct sceneitem_snapshot *dropped = NULL;
+
+	pthread_mutex_lock(&src->snapshot_mutex);
+	struct sceneitem_snapshot *current =
+		rcu_ptr_current(&src->sceneitem_snapshot);
+	if (current && current->item && (!item || current->item == item))
+		dropped = rcu_ptr_publish(&src->sceneitem_snapshot, NULL);
+	pthread_mutex_unlock(&src->snapshot_mutex);
+
+	sceneitem_snapshot_release(dropped);
+}
+
+static void parent_sceneitem_removed(void *data, calldata_t *cd)
+{
+	struct source_defaults *src = data;
+	drop_sceneitem_snapshot(src, calldata_ptr(cd, "item"));
 }
 
 static void parent_scene_destroyed(void *data, calldata_t *cd)
 {
 	UNUSED_PARAMETER(cd);
 	struct source_defaults *src = data;
-	bfree(src->parent_scene_name);
-	src->parent_scene_name = bstrdup("");
-	obs_weak_source_release(src->parent_scene_weak);
-	src->parent_scene_weak = NULL;
+	struct defaults_config *config = config_edit_begin(src);
+	bfree(config->parent_scene_name);
+	config->parent_scene_name = bstrdup("");
+	obs_weak_source_release(config->parent_scene_weak);
+	config->parent_scene_weak = NULL;
+	config_edit_end(src, config);
+
+	set_parent_scene_index(src, NULL);
+	os_atomic_set_bool(&src->sceneitem_snapshot_dirty, true);
+	drop_sceneitem_snapshot(src, NULL);
 	obs_source_save(src->source);
 }
 
 static void parent_scene_renamed(void *data, calldata_t *cd)
 {
 	struct source_defaults *src = data;
-	bfree(src->parent_scene_name);
-	src->parent_scene_name = bstrdup(calldata_string(cd, "new_name"));
+	struct defaults_config *config = config_edit_begin(src);
+	bfree(config->parent_scene_name);
+	config->parent_scene_name = bstrdup(calldata_string(cd, "new_name"));
+	config_edit_end(src, config);
 	obs_source_save(src->source);
 }
 
@@ -393,6 +1190,13 @@ static void start_monitoring_parent_scene(struct source_defaults *src,
 	signal_handler_t *sh = obs_source_get_signal_handler(source);
 	signal_handler_connect(sh, "destroy", parent_scene_destroyed, src);
 	signal_handler_connect(sh, "rename", parent_scene_renamed, src);
+	signal_handler_connect(sh, "item_remove", parent_sceneitem_removed,
+			       src);
+	for (size_t i = 0; i < OBS_COUNTOF(parent_scene_signals); i++)
+		signal_handler_connect(sh, parent_scene_signals[i],
+				       parent_sceneitem_changed, src);
+	set_parent_scene_index(src, scene_index_acquire(scene));
+	os_atomic_set_bool(&src->sceneitem_snapshot_dirty, true);
 }
 
 static void stop_monitoring_parent_scene(struct source_defaults *src,
@@ -402,110 +1206,567 @@ static void stop_monitoring_parent_scene(struct source_defaults *src,
 	signal_handler_t *sh = obs_source_get_signal_handler(source);
 	signal_handler_disconnect(sh, "destroy", parent_scene_destroyed, src);
 	signal_handler_disconnect(sh, "rename", parent_scene_renamed, src);
+	signal_handler_disconnect(sh, "item_remove", parent_sceneitem_removed,
+				  src);
+	for (size_t i = 0; i < OBS_COUNTOF(parent_scene_signals); i++)
+		signal_handler_disconnect(sh, parent_scene_signals[i],
+					  parent_sceneitem_changed, src);
+	set_parent_scene_index(src, NULL);
 }
 
-static void scene_item_add_cb(void *data, calldata_t *cd)
+static void frozen_profile_addref(struct frozen_profile *profile)
 {
-	struct source_defaults *src = data;
-	obs_source_t *dst_source =
-		obs_weak_source_get_source(src->dst_source_weak);
-	if (!dst_source)
-		return;
-
-	//obs_scene_t *scene = calldata_ptr(cd, "scene");
-	obs_sceneitem_t *sceneitem = calldata_ptr(cd, "item");
-	obs_source_t *sceneitem_source = obs_sceneitem_get_source(sceneitem);
-
-	if (sceneitem_source == dst_source) {
-		obs_weak_source_release(src->dst_source_weak);
-		src->dst_source_weak = NULL;
-		apply_sceneitem_defaults(src, sceneitem);
-	}
-
-	obs_source_release(dst_source);
+	frozen_defaults_addref(profile->defaults);
+	os_atomic_inc_long(&profile->config->refs);
 }
 
-static bool all_scenes_item_add(void *data, obs_source_t *scene)
+static void frozen_profile_release(struct frozen_profile *profile)
 {
-	struct source_defaults *src = data;
-	signal_handler_t *sh = obs_source_get_signal_handler(scene);
-	signal_handler_connect(sh, "item_add", scene_item_add_cb, src);
-	return true;
+	frozen_defaults_release(profile->defaults);
+	config_release(profile->config);
 }
 
-static bool all_scenes_item_add_disconnect(void *data, obs_source_t *scene)
+static void free_pending_dst(struct pending_dst *pending)
 {
-	struct source_defaults *src = data;
-	signal_handler_t *sh = obs_source_get_signal_handler(scene);
-	signal_handler_disconnect(sh, "item_add", scene_item_add_cb, src);
-	return true;
+	obs_weak_source_release(pending->dst_weak);
+	if (pending->frozen.defaults)
+		frozen_profile_release(&pending->frozen);
+	bfree(pending);
 }
 
-static void source_defaults_frontend_event_cb(enum obs_frontend_event event,
-					      void *data)
+static void hub_evict_oldest_locked(void)
 {
-	struct source_defaults *src = data;
-	if (event == OBS_FRONTEND_EVENT_FINISHED_LOADING ||
-	    event == OBS_FRONTEND_EVENT_SCENE_COLLECTION_CHANGED) {
-		obs_enum_scenes(all_scenes_item_add, src);
-
-		// set default scene after all sources are loaded
-		obs_scene_t *parent_scene =
-			obs_get_scene_by_name(src->parent_scene_name);
-		obs_weak_source_release(src->parent_scene_weak);
-		if (parent_scene) {
-			src->parent_scene_weak = obs_source_get_weak_source(
-				obs_scene_get_source(parent_scene));
-			obs_scene_release(parent_scene);
-			start_monitoring_parent_scene(src, parent_scene);
+	size_t idx = 0;
+	const void *key;
+	const void *oldest_key = NULL;
+	struct pending_dst *pending;
+	struct pending_dst *oldest = NULL;
+	while (hash_table_next(&hub.pending, &idx, &key, (void **)&pending)) {
+		if (!oldest || pending->expires_ns < oldest->expires_ns) {
+			oldest = pending;
+			oldest_key = key;
 		}
-
-		obs_frontend_remove_event_callback(
-			source_defaults_frontend_event_cb, src);
+	}
+	if (oldest) {
+		hash_table_remove(&hub.pending, oldest_key);
+		free_pending_dst(oldest);
 	}
 }
 
-static void source_created_cb(void *data, calldata_t *cd)
+/* Called with hub.mutex locked whenever the pending table changed */
+static void hub_count_changed_locked(void)
 {
-	if (!loaded) {
-		return;
-	}
-	struct source_defaults *src = data;
-	obs_source_t *dst = (obs_source_t *)calldata_ptr(cd, "source");
-	if (obs_source_get_type(dst) == OBS_SOURCE_TYPE_SCENE) {
-		signal_handler_t *sh = obs_source_get_signal_handler(dst);
-		signal_handler_connect(sh, "item_add", scene_item_add_cb, src);
-		return;
+	size_t count = hash_table_count(&hub.pending);
+	os_atomic_set_long(&hub.count, (long)count);
+	// from now on the scenes disconnect themselves
+	if (!count)
+		hub.armed = false;
+}
+
+static bool hub_connect_scene(void *data, obs_source_t *scene);
+
+/* Either src or frozen is set */
+static void hub_set_pending(struct source_defaults *src,
+			    struct frozen_profile *frozen, obs_source_t *dst)
+{
+	struct pending_dst *pending = bzalloc(sizeof(struct pending_dst));
+	pending->dst_weak = obs_source_get_weak_source(dst);
+	pending->src = src;
+	if (frozen) {
+		pending->frozen = *frozen;
+		frozen_profile_addref(&pending->frozen);
 	}
-	bool already_encountered = false;
+	pending->expires_ns = os_gettime_ns() + PENDING_TIMEOUT_NS;
 
-	obs_source_t *parent_source = obs_filter_get_parent(src->source);
-	obs_weak_source_release(src->parent_source_weak);
-	src->parent_source_weak = obs_source_get_weak_source(parent_source);
-	if (!parent_source) {
+	pthread_mutex_lock(&hub.mutex);
+	struct pending_dst *old = hash_table_set(&hub.pending, dst, pending);
+	if (old) {
+		free_pending_dst(old);
+	} else if (hash_table_count(&hub.pending) > MAX_PENDING) {
 		blog(LOG_WARNING,
-		     "Filter has no parent source, so new source was skipped.");
+		     "Too many sources wait for their scene item,"
+		     " dropping the oldest one.");
+		hub_evict_oldest_locked();
+	}
+	hub_count_changed_locked();
+	// while another connect runs, some scenes may not be connected yet
+	bool arm = !hub.armed || hub.arming;
+	if (arm) {
+		hub.armed = true;
+		hub.arming++;
+	}
+	pthread_mutex_unlock(&hub.mutex);
+
+	if (arm) {
+		obs_enum_scenes(hub_connect_scene, NULL);
+		pthread_mutex_lock(&hub.mutex);
+		hub.arming--;
+		pthread_mutex_unlock(&hub.mutex);
+	}
+}
+
+static void hub_remove_pending(struct source_defaults *src)
+{
+	pthread_mutex_lock(&hub.mutex);
+	size_t idx = 0;
+	const void *key;
+	struct pending_dst *pending;
+	while (hash_table_next(&hub.pending, &idx, &key, (void **)&pending)) {
+		if (pending->src && pending->src == src) {
+			hash_table_remove(&hub.pending, key);
+			free_pending_dst(pending);
+		}
+	}
+	hub_count_changed_locked();
+	pthread_mutex_unlock(&hub.mutex);
+}
+
+static void handle_scene_item_add(obs_sceneitem_t *sceneitem)
+{
+	uint64_t start = os_gettime_ns();
+	obs_source_t *sceneitem_source = obs_sceneitem_get_source(sceneitem);
+	obs_source_t *filter = NULL;
+	struct frozen_profile frozen = {0};
+
+	pthread_mutex_lock(&hub.mutex);
+	struct pending_dst *pending =
+		hash_table_remove(&hub.pending, sceneitem_source);
+	if (pending) {
+		// the key may belong to a destroyed source at the same address
+		obs_source_t *dst_source =
+			obs_weak_source_get_source(pending->dst_weak);
+		if (dst_source == sceneitem_source && pending->src) {
+			filter = obs_source_get_ref(pending->src->source);
+		} else if (dst_source == sceneitem_source) {
+			// taken over from the pending entry
+			frozen = pending->frozen;
+			pending->frozen = (struct frozen_profile){0};
+		}
+		obs_source_release(dst_source);
+		free_pending_dst(pending);
+		hub_count_changed_locked();
+	}
+	pthread_mutex_unlock(&hub.mutex);
+
+	if (filter) {
+		profile_start(scene_item_add_name);
+		apply_sceneitem_defaults(obs_obj_get_data(filter), sceneitem);
+		obs_source_release(filter);
+		profile_end(scene_item_add_name);
+		latency_stats_record(&item_add_latency,
+				     os_gettime_ns() - start);
+	} else if (frozen.defaults) {
+		apply_frozen_sceneitem(&frozen, sceneitem);
+		frozen_profile_release(&frozen);
+		latency_stats_record(&item_add_latency,
+				     os_gettime_ns() - start);
+	}
+}
+
+static bool hub_disconnect_scene(void *data, obs_source_t *scene);
+
+static void scene_item_add_cb(void *data, calldata_t *cd)
+{
+	UNUSED_PARAMETER(data);
+	bool pending = os_atomic_load_long(&hub.count) > 0;
+	obs_sceneitem_t *sceneitem = calldata_ptr(cd, "item");
+	if (!event_trace_enabled()) {
+		if (pending) {
+			handle_scene_item_add(sceneitem);
+		} else {
+			obs_scene_t *scene = calldata_ptr(cd, "scene");
+			hub_disconnect_scene(NULL, obs_scene_get_source(scene));
+		}
+		return;
+	}
+
+	// also the items without defaults, a replay has to add them too
+	uint64_t start = os_gettime_ns();
+	if (pending)
+		handle_scene_item_add(sceneitem);
+	event_trace_record(
+		TRACE_ITEM_ADD, obs_sceneitem_get_source(sceneitem),
+		obs_scene_get_source(obs_sceneitem_get_scene(sceneitem)),
+		start);
+}
+
+static bool hub_connect_scene(void *data, obs_source_t *scene)
+{
+	UNUSED_PARAMETER(data);
+	signal_handler_t *sh = obs_source_get_signal_handler(scene);
+	signal_handler_connect(sh, "item_add", scene_item_add_cb, NULL);
+	return true;
+}
+
+static bool hub_disconnect_scene(void *data, obs_source_t *scene)
+{
+	UNUSED_PARAMETER(data);
+	signal_handler_t *sh = obs_source_get_signal_handler(scene);
+	signal_handler_disconnect(sh, "item_add", scene_item_add_cb, NULL);
+	return true;
+}
+
+/* UI thread, drops sources that never got their scene item */
+static void hub_sweep(void *param)
+{
+	UNUSED_PARAMETER(param);
+	uint64_t now = os_gettime_ns();
+
+	pthread_mutex_lock(&hub.mutex);
+	size_t idx = 0;
+	const void *key;
+	struct pending_dst *pending;
+	while (hash_table_next(&hub.pending, &idx, &key, (void **)&pending)) {
+		if (now < pending->expires_ns)
+			continue;
+
+		hash_table_remove(&hub.pending, key);
+		free_pending_dst(pending);
+	}
+	hub_count_changed_locked();
+	pthread_mutex_unlock(&hub.mutex);
+
+	os_atomic_set_bool(&hub.sweep_queued, false);
+}
+
+static void hub_tick(void *param, float seconds)
+{
+	UNUSED_PARAMETER(param);
+	if (!os_atomic_load_long(&hub.count))
 		return;
-	} else if (obs_source_get_output_flags(parent_source) &
-		   OBS_SOURCE_COMPOSITE) {
-		signal_handler_t *sh = obs_get_signal_handler();
-		signal_handler_disconnect(sh, "source_create",
-					  source_created_cb, src);
-		sh = obs_source_get_signal_handler(src->source);
-		signal_handler_disconnect(sh, "enable", source_defaults_enable,
-					  src);
-		obs_enum_scenes(all_scenes_item_add_disconnect, src);
+
+	hub.since_sweep += seconds;
+	if (hub.since_sweep < HUB_SWEEP_INTERVAL)
 		return;
+	hub.since_sweep = 0.0f;
+
+	if (!os_atomic_exchange_bool(&hub.sweep_queued, true))
+		obs_queue_task(OBS_TASK_UI, hub_sweep, NULL, false);
+}
+
+static void resolve_parent_scene(struct source_defaults *src,
+				 obs_source_t *scene_source)
+{
+	struct defaults_config *config = config_edit_begin(src);
+	obs_weak_source_release(config->parent_scene_weak);
+	config->parent_scene_weak = obs_source_get_weak_source(scene_source);
+	config_edit_end(src, config);
+
+	if (scene_source)
+		start_monitoring_parent_scene(
+			src, obs_scene_from_source(scene_source));
+}
+
+static struct defaults_type_entry *get_type_entry(const char *type)
+{
+	struct defaults_type_entry *entry =
+		hash_table_get(&registry.types, type);
+	if (!entry) {
+		entry = bzalloc(sizeof(struct defaults_type_entry));
+		entry->type = bstrdup(type);
+		hash_table_set(&registry.types, entry->type, entry);
 	}
+	return entry;
+}
 
-	// should be same type
-	if (strcmp(obs_source_get_id(parent_source), obs_source_get_id(dst)) !=
-	    0) {
+static void type_view_release(struct type_view *view)
+{
+	if (!view || os_atomic_dec_long(&view->refs) > 0)
 		return;
+
+	for (size_t i = 0; i < view->filters.num; i++) {
+		obs_weak_source_release(view->filters.array[i].filter_weak);
+		bfree(view->filters.array[i].parent_id);
 	}
-	if (obs_source_get_type(dst) != OBS_SOURCE_TYPE_INPUT) {
+	for (size_t i = 0; i < view->frozen.num; i++)
+		frozen_profile_release(&view->frozen.array[i]);
+	da_free(view->filters);
+	da_free(view->frozen);
+	rule_matcher_destroy(view->matcher);
+	rule_matcher_destroy(view->frozen_matcher);
+	bfree(view->type);
+	bfree(view);
+}
+
+static struct type_view *type_view_create(struct defaults_type_entry *entry)
+{
+	struct type_view *view = bzalloc(sizeof(struct type_view));
+	view->refs = 1;
+	view->type = bstrdup(entry->type);
+
+	DARRAY(struct defaults_config *) configs;
+	DARRAY(const struct profile_rules *) rules;
+	da_init(configs);
+	da_init(rules);
+
+	bool any_rules = false;
+	for (size_t i = 0; i < entry->filters.num; i++) {
+		struct source_defaults *src = entry->filters.array[i];
+		struct type_view_filter filter = {
+			.filter_weak = obs_source_get_weak_source(src->source),
+			.parent_id = bstrdup(src->parent_id),
+		};
+		da_push_back(view->filters, &filter);
+
+		struct defaults_config *config = config_get(src);
+		const struct profile_rules *profile = &config->rules;
+		any_rules = any_rules || profile_rules_specificity(profile);
+		da_push_back(configs, &config);
+		da_push_back(rules, &profile);
+	}
+	if (any_rules)
+		view->matcher = rule_matcher_create(rules.array, rules.num);
+
+	da_resize(rules, 0);
+	any_rules = false;
+	for (size_t i = 0; i < entry->frozen.num; i++) {
+		struct frozen_profile frozen = entry->frozen.array[i];
+		frozen_profile_addref(&frozen);
+		da_push_back(view->frozen, &frozen);
+
+		const struct profile_rules *profile = &frozen.config->rules;
+		any_rules = any_rules || profile_rules_specificity(profile);
+		da_push_back(rules, &profile);
+	}
+	if (any_rules)
+		view->frozen_matcher =
+			rule_matcher_create(rules.array, rules.num);
+
+	for (size_t i = 0; i < configs.num; i++)
+		config_release(configs.array[i]);
+	da_free(configs);
+	da_free(rules);
+	return view;
+}
+
+static void registry_view_release(struct registry_view *view)
+{
+	if (!view || os_atomic_dec_long(&view->refs) > 0)
 		return;
+
+	size_t idx = 0;
+	struct type_view *type;
+	while (hash_table_next(&view->types, &idx, NULL, (void **)&type))
+		type_view_release(type);
+	hash_table_free(&view->types);
+	bfree(view);
+}
+
+static struct registry_view *registry_view_get(void)
+{
+	long slot;
+	struct registry_view *view = rcu_ptr_read_begin(&registry.view, &slot);
+	os_atomic_inc_long(&view->refs);
+	rcu_ptr_read_end(&registry.view, slot);
+	return view;
+}
+
+/**
+ * Called with registry.mutex locked after the entries changed. Only the
+ * table is new, the type views of the entries are shared.
+ */
+static void registry_publish_locked(void)
+{
+	struct registry_view *view = bzalloc(sizeof(struct registry_view));
+	view->refs = 1;
+	hash_table_init(&view->types, hash_table_hash_str,
+			hash_table_equal_str);
+
+	size_t idx = 0;
+	struct defaults_type_entry *entry;
+	while (hash_table_next(&registry.types, &idx, NULL, (void **)&entry)) {
+		os_atomic_inc_long(&entry->view->refs);
+		hash_table_set(&view->types, entry->view->type, entry->view);
+	}
+	registry_view_release(rcu_ptr_publish(&registry.view, view));
+}
+
+static void clear_frozen_profiles(struct defaults_type_entry *entry)
+{
+	for (size_t i = 0; i < entry->frozen.num; i++)
+		frozen_profile_release(&entry->frozen.array[i]);
+	da_resize(entry->frozen, 0);
+}
+
+static void free_type_entry(struct defaults_type_entry *entry)
+{
+	clear_frozen_profiles(entry);
+	da_free(entry->frozen);
+	type_view_release(entry->view);
+	da_free(entry->filters);
+	bfree(entry->type);
+	bfree(entry);
+}
+
+/**
+ * Called with registry.mutex locked whenever the filters, their rules or
+ * the frozen profiles change, registry_publish_locked() has to follow.
+ */
+static void compile_type_entry(struct defaults_type_entry *entry)
+{
+	type_view_release(entry->view);
+	entry->view = type_view_create(entry);
+}
+
+/* The parent of a filter is only known after it has been added to a source,
+   so the type of newly enabled filters is looked up lazily. */
+static void registry_resolve_locked(void)
+{
+	bool resolved = false;
+	for (size_t i = registry.unresolved.num; i > 0; i--) {
+		struct source_defaults *src = registry.unresolved.array[i - 1];
+		obs_source_t *parent_source = obs_filter_get_parent(src->source);
+		if (!parent_source)
+			continue;
+
+		da_erase(registry.unresolved, i - 1);
+		config_set_parent_source(src, parent_source);
+		resolved = true;
+
+		if (obs_source_get_output_flags(parent_source) &
+		    OBS_SOURCE_COMPOSITE) {
+			src->composite_parent = true;
+			src->registered = false;
+			continue;
+		}
+		start_monitoring_parent_source(src, parent_source);
+
+		bfree(src->parent_type);
+		bfree(src->parent_id);
+		src->parent_type =
+			bstrdup(obs_source_get_unversioned_id(parent_source));
+		src->parent_id = bstrdup(obs_source_get_id(parent_source));
+
+		struct defaults_type_entry *entry =
+			get_type_entry(src->parent_type);
+		da_push_back(entry->filters, &src);
+		compile_type_entry(entry);
+	}
+	os_atomic_set_bool(&registry.has_unresolved,
+			   registry.unresolved.num != 0);
+	if (resolved)
+		registry_publish_locked();
+}
+
+static void registry_add(struct source_defaults *src)
+{
+	pthread_mutex_lock(&registry.mutex);
+	if (!src->registered && !src->composite_parent) {
+		src->registered = true;
+		da_push_back(registry.unresolved, &src);
+		os_atomic_set_bool(&registry.has_unresolved, true);
+	}
+	pthread_mutex_unlock(&registry.mutex);
+}
+
+static void registry_remove(struct source_defaults *src)
+{
+	pthread_mutex_lock(&registry.mutex);
+	if (src->registered) {
+		src->registered = false;
+		da_erase_item(registry.unresolved, &src);
+		os_atomic_set_bool(&registry.has_unresolved,
+				   registry.unresolved.num != 0);
+
+		struct defaults_type_entry *entry =
+			src->parent_type
+				? hash_table_get(&registry.types,
+						 src->parent_type)
+				: NULL;
+		if (entry) {
+			da_erase_item(entry->filters, &src);
+			if (!entry->filters.num && !entry->frozen.num) {
+				hash_table_remove(&registry.types, entry->type);
+				free_type_entry(entry);
+			} else {
+				compile_type_entry(entry);
+			}
+			registry_publish_locked();
+		}
+	}
+	pthread_mutex_unlock(&registry.mutex);
+}
+
+static void registry_rules_changed(struct source_defaults *src)
+{
+	pthread_mutex_lock(&registry.mutex);
+	struct defaults_type_entry *entry =
+		src->registered && src->parent_type
+			? hash_table_get(&registry.types, src->parent_type)
+			: NULL;
+	if (entry) {
+		compile_type_entry(entry);
+		registry_publish_locked();
+	}
+	pthread_mutex_unlock(&registry.mutex);
+}
+
+static void config_parse(struct defaults_config *config,
+			 obs_data_t *settings);
+
+static bool add_frozen_profile(void *param, struct frozen_defaults *frozen)
+{
+	UNUSED_PARAMETER(param);
+	struct frozen_profile profile = {
+		.defaults = frozen,
+		.config = bzalloc(sizeof(struct defaults_config)),
+	};
+	frozen_defaults_addref(frozen);
+	profile.config->refs = 1;
+
+	// only the user values were saved
+	obs_data_t *settings = obs_data_create();
+	source_defaults_get_defaults(settings);
+	obs_data_apply(settings, frozen->filter_settings);
+	config_parse(profile.config, settings);
+	obs_data_release(settings);
+	profile.config->sceneitem_options[COPY_VISIBILITY_TRANSITIONS] = false;
+
+	struct defaults_type_entry *entry = get_type_entry(frozen->type);
+	da_push_back(entry->frozen, &profile);
+	return true;
+}
+
+/* Rebuilds the frozen profiles of all types from the store */
+static void frozen_defaults_changed(void)
+{
+	pthread_mutex_lock(&registry.mutex);
+	size_t idx = 0;
+	struct defaults_type_entry *entry;
+	while (hash_table_next(&registry.types, &idx, NULL, (void **)&entry))
+		clear_frozen_profiles(entry);
+
+	frozen_store_enum(add_frozen_profile, NULL);
+
+	idx = 0;
+	while (hash_table_next(&registry.types, &idx, NULL, (void **)&entry)) {
+		if (entry->frozen.num || entry->filters.num) {
+			compile_type_entry(entry);
+		} else {
+			hash_table_remove(&registry.types, entry->type);
+			free_type_entry(entry);
+		}
 	}
+	registry_publish_locked();
+	pthread_mutex_unlock(&registry.mutex);
+}
+
+/* Filters on scenes and groups are never registered again */
+static void source_defaults_detach(struct source_defaults *src)
+{
+	registry_remove(src);
+	pthread_mutex_lock(&registry.mutex);
+	src->composite_parent = true;
+	pthread_mutex_unlock(&registry.mutex);
+
+	signal_handler_t *sh = obs_source_get_signal_handler(src->source);
+	signal_handler_disconnect(sh, "enable", source_defaults_enable, src);
+	hub_remove_pending(src);
+}
+
+static bool source_is_new(obs_source_t *dst)
+{
+	bool already_encountered = false;
 
 	/* We have to distinguish between new sources and 
 	   sources that are only recreated due to undo, 
@@ -516,151 +1777,647 @@ static void source_created_cb(void *data, calldata_t *cd)
 	   and then undo it, it will be considered a new source.
 	   */
 	obs_data_t *dst_properties = obs_source_get_settings(dst);
+#ifndef NDEBUG
 	blog(LOG_DEBUG, "dst json: %s", obs_data_get_json(dst_properties));
+#endif // !NDEBUG
 	already_encountered =
-		obs_data_get_bool(dst_properties, ENCOUNTERED_KEY);
+		encountered_sources_contains(dst, dst_properties);
 	if (!already_encountered) {
-		const char *dst_properties_json =
-			obs_data_get_json(dst_properties);
 		const char *dst_id = obs_source_get_unversioned_id(dst);
 
 		// Except media sources because drag-and-drop already
 		// sets properties before the signal is propagated
-		if (strcmp(dst_id, "ffmpeg_source") != 0 || strcmp(dst_id, "image_source") != 0) {
-			already_encountered =
-				strcmp(dst_properties_json, "{}") != 0;
-		}
-		// If the new source has non-default settings (not "{}")
-		// consider it already encountered, but still write the
-		// ENCOUNTERED_KEY, so that if the user resets its properties
-		// to default, next callback execution will see it as already encountered.
-		if (already_encountered || !src->options[COPY_PROPERTIES]) {
-			obs_data_set_bool(dst_properties, ENCOUNTERED_KEY,
-					  true);
-			obs_source_update(dst, dst_properties);
+		if (strcmp(dst_id, "ffmpeg_source") != 0 &&
+		    strcmp(dst_id, "image_source") != 0) {
+			already_encountered = has_user_values(dst_properties);
 		}
+		// If the new source has non-default settings (user set values)
+		// consider it already encountered. It is still added to the
+		// encountered sources, so that if the user resets its
+		// properties to default, it is still recognized next time.
 	}
 	obs_data_release(dst_properties);
+	return !already_encountered;
+}
 
-	if (already_encountered)
-		return;
+/* Shared by the filters and frozen defaults, stats can be NULL */
+static void apply_snapshot(struct filter_stats *stats,
+			   const struct defaults_config *config,
+			   struct source_snapshot *snapshot,
+			   enum obs_monitoring_type monitoring,
+			   obs_source_t *dst)
+{
+	uint64_t start;
 
-	if (src->options[COPY_PROPERTIES]) {
-		obs_data_t *settings = obs_source_get_settings(parent_source);
-		if (!already_encountered) {
-			obs_data_set_bool(dst_properties, ENCOUNTERED_KEY,
-					  true);
-		}
-		obs_source_update(dst, settings);
-		obs_data_release(settings);
+	if (config->options[COPY_PROPERTIES]) {
+		start = stage_begin(STATS_STAGE_PROPERTIES);
+		copy_properties(snapshot, dst);
+		stage_end(stats, STATS_STAGE_PROPERTIES, start);
 
 #ifndef NDEBUG
-		dst_properties = obs_source_get_settings(dst);
+		obs_data_t *dst_properties = obs_source_get_settings(dst);
 		blog(LOG_DEBUG, "dst json2: %s",
 		     obs_data_get_json(dst_properties));
 		obs_data_release(dst_properties);
 #endif // !NDEBUG
 	}
-	if (src->options[COPY_FILTERS]) {
-		obs_source_enum_filters(parent_source, enum_filters, dst);
-	}
-	if (src->options[COPY_AUDIO_MONITORING]) {
-		enum obs_monitoring_type monitoring =
-			obs_source_get_monitoring_type(parent_source);
-		obs_source_set_monitoring_type(dst, monitoring);
-	}
-	if (src->options[COPY_VOLUME]) {
-		float volume = obs_source_get_volume(parent_source);
-		obs_source_set_volume(dst, volume);
-	}
-	if (src->options[COPY_MUTED]) {
-		bool muted = obs_source_muted(parent_source);
-		obs_source_set_muted(dst, muted);
-	}
-	if (src->options[COPY_BALANCE]) {
-		float balance = obs_source_get_balance_value(parent_source);
-		obs_source_set_balance_value(dst, balance);
-	}
-	if (src->options[COPY_SYNC_OFFSET]) {
-		int64_t sync_offset = obs_source_get_sync_offset(parent_source);
-		obs_source_set_sync_offset(dst, sync_offset);
-	}
-	if (src->options[COPY_AUDIO_TRACKS]) {
-		uint32_t tracks = obs_source_get_audio_mixers(parent_source);
-		obs_source_set_audio_mixers(dst, tracks);
+	encountered_sources_add(dst);
+	if (config->options[COPY_FILTERS]) {
+		start = stage_begin(STATS_STAGE_FILTERS);
+		copy_filters(config, snapshot, dst);
+		stage_end(stats, STATS_STAGE_FILTERS, start);
 	}
-	if (any_true(src->sceneitem_options,
-		     OBS_COUNTOF(src->sceneitem_options))) {
-		obs_weak_source_release(src->dst_source_weak);
-		src->dst_source_weak = obs_source_get_weak_source(dst);
-	}
-	if (src->apply_name_settings && strcmp(src->prefix, "") != 0) {
+	start = stage_begin(STATS_STAGE_AUDIO);
+	copy_audio(config, snapshot, monitoring, dst);
+	stage_end(stats, STATS_STAGE_AUDIO, start);
+	if (config->apply_name_settings && strcmp(config->prefix, "") != 0) {
+		start = stage_begin(STATS_STAGE_RENAME);
 		struct dstr new_name = {0};
 		bool should_apply = true;
 		dstr_copy(&new_name, obs_source_get_name(dst));
-		if (src->prefix_if_not_yet_applied) {
-			const char *found = dstr_find(&new_name, src->prefix);
+		if (config->prefix_if_not_yet_applied) {
+			const char *found =
+				dstr_find(&new_name, config->prefix);
 			should_apply = !found || (found - new_name.array != 0);
 		}
 		if (should_apply) {
-			dstr_insert(&new_name, 0, src->prefix);
+			dstr_insert(&new_name, 0, config->prefix);
 			obs_source_set_name(dst, new_name.array);
 		}
 		dstr_free(&new_name);
+		stage_end(stats, STATS_STAGE_RENAME, start);
 	}
-	log_changes(src, obs_source_get_name(dst), obs_source_get_name(dst),
+	filter_stats_count(stats, STATS_APPLIED);
+	log_changes(config, obs_source_get_name(dst), obs_source_get_name(dst),
 		    false);
 }
 
-static void source_defaults_update(void *data, obs_data_t *settings)
+static void source_defaults_apply(struct source_defaults *src,
+				  const struct defaults_config *config,
+				  obs_source_t *dst)
+{
+	obs_source_t *parent_source =
+		obs_weak_source_get_source(config->parent_source_weak);
+	if (!parent_source) {
+		blog(LOG_WARNING,
+		     "Filter has no parent source, so new source was skipped.");
+		return;
+	}
+
+	profile_start(apply_name);
+	struct source_snapshot *snapshot =
+		get_source_snapshot(src, parent_source);
+	apply_snapshot(&src->stats, config, snapshot,
+		       obs_source_get_monitoring_type(parent_source), dst);
+	source_snapshot_release(snapshot);
+	obs_source_release(parent_source);
+	profile_end(apply_name);
+}
+
+static void frozen_defaults_apply(const struct frozen_profile *profile,
+				  obs_source_t *dst)
+{
+	profile_start(apply_name);
+	apply_snapshot(NULL, profile->config, profile->defaults->snapshot,
+		       profile->defaults->monitoring, dst);
+	profile_end(apply_name);
+}
+
+/* Whichever a queued source was matched with, a filter or frozen defaults */
+struct queued_profile {
+	obs_source_t *filter;
+	struct frozen_profile frozen;
+};
+
+static void queue_profile(obs_source_t *filter, struct frozen_profile *frozen,
+			  obs_source_t *dst)
+{
+	struct queued_profile *queued = bzalloc(sizeof(struct queued_profile));
+	if (frozen) {
+		queued->frozen = *frozen;
+		frozen_profile_addref(&queued->frozen);
+	} else {
+		queued->filter = obs_source_get_ref(filter);
+		if (!queued->filter) {
+			bfree(queued);
+			return;
+		}
+	}
+	apply_queue_push(queued, dst);
+}
+
+static void apply_queued(void *profile, obs_source_t *dst)
+{
+	struct queued_profile *queued = profile;
+	if (!queued->filter) {
+		frozen_defaults_apply(&queued->frozen, dst);
+		return;
+	}
+
+	struct source_defaults *src = obs_obj_get_data(queued->filter);
+	struct defaults_config *config = config_get(src);
+	source_defaults_apply(src, config, dst);
+	config_release(config);
+}
+
+static void release_queued(void *profile)
+{
+	struct queued_profile *queued = profile;
+	obs_source_release(queued->filter);
+	if (queued->frozen.defaults)
+		frozen_profile_release(&queued->frozen);
+	bfree(queued);
+}
+
+// longer extensions can't be part of a rule anyway
+#define MAX_EXTENSION 32
+
+/**
+ * Index of the profile in entry->filters that the rules pick, or -1. A scene
+ * rule is checked against the scene passed in, which may be NULL.
+ */
+static long match_profile(const struct rule_matcher *matcher,
+			  obs_source_t *dst, const char *scene)
+{
+	char extension[MAX_EXTENSION];
+	struct rule_subject subject = {
+		.name = obs_source_get_name(dst),
+		.scene = scene,
+		.has_audio = (obs_source_get_output_flags(dst) &
+			      OBS_SOURCE_AUDIO) != 0,
+	};
+	if (rule_matcher_uses_extension(matcher)) {
+		// media and image sources respectively
+		obs_data_t *settings = obs_source_get_settings(dst);
+		const char *path = obs_data_get_string(settings, "local_file");
+		if (!*path)
+			path = obs_data_get_string(settings, "file");
+		if (rule_file_extension(path, extension, sizeof(extension)))
+			subject.extension = extension;
+		obs_data_release(settings);
+	}
+
+	return rule_matcher_match(matcher, &subject);
+}
+
+/* New sources are matched against the scene they are added to */
+static long match_new_source(const struct rule_matcher *matcher,
+			     obs_source_t *dst)
+{
+	long slot;
+	const char *scene = rcu_ptr_read_begin(&target_scene, &slot);
+	long idx = match_profile(matcher, dst, scene);
+	rcu_ptr_read_end(&target_scene, slot);
+	return idx;
+}
+
+/* A matching profile replaces the filters without rules */
+static bool profile_selected(const struct rule_matcher *matcher,
+			     long profile, size_t idx)
+{
+	if (profile >= 0)
+		return (size_t)profile == idx;
+	return !matcher || !rule_matcher_has_rules(matcher, idx);
+}
+
+static void handle_source_created(obs_source_t *dst)
+{
+	// also scenes of a collection that is loading, for later creations
+	enum obs_source_type type = obs_source_get_type(dst);
+	if (type == OBS_SOURCE_TYPE_SCENE) {
+		pthread_mutex_lock(&hub.mutex);
+		bool armed = hub.armed;
+		pthread_mutex_unlock(&hub.mutex);
+		// before obs_scene_create() returns, so no item is missed
+		if (armed || event_trace_enabled())
+			hub_connect_scene(NULL, dst);
+		return;
+	}
+	if (!loaded || type != OBS_SOURCE_TYPE_INPUT) {
+		return;
+	}
+
+	uint64_t start = os_gettime_ns();
+	DARRAY(obs_source_t *) matched;
+	DARRAY(struct frozen_profile) matched_frozen;
+	da_init(matched);
+	da_init(matched_frozen);
+
+	if (os_atomic_load_bool(&registry.has_unresolved)) {
+		pthread_mutex_lock(&registry.mutex);
+		registry_resolve_locked();
+		pthread_mutex_unlock(&registry.mutex);
+	}
+
+	struct registry_view *view = registry_view_get();
+	struct type_view *entry = hash_table_get(
+		&view->types, obs_source_get_unversioned_id(dst));
+	if (entry) {
+		long profile = entry->matcher
+				       ? match_new_source(entry->matcher, dst)
+				       : -1;
+		// should be same type
+		const char *dst_id = obs_source_get_id(dst);
+		for (size_t i = 0; i < entry->filters.num; i++) {
+			struct type_view_filter *src = &entry->filters.array[i];
+			if (!profile_selected(entry->matcher, profile, i) ||
+			    strcmp(src->parent_id, dst_id) != 0)
+				continue;
+
+			// NULL once the filter is being destroyed
+			obs_source_t *filter =
+				obs_weak_source_get_source(src->filter_weak);
+			if (filter)
+				da_push_back(matched, &filter);
+		}
+	}
+	if (entry && !matched.num && entry->frozen.num) {
+		long profile = entry->frozen_matcher
+				       ? match_new_source(entry->frozen_matcher,
+							  dst)
+				       : -1;
+		const char *dst_id = obs_source_get_id(dst);
+		for (size_t i = 0; i < entry->frozen.num; i++) {
+			struct frozen_profile *frozen = &entry->frozen.array[i];
+			if (!profile_selected(entry->frozen_matcher, profile,
+					      i) ||
+			    strcmp(frozen->defaults->id, dst_id) != 0)
+				continue;
+
+			frozen_profile_addref(frozen);
+			da_push_back(matched_frozen, frozen);
+		}
+	}
+	registry_view_release(view);
+
+	// Whether the source is new has to be decided now, and the scene item
+	// has to be pending before it is added. The rest can wait for a batch.
+	bool is_new = (matched.num || matched_frozen.num) && source_is_new(dst);
+	bool defer = is_new && apply_queue_should_defer();
+
+	filter_stats_count(NULL, STATS_SEEN);
+	if (!is_new && (matched.num || matched_frozen.num))
+		encountered_sources_add(dst);
+	for (size_t i = 0; i < matched.num; i++) {
+		obs_source_t *filter = matched.array[i];
+		struct source_defaults *src = obs_obj_get_data(filter);
+		filter_stats_count(&src->stats, STATS_MATCHED);
+		if (!is_new) {
+			filter_stats_count(&src->stats, STATS_ENCOUNTERED);
+		} else {
+			// all of this creation sees the same settings
+			struct defaults_config *config = config_get(src);
+			if (any_true(config->sceneitem_options,
+				     OBS_COUNTOF(config->sceneitem_options)))
+				hub_set_pending(src, NULL, dst);
+			if (defer)
+				queue_profile(filter, NULL, dst);
+			else
+				source_defaults_apply(src, config, dst);
+			config_release(config);
+		}
+		obs_source_release(filter);
+	}
+	for (size_t i = 0; i < matched_frozen.num; i++) {
+		struct frozen_profile *frozen = &matched_frozen.array[i];
+		filter_stats_count(NULL, STATS_MATCHED);
+		if (!is_new) {
+			filter_stats_count(NULL, STATS_ENCOUNTERED);
+		} else {
+			if (frozen->defaults->sceneitem_snapshot &&
+			    any_true(frozen->config->sceneitem_options,
+				     OBS_COUNTOF(frozen->config
+							 ->sceneitem_options)))
+				hub_set_pending(NULL, frozen, dst);
+			if (defer)
+				queue_profile(NULL, frozen, dst);
+			else
+				frozen_defaults_apply(frozen, dst);
+		}
+		frozen_profile_release(frozen);
+	}
+	if (matched.num || matched_frozen.num)
+		latency_stats_record(&creation_latency,
+				     os_gettime_ns() - start);
+	da_free(matched);
+	da_free(matched_frozen);
+}
+
+static void source_created_cb(void *data, calldata_t *cd)
+{
+	UNUSED_PARAMETER(data);
+	obs_source_t *dst = (obs_source_t *)calldata_ptr(cd, "source");
+	profile_start(source_created_name);
+	if (!event_trace_enabled()) {
+		handle_source_created(dst);
+	} else {
+		uint64_t start = os_gettime_ns();
+		handle_source_created(dst);
+		event_trace_record(TRACE_SOURCE_CREATE, dst, NULL, start);
+	}
+	profile_end(source_created_name);
+}
+
+/* Existing sources keep their filters, only the missing ones are added */
+static void copy_missing_filters(struct source_snapshot *snapshot,
+				 obs_source_t *dst)
+{
+	for (size_t i = 0; i < snapshot->filters.num; i++) {
+		struct filter_template *tmpl = &snapshot->filters.array[i];
+		obs_source_t *filter =
+			obs_source_get_filter_by_name(dst, tmpl->name);
+		if (!filter)
+			obs_source_release(filter_template_attach(tmpl, dst));
+		obs_source_release(filter);
+	}
+}
+
+/**
+ * Runs in the chunks of an existing_sources job, for the categories ticked
+ * under Existing Sources. Settings that only make sense for a new source
+ * (the name prefix, Show/Hide and its transitions) are left alone.
+ */
+static void apply_existing(obs_source_t *filter, obs_source_t *dst,
+			   obs_sceneitem_t *const *items, size_t num_items)
+{
+	struct source_defaults *src = obs_obj_get_data(filter);
+	struct defaults_config *config = config_get(src);
+	obs_source_t *parent_source =
+		obs_weak_source_get_source(config->parent_source_weak);
+	if (!parent_source) {
+		config_release(config);
+		return;
+	}
+
+	struct source_snapshot *snapshot =
+		get_source_snapshot(src, parent_source);
+	if (config->existing_options[EXISTING_PROPERTIES])
+		copy_properties(snapshot, dst);
+	if (config->existing_options[EXISTING_FILTERS])
+		copy_missing_filters(snapshot, dst);
+	if (config->existing_options[EXISTING_AUDIO])
+		copy_audio(config, snapshot,
+			   obs_source_get_monitoring_type(parent_source), dst);
+	source_snapshot_release(snapshot);
+
+	if (num_items && config->existing_options[EXISTING_TRANSFORM]) {
+		struct sceneitem_snapshot *item_snapshot =
+			get_sceneitem_snapshot(src, parent_source);
+		for (size_t i = 0; item_snapshot->item && i < num_items; i++) {
+			// skip items that were removed since the job started
+			if (obs_sceneitem_get_scene(items[i]))
+				copy_transform(item_snapshot, items[i]);
+		}
+		sceneitem_snapshot_release(item_snapshot);
+	}
+
+	obs_source_release(parent_source);
+	config_release(config);
+}
+
+struct existing_selection {
+	obs_source_t *parent_source;
+	const char *parent_id;
+	struct rule_matcher *matcher; // NULL if the filter has no rules
+	const char *scene_name;       // of the scene rule, or NULL
+	obs_scene_t *scene;
+};
+
+static void find_defaults_filter(obs_source_t *parent, obs_source_t *child,
+				 void *param)
+{
+	UNUSED_PARAMETER(parent);
+	const char *id = obs_source_get_unversioned_id(child);
+	if (strcmp(id, source_defaults_video_info.id) == 0 ||
+	    strcmp(id, source_defaults_audio_info.id) == 0)
+		*(bool *)param = true;
+}
+
+/**
+ * Other default sources of the same type are never overwritten. The current
+ * scene says nothing about a source that already exists, so a scene rule
+ * matches the sources that are in that scene instead.
+ */
+static bool select_existing(void *param, obs_source_t *source)
+{
+	struct existing_selection *selection = param;
+	if (source == selection->parent_source ||
+	    obs_source_get_type(source) != OBS_SOURCE_TYPE_INPUT ||
+	    strcmp(obs_source_get_id(source), selection->parent_id) != 0)
+		return false;
+
+	bool has_defaults = false;
+	obs_source_enum_filters(source, find_defaults_filter, &has_defaults);
+	if (has_defaults)
+		return false;
+
+	if (!selection->matcher)
+		return true;
+
+	const char *name = obs_source_get_name(source);
+	const char *scene = NULL;
+	if (selection->scene && obs_scene_find_source(selection->scene, name))
+		scene = selection->scene_name;
+	return match_profile(selection->matcher, source, scene) == 0;
+}
+
+static bool apply_existing_clicked(obs_properties_t *props,
+				   obs_property_t *property, void *data)
+{
+	UNUSED_PARAMETER(props);
+	UNUSED_PARAMETER(property);
+	struct source_defaults *src = data;
+	struct defaults_config *config = config_get(src);
+	obs_source_t *parent_source =
+		obs_weak_source_get_source(config->parent_source_weak);
+	if (parent_source) {
+		struct existing_selection selection = {
+			.parent_source = parent_source,
+			.parent_id = obs_source_get_id(parent_source),
+		};
+		const struct profile_rules *rules = &config->rules;
+		if (profile_rules_specificity(rules))
+			selection.matcher = rule_matcher_create(&rules, 1);
+		if (rules->scene) {
+			selection.scene_name = rules->scene;
+			selection.scene = scene_catalog_get(rules->scene);
+		}
+
+		bool with_items =
+			config->existing_options[EXISTING_TRANSFORM] &&
+			config->parent_scene_weak;
+		if (!existing_sources_start(src->source, select_existing,
+					    &selection, with_items))
+			blog(LOG_INFO,
+			     "Defaults are already being applied to existing"
+			     " sources.");
+
+		rule_matcher_destroy(selection.matcher);
+		obs_scene_release(selection.scene);
+		obs_source_release(parent_source);
+	}
+	config_release(config);
+	return false;
+}
+
+/* Frozen defaults are kept by the name of the source they came from */
+static bool freeze_clicked(obs_properties_t *props, obs_property_t *property,
+			   void *data)
+{
+	UNUSED_PARAMETER(props);
+	UNUSED_PARAMETER(property);
+	struct source_defaults *src = data;
+	struct defaults_config *config = config_get(src);
+	obs_source_t *parent_source =
+		obs_weak_source_get_source(config->parent_source_weak);
+	if (parent_source) {
+		struct source_snapshot *snapshot =
+			get_source_snapshot(src, parent_source);
+		struct sceneitem_snapshot *item_snapshot =
+			config->parent_scene_weak
+				? get_sceneitem_snapshot(src, parent_source)
+				: NULL;
+		obs_data_t *settings = obs_source_get_settings(src->source);
+
+		frozen_store_put(frozen_defaults_create(
+			parent_source, settings, snapshot,
+			item_snapshot && item_snapshot->item ? item_snapshot
+							     : NULL));
+		blog(LOG_INFO,
+		     "Froze the defaults of '%s', the source can be deleted now.",
+		     obs_source_get_name(parent_source));
+
+		obs_data_release(settings);
+		sceneitem_snapshot_release(item_snapshot);
+		source_snapshot_release(snapshot);
+		obs_source_release(parent_source);
+	}
+	config_release(config);
+	return false;
+}
+
+static bool unfreeze_clicked(obs_properties_t *props,
+			     obs_property_t *property, void *data)
+{
+	UNUSED_PARAMETER(props);
+	UNUSED_PARAMETER(property);
+	struct source_defaults *src = data;
+	obs_source_t *parent_source = obs_filter_get_parent(src->source);
+	if (parent_source &&
+	    frozen_store_remove(obs_source_get_name(parent_source)))
+		blog(LOG_INFO, "Removed the frozen defaults of '%s'",
+		     obs_source_get_name(parent_source));
+	return false;
+}
+
+static void get_apply_progress_proc(void *data, calldata_t *cd)
 {
 	struct source_defaults *src = data;
+	size_t done = 0;
+	size_t total = 0;
+	bool running = existing_sources_progress(src->source, &done, &total);
+	calldata_set_bool(cd, "running", running);
+	calldata_set_int(cd, "done", (long long)done);
+	calldata_set_int(cd, "total", (long long)total);
+}
 
+/* Everything but the parent scene, which frozen defaults don't have */
+static void config_parse(struct defaults_config *config, obs_data_t *settings)
+{
 	for (size_t i = 0; i < OBS_COUNTOF(option_keys); i++) {
-		src->options[i] = obs_data_get_bool(settings, option_keys[i]);
+		config->options[i] =
+			obs_data_get_bool(settings, option_keys[i]);
 	}
 	for (size_t i = 0; i < OBS_COUNTOF(sceneitem_option_keys); i++) {
-		src->sceneitem_options[i] =
+		config->sceneitem_options[i] =
 			obs_data_get_bool(settings, sceneitem_option_keys[i]);
 	}
+	for (size_t i = 0; i < OBS_COUNTOF(existing_option_keys); i++) {
+		config->existing_options[i] =
+			obs_data_get_bool(settings, existing_option_keys[i]);
+	}
+	config->defer_expensive_filters =
+		obs_data_get_bool(settings, S_DEFER_EXPENSIVE_FILTERS);
+	config->share_transitions =
+		obs_data_get_bool(settings, S_SHARE_TRANSITIONS);
+	config->keep_inactive = obs_data_get_bool(settings, S_KEEP_INACTIVE);
+
+	profile_rules_free(&config->rules);
+	profile_rules_parse(
+		&config->rules,
+		obs_data_get_string(settings, S_MATCH_EXTENSIONS),
+		obs_data_get_string(settings, S_MATCH_NAME),
+		obs_data_get_string(settings, S_MATCH_SCENE),
+		(enum rule_audio)obs_data_get_int(settings, S_MATCH_AUDIO));
+
+	/* Source Name Settings */
+	config->apply_name_settings =
+		obs_data_get_bool(settings, S_NAME_SETTINGS);
+	bfree(config->prefix);
+	config->prefix = bstrdup(obs_data_get_string(settings, S_PREFIX));
+	config->prefix_if_not_yet_applied =
+		obs_data_get_bool(settings, S_PREFIX_NOT_YET_APPLIED);
+}
+
+static void source_defaults_update(void *data, obs_data_t *settings)
+{
+	struct source_defaults *src = data;
+	struct defaults_config *config = config_edit_begin(src);
+
+	struct profile_rules old_rules;
+	profile_rules_copy(&old_rules, &config->rules);
+	config_parse(config, settings);
+	bool rules_changed = !profile_rules_equal(&old_rules, &config->rules);
+	profile_rules_free(&old_rules);
+
 	const char *new_name = obs_data_get_string(settings, S_PARENT_SCENE);
-	bool parent_scene_changed = strcmp(new_name, src->parent_scene_name) !=
-				    0;
-	bfree(src->parent_scene_name);
-	src->parent_scene_name = bstrdup(new_name);
-	if (loaded && parent_scene_changed) {
-		obs_source_t *old_scene_source =
-			obs_weak_source_get_source(src->parent_scene_weak);
-		if (old_scene_source) {
-			obs_scene_t *old_scene =
-				obs_scene_from_source(old_scene_source);
-			stop_monitoring_parent_scene(src, old_scene);
-			obs_source_release(old_scene_source);
-		}
+	bool parent_scene_changed =
+		strcmp(new_name, config->parent_scene_name) != 0;
+	bfree(config->parent_scene_name);
+	config->parent_scene_name = bstrdup(new_name);
 
-		obs_scene_t *parent_scene =
-			obs_get_scene_by_name(src->parent_scene_name);
-		obs_weak_source_release(src->parent_scene_weak);
-		if (parent_scene) {
-			src->parent_scene_weak = obs_source_get_weak_source(
+	obs_source_t *old_scene_source = NULL;
+	obs_scene_t *parent_scene = NULL;
+	if (loaded && parent_scene_changed) {
+		old_scene_source =
+			obs_weak_source_get_source(config->parent_scene_weak);
+		parent_scene = scene_catalog_get(config->parent_scene_name);
+		obs_weak_source_release(config->parent_scene_weak);
+		config->parent_scene_weak = NULL;
+		if (parent_scene)
+			config->parent_scene_weak = obs_source_get_weak_source(
 				obs_scene_get_source(parent_scene));
-			obs_scene_release(parent_scene);
-			start_monitoring_parent_scene(src, parent_scene);
-		}
 	}
+	config_edit_end(src, config);
 
-	/* Source Name Settings */
-	src->apply_name_settings = obs_data_get_bool(settings, S_NAME_SETTINGS);
-	bfree(src->prefix);
-	src->prefix = bstrdup(obs_data_get_string(settings, S_PREFIX));
-	src->prefix_if_not_yet_applied =
-		obs_data_get_bool(settings, S_PREFIX_NOT_YET_APPLIED);
+	if (rules_changed)
+		registry_rules_changed(src);
+
+	if (old_scene_source) {
+		stop_monitoring_parent_scene(
+			src, obs_scene_from_source(old_scene_source));
+		obs_source_release(old_scene_source);
+	}
+	if (parent_scene) {
+		start_monitoring_parent_scene(src, parent_scene);
+		obs_scene_release(parent_scene);
+	}
+	if (loaded) {
+		config = config_get(src);
+		set_template_inactive(src, config,
+				      obs_filter_get_parent(src->source),
+				      config->keep_inactive);
+		config_release(config);
+	}
 }
 
 static void source_defaults_save(void *data, obs_data_t *settings)
 {
 	struct source_defaults *src = data;
-	obs_data_set_string(settings, S_PARENT_SCENE, src->parent_scene_name);
+	struct defaults_config *config = config_get(src);
+	obs_data_set_string(settings, S_PARENT_SCENE,
+			    config->parent_scene_name);
+	config_release(config);
 }
 
 static const char *source_defaults_get_name(void *unused)
@@ -674,24 +2431,19 @@ static obs_properties_t *source_defaults_properties(void *data)
 	struct source_defaults *src = data;
 	obs_properties_t *props = obs_properties_create();
 	obs_source_t *parent_source = obs_filter_get_parent(src->source);
-	obs_weak_source_release(src->parent_source_weak);
-	src->parent_source_weak = obs_source_get_weak_source(parent_source);
+	config_set_parent_source(src, parent_source);
 	if (obs_source_get_output_flags(parent_source) & OBS_SOURCE_COMPOSITE) {
 		obs_properties_add_text(
 			props, "description",
 			"This filter can not be applied on scenes and groups",
 			OBS_TEXT_INFO);
-		signal_handler_t *sh = obs_get_signal_handler();
-		signal_handler_disconnect(sh, "source_create",
-					  source_created_cb, src);
-		sh = obs_source_get_signal_handler(src->source);
-		signal_handler_disconnect(sh, "enable", source_defaults_enable,
-					  src);
-		obs_enum_scenes(all_scenes_item_add_disconnect, src);
+		source_defaults_detach(src);
 		return props;
 	}
 	obs_properties_t *sceneitem_settings_group = obs_properties_create();
 	obs_properties_t *name_settings_group = obs_properties_create();
+	obs_properties_t *rules_group = obs_properties_create();
+	obs_properties_t *existing_settings_group = obs_properties_create();
 
 	obs_properties_add_text(
 		props, "description",
@@ -702,6 +2454,14 @@ static obs_properties_t *source_defaults_properties(void *data)
 		obs_properties_add_bool(props, option_keys[i],
 					option_labels[i]);
 	}
+	obs_property_t *defer_filters = obs_properties_add_bool(
+		props, S_DEFER_EXPENSIVE_FILTERS, T_DEFER_EXPENSIVE_FILTERS);
+	obs_property_set_long_description(defer_filters,
+					  T_DEFER_EXPENSIVE_FILTERS_LONG_DESC);
+	obs_property_t *keep_inactive = obs_properties_add_bool(
+		props, S_KEEP_INACTIVE, T_KEEP_INACTIVE);
+	obs_property_set_long_description(keep_inactive,
+					  T_KEEP_INACTIVE_LONG_DESC);
 
 	if (obs_source_get_output_flags(parent_source) & OBS_SOURCE_AUDIO) {
 		for (size_t i = 2; i < OBS_COUNTOF(option_keys); i++) {
@@ -726,6 +2486,11 @@ static obs_properties_t *source_defaults_properties(void *data)
 					sceneitem_option_keys[i],
 					sceneitem_option_labels[i]);
 	}
+	obs_property_t *share_transitions = obs_properties_add_bool(
+		sceneitem_settings_group, S_SHARE_TRANSITIONS,
+		T_SHARE_TRANSITIONS);
+	obs_property_set_long_description(share_transitions,
+					  T_SHARE_TRANSITIONS_LONG_DESC);
 
 	/* Source Name Prefix */
 	obs_properties_add_group(props, S_NAME_SETTINGS, T_NAME_SETTINGS,
@@ -734,6 +2499,58 @@ static obs_properties_t *source_defaults_properties(void *data)
 				OBS_TEXT_DEFAULT);
 	obs_properties_add_bool(name_settings_group, S_PREFIX_NOT_YET_APPLIED,
 				T_PREFIX_NOT_YET_APPLIED);
+
+	/* Profile Rules */
+	obs_properties_add_group(props, S_PROFILE_RULES, T_PROFILE_RULES,
+				 OBS_GROUP_NORMAL, rules_group);
+	obs_properties_add_text(rules_group, "rules_description",
+				T_PROFILE_RULES_DESC, OBS_TEXT_INFO);
+	obs_property_t *extensions = obs_properties_add_text(
+		rules_group, S_MATCH_EXTENSIONS, T_MATCH_EXTENSIONS,
+		OBS_TEXT_DEFAULT);
+	obs_property_set_long_description(extensions,
+					  T_MATCH_EXTENSIONS_LONG_DESC);
+	obs_property_t *name_pattern = obs_properties_add_text(
+		rules_group, S_MATCH_NAME, T_MATCH_NAME, OBS_TEXT_DEFAULT);
+	obs_property_set_long_description(name_pattern,
+					  T_MATCH_NAME_LONG_DESC);
+	obs_property_t *target_scene_list = obs_properties_add_list(
+		rules_group, S_MATCH_SCENE, T_MATCH_SCENE, OBS_COMBO_TYPE_LIST,
+		OBS_COMBO_FORMAT_STRING);
+	obs_property_set_long_description(target_scene_list,
+					  T_MATCH_SCENE_LONG_DESC);
+	obs_property_list_add_string(target_scene_list, "--any scene--", "");
+	fill_scene_list(target_scene_list);
+	obs_property_t *audio = obs_properties_add_list(
+		rules_group, S_MATCH_AUDIO, T_MATCH_AUDIO, OBS_COMBO_TYPE_LIST,
+		OBS_COMBO_FORMAT_INT);
+	obs_property_list_add_int(audio, "Any", RULE_AUDIO_ANY);
+	obs_property_list_add_int(audio, "With audio", RULE_AUDIO_WITH);
+	obs_property_list_add_int(audio, "Without audio", RULE_AUDIO_WITHOUT);
+
+	/* Existing Sources */
+	obs_properties_add_group(props, S_EXISTING_SETTINGS,
+				 T_EXISTING_SETTINGS, OBS_GROUP_NORMAL,
+				 existing_settings_group);
+	bool has_audio = obs_source_get_output_flags(parent_source) &
+			 OBS_SOURCE_AUDIO;
+	for (size_t i = 0; i < OBS_COUNTOF(existing_option_keys); i++) {
+		if (i == EXISTING_AUDIO && !has_audio)
+			continue;
+		obs_properties_add_bool(existing_settings_group,
+					existing_option_keys[i],
+					existing_option_labels[i]);
+	}
+	obs_property_t *apply_existing_button = obs_properties_add_button2(
+		existing_settings_group, S_APPLY_EXISTING, T_APPLY_EXISTING,
+		apply_existing_clicked, src);
+	obs_property_set_long_description(apply_existing_button,
+					  T_APPLY_EXISTING_LONG_DESC);
+	obs_property_t *freeze_button = obs_properties_add_button2(
+		props, S_FREEZE, T_FREEZE, freeze_clicked, src);
+	obs_property_set_long_description(freeze_button, T_FREEZE_LONG_DESC);
+	obs_properties_add_button2(props, S_UNFREEZE, T_UNFREEZE,
+				   unfreeze_clicked, src);
 	return props;
 }
 
@@ -746,20 +2563,21 @@ static void source_defaults_get_defaults(obs_data_t *settings)
 		obs_data_set_default_bool(settings, sceneitem_option_keys[i],
 					  true);
 	}
+	// replacing the properties of existing sources loses e.g. their files
+	for (size_t i = 0; i < OBS_COUNTOF(existing_option_keys); i++) {
+		obs_data_set_default_bool(settings, existing_option_keys[i],
+					  i != EXISTING_PROPERTIES);
+	}
 	obs_data_set_default_bool(settings, S_NAME_SETTINGS, true);
 	obs_data_set_default_bool(settings, S_PREFIX_NOT_YET_APPLIED, true);
 }
 
 static void _source_defaults_enable(struct source_defaults *src, bool enabled)
 {
-	signal_handler_t *sh = obs_get_signal_handler();
-	if (enabled) {
-		signal_handler_connect(sh, "source_create", source_created_cb,
-				       src);
-	} else {
-		signal_handler_disconnect(sh, "source_create",
-					  source_created_cb, src);
-	}
+	if (enabled)
+		registry_add(src);
+	else
+		registry_remove(src);
 }
 
 static void source_defaults_enable(void *data, calldata_t *cd)
@@ -773,23 +2591,43 @@ static void source_defaults_enable(void *data, calldata_t *cd)
 static void source_defaults_show(void *data)
 {
 	struct source_defaults *src = data;
-	signal_handler_t *sh = obs_get_signal_handler();
-	signal_handler_connect(sh, "source_create", source_created_cb, src);
+	_source_defaults_enable(src, true);
 }
 
 static void source_defaults_hide(void *data)
 {
 	struct source_defaults *src = data;
-	signal_handler_t *sh = obs_get_signal_handler();
-	signal_handler_disconnect(sh, "source_create", source_created_cb, src);
+	_source_defaults_enable(src, false);
 }
 
 static void *source_defaults_create(obs_data_t *settings, obs_source_t *source)
 {
 	struct source_defaults *src = bzalloc(sizeof(struct source_defaults));
 	src->source = source;
-	src->parent_scene_name = bstrdup("");
-	src->prefix = bstrdup("");
+
+	struct defaults_config *config = bzalloc(sizeof(*config));
+	config->refs = 1;
+	config->parent_scene_name = bstrdup("");
+	config->prefix = bstrdup("");
+	pthread_mutex_init(&src->config_mutex, NULL);
+	rcu_ptr_init(&src->config, config);
+
+	pthread_mutex_init(&src->snapshot_mutex, NULL);
+	if (obs_data_has_user_value(settings, TEMPLATE_VISIBLE_KEY)) {
+		src->template_hidden = true;
+		src->template_visible =
+			obs_data_get_bool(settings, TEMPLATE_VISIBLE_KEY);
+	}
+	rcu_ptr_init(&src->source_snapshot, NULL);
+	rcu_ptr_init(&src->sceneitem_snapshot, NULL);
+	transition_pool_init(&src->transitions);
+	filter_stats_init(&src->stats, source);
+
+	proc_handler_t *ph = obs_source_get_proc_handler(source);
+	proc_handler_add(
+		ph,
+		"void get_apply_progress(out bool running, out int done, out int total)",
+		get_apply_progress_proc, src);
 
 	source_defaults_update(src, settings);
 
@@ -799,34 +2637,199 @@ static void *source_defaults_create(obs_data_t *settings, obs_source_t *source)
 	if (!obs_source_is_hidden(src->source))
 		_source_defaults_enable(src, true);
 
-	if (loaded) {
-		obs_enum_scenes(all_scenes_item_add, src);
-	} else {
-		obs_frontend_add_event_callback(
-			source_defaults_frontend_event_cb, src);
+	if (!loaded) {
+		pthread_mutex_lock(&loading.mutex);
+		da_push_back(loading.filters, &src);
+		pthread_mutex_unlock(&loading.mutex);
 	}
 
 	return src;
 }
 
+/**
+ * Destroying the filter keeps the template hidden, removing it doesn't.
+ * The parent and its filters are still alive here, unlike in destroy when
+ * the filter goes away with its parent.
+ */
+static void source_defaults_filter_remove(void *data, obs_source_t *parent)
+{
+	struct source_defaults *src = data;
+	stop_monitoring_parent_source(src);
+
+	pthread_mutex_lock(&src->snapshot_mutex);
+	monitor_template_filters(src, rcu_ptr_current(&src->source_snapshot),
+				 false);
+	pthread_mutex_unlock(&src->snapshot_mutex);
+
+	if (!loaded)
+		return;
+
+	struct defaults_config *config = config_get(src);
+	set_template_inactive(src, config, parent, false);
+	config_release(config);
+}
+
 static void source_defaults_destroy(void *data)
 {
 	struct source_defaults *src = data;
-	obs_enum_scenes(all_scenes_item_add_disconnect, src);
 	signal_handler_t *sh = obs_source_get_signal_handler(src->source);
 	signal_handler_disconnect(sh, "enable", source_defaults_enable, src);
 	_source_defaults_enable(src, false);
-	obs_source_release(src->source);
-	obs_weak_source_release(src->parent_source_weak);
-	obs_weak_source_release(src->parent_scene_weak);
-	obs_weak_source_release(src->dst_source_weak);
-	bfree(src->parent_scene_name);
+	hub_remove_pending(src);
 
-	/* Source Name Settings */
-	bfree(src->prefix);
+	pthread_mutex_lock(&loading.mutex);
+	da_erase_item(loading.filters, &src);
+	pthread_mutex_unlock(&loading.mutex);
+
+	// nothing else can hold the filter anymore
+	struct defaults_config *config = rcu_ptr_current(&src->config);
+	stop_monitoring_parent_source(src);
+	obs_source_t *parent_scene_source =
+		obs_weak_source_get_source(config->parent_scene_weak);
+	if (parent_scene_source) {
+		stop_monitoring_parent_scene(
+			src, obs_scene_from_source(parent_scene_source));
+		obs_source_release(parent_scene_source);
+	}
+	struct source_snapshot *snapshot =
+		rcu_ptr_current(&src->source_snapshot);
+	monitor_template_filters(src, snapshot, false);
+	source_snapshot_release(snapshot);
+	sceneitem_snapshot_release(rcu_ptr_current(&src->sceneitem_snapshot));
+	pthread_mutex_destroy(&src->snapshot_mutex);
+	config_release(config);
+	pthread_mutex_destroy(&src->config_mutex);
+	transition_pool_free(&src->transitions);
+	filter_stats_free(&src->stats);
+	obs_source_release(src->source);
+	bfree(src->parent_type);
+	bfree(src->parent_id);
 	bfree(data);
 }
 
+void source_defaults_init(void)
+{
+	plugin_settings_init();
+
+	pthread_mutex_init(&registry.mutex, NULL);
+	hash_table_init(&registry.types, hash_table_hash_str,
+			hash_table_equal_str);
+	da_init(registry.unresolved);
+	rcu_ptr_init(&registry.view, NULL);
+	registry_publish_locked();
+
+	pthread_mutex_init(&hub.mutex, NULL);
+	hash_table_init(&hub.pending, hash_table_hash_ptr,
+			hash_table_equal_ptr);
+	obs_add_tick_callback(hub_tick, NULL);
+
+	pthread_mutex_init(&loading.mutex, NULL);
+	da_init(loading.filters);
+	pthread_mutex_init(&visibility_batch.mutex, NULL);
+	da_init(visibility_batch.pending);
+	os_atomic_set_bool(&visibility_batch.active, true);
+	rcu_ptr_init(&target_scene, NULL);
+
+	event_trace_init();
+	filter_stats_global_init();
+	scene_index_init();
+	scene_catalog_init();
+	apply_queue_init(apply_queued, release_queued);
+	deferred_filters_init();
+	existing_sources_init(apply_existing);
+	encountered_sources_init();
+	frozen_store_init(frozen_defaults_changed);
+	defaults_library_init();
+
+	signal_handler_t *sh = obs_get_signal_handler();
+	signal_handler_connect(sh, "source_create", source_created_cb, NULL);
+}
+
+void source_defaults_free(void)
+{
+	signal_handler_t *sh = obs_get_signal_handler();
+	signal_handler_disconnect(sh, "source_create", source_created_cb, NULL);
+	obs_enum_scenes(hub_disconnect_scene, NULL);
+	obs_remove_tick_callback(hub_tick, NULL);
+	latency_stats_log(&creation_latency);
+	latency_stats_log(&item_add_latency);
+	apply_queue_free();
+	deferred_filters_free();
+	existing_sources_free();
+	encountered_sources_free();
+	defaults_library_free();
+	frozen_store_free();
+	scene_index_free();
+	scene_catalog_free();
+	filter_stats_global_free();
+	event_trace_free();
+
+	size_t idx = 0;
+	struct defaults_type_entry *entry;
+	while (hash_table_next(&registry.types, &idx, NULL, (void **)&entry))
+		free_type_entry(entry);
+	hash_table_free(&registry.types);
+	da_free(registry.unresolved);
+	registry_view_release(rcu_ptr_current(&registry.view));
+	pthread_mutex_destroy(&registry.mutex);
+
+	idx = 0;
+	struct pending_dst *pending;
+	while (hash_table_next(&hub.pending, &idx, NULL, (void **)&pending))
+		free_pending_dst(pending);
+	hash_table_free(&hub.pending);
+	pthread_mutex_destroy(&hub.mutex);
+
+	da_free(loading.filters);
+	pthread_mutex_destroy(&loading.mutex);
+
+	os_atomic_set_bool(&visibility_batch.active, false);
+	for (size_t i = 0; i < visibility_batch.pending.num; i++)
+		free_deferred_visibility(&visibility_batch.pending.array[i]);
+	da_free(visibility_batch.pending);
+	pthread_mutex_destroy(&visibility_batch.mutex);
+	bfree(rcu_ptr_current(&target_scene));
+}
+
+void source_defaults_target_scene_changed(void)
+{
+	obs_source_t *scene = obs_frontend_preview_program_mode_active()
+				      ? obs_frontend_get_current_preview_scene()
+				      : obs_frontend_get_current_scene();
+	char *name = scene ? bstrdup(obs_source_get_name(scene)) : NULL;
+	obs_source_release(scene);
+	bfree(rcu_ptr_publish(&target_scene, name));
+}
+
+void source_defaults_collection_loaded(void)
+{
+	scene_catalog_refresh();
+
+	pthread_mutex_lock(&loading.mutex);
+	for (size_t i = 0; i < loading.filters.num; i++) {
+		struct source_defaults *src = loading.filters.array[i];
+		struct defaults_config *config = config_get(src);
+		obs_scene_t *scene =
+			scene_catalog_get(config->parent_scene_name);
+		config_release(config);
+		resolve_parent_scene(src, obs_scene_get_source(scene));
+		obs_scene_release(scene);
+
+		config = config_get(src);
+		set_template_inactive(src, config,
+				      obs_filter_get_parent(src->source),
+				      config->keep_inactive);
+		config_release(config);
+	}
+	da_resize(loading.filters, 0);
+	pthread_mutex_unlock(&loading.mutex);
+}
+
+void source_defaults_scene_list_changed(void)
+{
+	scene_catalog_refresh();
+}
+
 /* OBS doesn't allow creating a filter that will show up for both 
 	video and audio filters, so we define two. */
 
@@ -837,6 +2840,7 @@ struct obs_source_info source_defaults_video_info = {
 	.output_flags = OBS_SOURCE_VIDEO,
 	.create = source_defaults_create,
 	.destroy = source_defaults_destroy,
+	.filter_remove = source_defaults_filter_remove,
 	.update = source_defaults_update,
 	.save = source_defaults_save,
 	.get_name = source_defaults_get_name,
@@ -851,6 +2855,7 @@ struct obs_source_info source_defaults_audio_info = {
 	.output_flags = OBS_SOURCE_AUDIO,
 	.create = source_defaults_create,
 	.destroy = source_defaults_destroy,
+	.filter_remove = source_defaults_filter_remove,
 	.update = source_defaults_update,
 	.save = source_defaults_save,
 	.get_name = source_defaults_get_name,
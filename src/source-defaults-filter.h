@@ -0,0 +1,29 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+/* Plugin-wide state shared by all Source Defaults filters */
+extern void source_defaults_init(void);
+extern void source_defaults_free(void);
+/* Called once all sources of a scene collection have been loaded */
+extern void source_defaults_collection_loaded(void);
+/* Called when the scene that new sources are added to may have changed */
+extern void source_defaults_target_scene_changed(void);
+/* Called when scenes were added, removed or reordered in the frontend */
+extern void source_defaults_scene_list_changed(void);
@@ -0,0 +1,97 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <string.h>
+#include <obs-module.h>
+
+#include "transition-pool.h"
+
+static void shared_transition_changed(void *data, calldata_t *cd)
+{
+	UNUSED_PARAMETER(cd);
+	struct shared_transition *slot = data;
+	os_atomic_set_bool(&slot->stale, true);
+}
+
+static void monitor_source(struct shared_transition *slot,
+			   obs_source_t *source, bool monitor)
+{
+	signal_handler_t *sh = obs_source_get_signal_handler(source);
+	if (monitor)
+		signal_handler_connect(sh, "update", shared_transition_changed,
+				       slot);
+	else
+		signal_handler_disconnect(sh, "update",
+					  shared_transition_changed, slot);
+}
+
+static void clear_slot(struct shared_transition *slot)
+{
+	obs_source_t *tmpl = obs_weak_source_get_source(slot->template_weak);
+	if (tmpl) {
+		monitor_source(slot, tmpl, false);
+		obs_source_release(tmpl);
+	}
+	if (slot->instance)
+		monitor_source(slot, slot->instance, false);
+
+	obs_weak_source_release(slot->template_weak);
+	obs_source_release(slot->instance);
+	slot->template_weak = NULL;
+	slot->instance = NULL;
+	os_atomic_set_bool(&slot->stale, false);
+}
+
+void transition_pool_init(struct transition_pool *pool)
+{
+	memset(pool, 0, sizeof(*pool));
+	pthread_mutex_init(&pool->mutex, NULL);
+}
+
+void transition_pool_free(struct transition_pool *pool)
+{
+	for (size_t i = 0; i < OBS_COUNTOF(pool->slots); i++)
+		clear_slot(&pool->slots[i]);
+	pthread_mutex_destroy(&pool->mutex);
+}
+
+obs_source_t *transition_pool_get(struct transition_pool *pool,
+				  obs_source_t *tmpl, bool show)
+{
+	if (!tmpl)
+		return NULL;
+
+	struct shared_transition *slot = &pool->slots[show ? 1 : 0];
+
+	pthread_mutex_lock(&pool->mutex);
+	if (os_atomic_load_bool(&slot->stale) || !slot->instance ||
+	    !obs_weak_source_references_source(slot->template_weak, tmpl)) {
+		clear_slot(slot);
+		slot->instance = obs_source_duplicate(
+			tmpl, obs_source_get_name(tmpl), true);
+		if (slot->instance) {
+			slot->template_weak = obs_source_get_weak_source(tmpl);
+			monitor_source(slot, tmpl, true);
+			monitor_source(slot, slot->instance, true);
+		}
+	}
+	obs_source_t *instance =
+		slot->instance ? obs_source_get_ref(slot->instance) : NULL;
+	pthread_mutex_unlock(&pool->mutex);
+	return instance;
+}
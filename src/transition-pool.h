@@ -0,0 +1,53 @@
+/*
+Source Defaults
+Copyright (C) 2022 Ian Rodriguez ianlemuelr@gmail.com
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <obs.h>
+#include <util/threading.h>
+
+/**
+ * Shares one private show and one private hide transition between the
+ * scene items that get their transitions from the same default.
+ *
+ * An instance leaves the pool as soon as it (or the template it was copied
+ * from) is updated, so items added afterwards get a fresh copy. Items that
+ * already use an instance keep sharing it, so editing the transition of
+ * one of them changes it for all of them. A transition instance also only
+ * runs one transition at a time, so items sharing it should not be shown or
+ * hidden at the same moment. The frontend saves the transitions with each
+ * scene item, so items loaded from a saved collection have their own.
+ */
+
+struct shared_transition {
+	obs_weak_source_t *template_weak;
+	obs_source_t *instance;
+	volatile bool stale;
+};
+
+struct transition_pool {
+	pthread_mutex_t mutex;
+	struct shared_transition slots[2]; // hide, show
+};
+
+extern void transition_pool_init(struct transition_pool *pool);
+extern void transition_pool_free(struct transition_pool *pool);
+
+/* Returns a new reference to the shared copy of tmpl, NULL if tmpl is NULL */
+extern obs_source_t *transition_pool_get(struct transition_pool *pool,
+					 obs_source_t *tmpl, bool show);